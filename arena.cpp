@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arena.h"
+
+static const size_t BLOCK_SIZE = 64 * 1024;
+
+// every object is aligned like the most strictly aligned fundamental type
+static const size_t ALIGNMENT = sizeof (long double);
+
+static
+char *xmalloc (size_t size)
+{
+    char *p = (char *) malloc (size);
+	if (p == NULL) { fprintf (stderr, "out of memory\n"); exit (1); }
+	return p;
+}
+
+Arena::Arena ()
+{
+    _next = _end = NULL;
+	_allocated = 0;
+}
+
+Arena::~Arena ()
+{
+    for (size_t i = 0; i < _blocks.size (); i++)
+	    free (_blocks [i]);
+    for (size_t i = 0; i < _big.size (); i++)
+	    free (_big [i]);
+}
+
+char *Arena::newBlock (size_t size)
+{
+    char *block = xmalloc (size);
+	_blocks.push_back (block);
+	_end = block + size;
+	return block;
+}
+
+void *Arena::allocate (size_t size)
+{
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	_allocated += size;
+	
+	if (size > BLOCK_SIZE / 4) {
+	    _big.push_back (xmalloc (size));
+		return _big.back ();
+	}
+	if (_next == NULL || (size_t) (_end - _next) < size)
+	    _next = newBlock (BLOCK_SIZE);
+	
+	void *p = _next;
+	_next += size;
+	return p;
+}
+
+void Arena::reset ()
+{
+    for (size_t i = 0; i < _big.size (); i++)
+	    free (_big [i]);
+	_big.clear ();
+	_allocated = 0;
+	
+    if (_blocks.empty ())
+	    return;
+	for (size_t i = 1; i < _blocks.size (); i++)
+	    free (_blocks [i]);
+	_blocks.resize (1);
+	_next = _blocks [0];
+	_end = _next + BLOCK_SIZE;
+}
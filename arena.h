@@ -0,0 +1,36 @@
+#ifndef __ARENA_H
+#define __ARENA_H 1
+
+#include <stddef.h>
+#include <vector>
+
+/*  An Arena is a simple bump allocator.  Objects allocated in an arena are never freed
+    one by one:  reset() frees all of them at once.  The AST nodes of a compilation are
+    allocated in the arena of its CompilerContext (see ASTnode::operator new). 
+*/
+class Arena {
+public:
+    Arena ();
+	~Arena ();
+
+	void *allocate (size_t size);
+
+	// free everything allocated so far. The first block is kept so a reused arena stays "warm"
+	void reset ();
+	
+	size_t bytesAllocated () { return _allocated; }
+
+private:
+    Arena (const Arena &);  // not copyable
+	Arena &operator= (const Arena &);
+
+	char *newBlock (size_t size);
+
+    std::vector<char *> _blocks; // blocks of BLOCK_SIZE bytes. new objects are allocated in the last one
+	std::vector<char *> _big;    // big objects get a block of their own
+	char *_next;  // next free byte in the last block
+	char *_end;   // end of the last block
+	size_t _allocated; // number of bytes handed out since the last reset ()
+};
+
+#endif // not defined __ARENA_H
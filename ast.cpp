@@ -1,24 +1,49 @@
 #include "symtab.h"
 #include "ast.h"
+#include "context.h"
 
-IdNode::IdNode (char *name, int line) 
+void *ASTnode::operator new (size_t size)
+{
+    return CompilerContext::current ()->arena.allocate (size);
+}
+
+void countNode (NodeKind kind)
+{
+    CompilerContext::current ()->stats.nodes [kind]++;
+}
+
+IdNode::IdNode (const char *name, int line) 
+{
+    PhaseTimer timer (CompilerContext::current ()->stats, PHASE_SEMANTIC);
+	countNode (NODE_ID);
+    _type = lookup (name, line);
+	_name = name; 
+}
+
+IdNode::IdNode (const char *name, myType type)
+{
+	countNode (NODE_ID);
+    _type = type;
+	_name = name;
+}
+
+myType IdNode::lookup (const char *name, int line)
 {
     myType t = getSymbol (name);
 	if (t == UNKNOWN) { 
 	    errorMsg ("line %d: variable %s is undefined\n", line, name);
 		t = _INT;
     }
-    _type = t;
-	strcpy (this->_name, name); 
-	_line = line;
+	return t;
 }
 
-BinaryOp::BinaryOp (enum op op, Exp *left, Exp *right, int line) 
+BinaryOp::BinaryOp (enum op op, Exp *left, Exp *right) 
 {
+    PhaseTimer timer (CompilerContext::current ()->stats, PHASE_SEMANTIC);
+	countNode (NODE_BINARYOP);
     this->_op = op; 
 	this->_left = left; 
 	this->_right = right;
-	_line = line;
 
 	if (left->_type != right->_type)
 		_type = _FLOAT;
@@ -32,10 +57,12 @@ AssignStmt::AssignStmt (IdNode *lhs, Exp *rhs, int line)
    _lhs = lhs; 
    _rhs = rhs; 
    _line = line; 
+   countNode (NODE_ASSIGN);
 }
 
 
 SwitchStmt::SwitchStmt (Exp *exp, Case *caselist, Stmt *default_stmt, int line) {
 	       _exp = exp; _caselist = caselist; _default_stmt = default_stmt; _line = line; 
+		   countNode (NODE_SWITCH);
 }
 
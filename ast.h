@@ -2,55 +2,89 @@
 #define __AST_H 1
 
 #include <string.h>
+#include <string>
+#include <vector>
 
 #include "gen.h"
+#include "stats.h"
+#include "flatast.h"
 
 /*  FALL_THROUGH may be used as an argument to BoolExp::genBoolExp().
     Labels  are represented as positive integers so FALL_THROUGH has negative value */
 const int FALL_THROUGH = -1;
 
+// count a new node in the stats of the current compilation (see stats.h)
+void countNode (NodeKind kind);
+
 // all nodes  in the AST (Abstract Syntax Tree) are of types derived from ASTnode 
+// Nodes are allocated in the arena of the current compilation (see context.h). They are
+// never deleted one by one: the whole tree is freed when the context starts its next compilation.
 class ASTnode {
-   
+public:
+    void *operator new (size_t size);
+	void operator delete (void *) {}
 };
 
 // expressions 
 
+/*  Expression trees can be very deep:  a + b + c + ... is a left spine with a node for each term,
+    and generated programs have expressions with hundreds of thousands of terms.  So no pass over
+	expressions recurses into the operands (it would overflow the native stack):  each pass walks
+	the tree with an explicit stack (see Exp::genExp (), BoolExp::genBoolExp () and fingerprint.cpp),
+	getting the operands of a node with operand (), and it does the work of one node at a time
+	(genNode (), fingerprintNode ()).  The depth of a tree is limited only by the heap.
+	A new pass over expressions should do the same */
+
 // this is an abstract class
 class Exp : public  ASTnode {
 public:
     // return value  is the temporary variable in which the result of the expression will be stored
 	//  For example, return value 17  means result will be stored in _t17
-    virtual int genExp () = 0; // every subclass should override this (or be abstract too)
+	// The code of the operands comes first (the tree is walked with a stack, see above)
+    int genExp ();
+
+	/*  generate the code of this node: the code of its operands was generated, operands [i] is
+	    the temporary of the result of operand i.  Returns the temporary of its result.  Nothing
+		is kept in the node:  a node can be an operand of many nodes (see hashcons.h) */
+    virtual int genNode (const int *operands) = 0; // every subclass should override this (or be abstract too)
+
+    /*  append a description of the expression to f: its kind, operators, constants, the names
+	    and types of its variables. No line numbers.  Two expressions with the same description
+		get the same code (see fingerprint.cpp) */
+	void fingerprint (std::string &f);
+
+	// append the description of this node alone (fingerprint () appends those of its operands after it)
+	virtual void fingerprintNode (std::string &f) = 0;
+
+	// operand i of this node (0 is the first one). NULL if it has no operand i
+	virtual Exp *operand (int i) { return NULL; }
     
-    Exp () { _result = -1; _type = UNKNOWN; }	
-    // Exp (int result, myType _type) : ASTnode () { this->_result = result; this->_type = _type; }
+    Exp () { _type = UNKNOWN; }	
 	
-    int _result;/* example: _result is 17 means result of expression will be in  _t17.
-                   _result is -1 means: not known yet (_result is set to a new temporary when
-				    code for the expression is generated) */
 	myType _type;
     
 };
 
 class BinaryOp : public Exp {
 public:
-    BinaryOp (enum op op, Exp *left, Exp *right, int line);
+    BinaryOp (enum op op, Exp *left, Exp *right);
 
-	int genExp (); // override
+	int genNode (const int *operands); // override
+	void fingerprintNode (std::string &f); // override
+	Exp *operand (int i) { return i == 0 ? _left : i == 1 ? _right : NULL; } // override
 
     enum op _op;
 	Exp *_left; // left operand
 	Exp *_right; // right operand
-	int _line;  // source line number of operator
 };
 
 class NumNode : public Exp {
 public:
-	int genExp (); // override
+	int genNode (const int *operands); // override
+	void fingerprintNode (std::string &f); // override
 	
-    NumNode (int ival) { _u.ival = ival; _type = _INT;}
-    NumNode (double fval) { _u.fval = fval; _type = _FLOAT;}
+    NumNode (int ival) { _u.ival = ival; _type = _INT; countNode (NODE_NUM); }
+    NumNode (double fval) { _u.fval = fval; _type = _FLOAT; countNode (NODE_NUM); }
 	
 	union {
 	    int ival;
@@ -60,26 +94,68 @@ public:
 
 class IdNode : public Exp {
 public: 
-     int genExp (); // override
+     int genNode (const int *operands); // override
+     void fingerprintNode (std::string &f); // override
+
+     IdNode (const char *name, int line);  // name is interned (see the scanner). line: for the error of an undefined variable
+     IdNode (const char *name, myType type);  // and its type known (see ExpFactory)
 
-     IdNode (char *name, int line);
+     // the type of variable name.  If it was not declared: an error (and it is taken as an int)
+     static myType lookup (const char *name, int line);
 			          
-     char _name [100];
-	 int _line;  // source line number
+     const char *_name;  // see internName () in symtab.h
+};
+
+// an expression in flat form (-flat-ast, see flatast.h):  the tree under _node in _tree
+class FlatExp : public Exp {
+public:
+     FlatExp (const FlatAST *tree, FlatNode node, myType type) { _tree = tree; _node = node; _type = type; }
+
+	 int genNode (const int *operands); // override
+	 void fingerprintNode (std::string &f); // override
+
+	 const FlatAST *_tree;
+	 FlatNode _node;
 };
 
 //  boolean expressions
-// this is an abstract class
 
+class BoolExp;
+
+/*  a job of the code generation of a boolean expression (see BoolExp::genBoolExp ()): generate
+    the code of exp (jumping to truelabel or falselabel), or if exp is NULL emit truelabel */
+struct BoolJob {
+    BoolJob (BoolExp *exp, int truelabel, int falselabel = FALL_THROUGH)
+	    { this->exp = exp; this->truelabel = truelabel; this->falselabel = falselabel; }
+	static BoolJob label (int label) { return BoolJob (NULL, label); }
+
+	BoolExp *exp;
+	int truelabel;
+	int falselabel;
+};
+
+// this is an abstract class
 class BoolExp : public  ASTnode {
 public:  //  some members  should be private ...
     /*  generate code for boolean expression. The code  should jump to
 	    truelabel or to falselabel depending on the value of the expression.
         truelabel may  be  FALL_THROUGH meaning  code should fall through to 
 		next instruction (rather than jump to a label)  when the expression is 
-		true. falselabel  may also be  FALL_TROUGH */		
-    virtual void genBoolExp (int truelabel, int falselabel) = 0; // every subclass should
-                                            // override this (or be abstract too)
+		true. falselabel  may also be  FALL_TROUGH.
+		The tree is walked with a stack of jobs (see above) */
+    void genBoolExp (int truelabel, int falselabel);
+
+	/*  generate the code of this node (see genBoolExp ()):  emit its own instructions and push on
+	    jobs the code of its operands and the labels that come after them. jobs is a stack: the job
+		pushed last is done first, so they are pushed in the reverse order of the code */
+    virtual void genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs) = 0; // every
+	                                        // subclass should override this (or be abstract too)
+
+	void fingerprint (std::string &f);  // see Exp::fingerprint ()
+	virtual void fingerprintNode (std::string &f) = 0;
+
+	// boolean operand i of this node (0 is the first one). NULL if it has no operand i
+	virtual BoolExp *operand (int i) { return NULL; }
 };
  
 // nodes for  simple boolean expressions having the form 
@@ -88,20 +164,24 @@ public:  //  some members  should be private ...
 // another example:   (a + 3) < (z * 5 + y).    
 class SimpleBoolExp : public BoolExp {
 public:
-    SimpleBoolExp (enum op op, Exp *left, Exp *right)
-  	     { this->_op = op; this->_left = left; this->_right = right;}
+    SimpleBoolExp (enum op op, Exp *left, Exp *right, int line)
+  	     { this->_op = op; this->_left = left; this->_right = right; _line = line; countNode (NODE_SIMPLEBOOLEXP); }
 
-    void genBoolExp (int truelabel, int falselabel); // override
+    void genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs); // override
+    void fingerprintNode (std::string &f); // override
 	
     enum op _op;
 	Exp *_left; // left operand
 	Exp *_right; // right operand
+	int _line;  // source line of the operator: the line of the code of the comparison and its operands
 };
 
 class Or : public BoolExp {
 public:
-     Or (BoolExp *left, BoolExp *right) { _left = left; _right = right; }
-	 void genBoolExp (int truelabel, int falselabel); // override
+     Or (BoolExp *left, BoolExp *right) { _left = left; _right = right; countNode (NODE_OR); }
+	 void genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs); // override
+	 void fingerprintNode (std::string &f); // override
+	 BoolExp *operand (int i) { return i == 0 ? _left : i == 1 ? _right : NULL; } // override
 	 
 	 BoolExp *_left; // left operand
 	 BoolExp *_right; // right operand
@@ -109,8 +189,10 @@ public:
 
 class And : public BoolExp {
 public:
-     And (BoolExp *left, BoolExp *right) { _left = left; _right = right; }
-	 void genBoolExp (int truelabel, int falselabel); // override
+     And (BoolExp *left, BoolExp *right) { _left = left; _right = right; countNode (NODE_AND); }
+	 void genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs); // override
+	 void fingerprintNode (std::string &f); // override
+	 BoolExp *operand (int i) { return i == 0 ? _left : i == 1 ? _right : NULL; } // override
 	 
 	 BoolExp *_left; // left operand
 	 BoolExp *_right; // right operand
@@ -119,21 +201,37 @@ public:
 
 class Not : public BoolExp {
 public:
-     Not (BoolExp *operand) { _operand = operand;}
-	 void genBoolExp (int truelabel, int falselabel); // override
+     Not (BoolExp *operand) { _operand = operand; countNode (NODE_NOT); }
+	 void genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs); // override
+	 void fingerprintNode (std::string &f); // override
+	 BoolExp *operand (int i) { return i == 0 ? _operand : NULL; } // override
 	 
 	 BoolExp *_operand; 
 };
 
 class Fand : public BoolExp {
 public:
-     Fand (BoolExp *left, BoolExp *right) { _left = left; _right = right; }
-	 void genBoolExp (int truelabel, int falselabel); // override
+     Fand (BoolExp *left, BoolExp *right) { _left = left; _right = right; countNode (NODE_FAND); }
+	 void genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs); // override
+	 void fingerprintNode (std::string &f); // override
+	 BoolExp *operand (int i) { return i == 0 ? _left : i == 1 ? _right : NULL; } // override
 	 
 	 BoolExp *_left; // left operand
 	 BoolExp *_right; // right operand
 };
 
+// a condition in flat form (-flat-ast, see flatast.h):  the tree under _node in _tree
+class FlatBoolExp : public BoolExp {
+public:
+     FlatBoolExp (const FlatAST *tree, FlatNode node) { _tree = tree; _node = node; }
+
+	 void genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs); // override
+	 void fingerprintNode (std::string &f); // override
+
+	 const FlatAST *_tree;
+	 FlatNode _node;
+};
+
 	 // statements
 
 // this is an abstract class
@@ -142,15 +240,17 @@ public:
    Stmt () {_next = NULL; } 
    
    virtual void genStmt () = 0; // every subclass should override this (or be abstract too)
+   virtual void fingerprint (std::string &f) = 0;  // see Exp::fingerprint (). _next is not included
 
    Stmt *_next;  // used to link together statements in the same block
 };
 
 class ReadStmt: public Stmt {
 public:
-      ReadStmt (IdNode *id, int line) : Stmt() { _id = id; _line = line;};
+      ReadStmt (IdNode *id, int line) : Stmt() { _id = id; _line = line; countNode (NODE_READ); };
 
       void genStmt (); // override	  
+      void fingerprint (std::string &f); // override
 
       IdNode *_id;  // note: IdNode is subclass of Exp but this IdNode is not really an expression
 	  int _line; // line in source code 
@@ -158,9 +258,10 @@ public:
 
 class WriteStmt: public Stmt {
 public:
-      WriteStmt (Exp *exp, int line) : Stmt() { _exp = exp; _line = line;};
+      WriteStmt (Exp *exp, int line) : Stmt() { _exp = exp; _line = line; countNode (NODE_WRITE); };
 
       void genStmt (); // override	  
+      void fingerprint (std::string &f); // override
 
       Exp *_exp;
 	  int _line; // line in source code 
@@ -171,6 +272,7 @@ public:
       AssignStmt (IdNode *lhs, Exp *rhs, int line);
 
       void genStmt (); // override	  
+      void fingerprint (std::string &f); // override
 
       IdNode *_lhs; // left hand side
 	  Exp *_rhs; // right hand side
@@ -181,8 +283,9 @@ class IfStmt : public Stmt {
 public:
      IfStmt (BoolExp *condition, Stmt *thenStmt, Stmt *elseStmt)
 	          : Stmt ()
-	          { this->_condition = condition; this->_thenStmt = thenStmt; this->_elseStmt = elseStmt; } 
+	          { this->_condition = condition; this->_thenStmt = thenStmt; this->_elseStmt = elseStmt; countNode (NODE_IF); } 
 	 void genStmt (); // override
+	 void fingerprint (std::string &f); // override
 	 
      BoolExp *_condition;
 	 Stmt *_thenStmt;
@@ -193,9 +296,10 @@ class WhileStmt: public Stmt {
 public: 
      WhileStmt (BoolExp *condition, Stmt *body)
 	          : Stmt ()
-	          { _condition = condition; _body = body; }
+	          { _condition = condition; _body = body; countNode (NODE_WHILE); }
 
 	 void genStmt (); // override			  
+	 void fingerprint (std::string &f); // override
 
      BoolExp *_condition;
 	 Stmt *_body;
@@ -205,9 +309,10 @@ class ForStmt: public Stmt {
 public: 
      ForStmt ( AssignStmt *init, BoolExp *condition, Stmt *body, AssignStmt *afterStep)
 	          : Stmt ()
-	          { _condition = condition; _body = body; _init = init; _afterStep = afterStep;}
+	          { _condition = condition; _body = body; _init = init; _afterStep = afterStep; countNode (NODE_FOR); }
 
 	 void genStmt (); // override			  
+	 void fingerprint (std::string &f); // override
 
      BoolExp *_condition;
 	 Stmt *_body;
@@ -218,17 +323,19 @@ public:
 //  a block contains a list of statements. For now -- no declarations in a block
 class Block: public Stmt {
 public:
-	 Block (Stmt *stmtlist) { _stmtlist = stmtlist; }
+	 Block (Stmt *stmtlist) { _stmtlist = stmtlist; countNode (NODE_BLOCK); }
 	 void genStmt (); // override
+	 void fingerprint (std::string &f); // override
 	 
      Stmt* _stmtlist; // pointer to the first statement. each statement points to the next stmt
 };
 
 class BreakStmt : public Stmt {
 public:
-     BreakStmt (int line) { _line = line; }
+     BreakStmt (int line) { _line = line; countNode (NODE_BREAK); }
 	 
 	 void genStmt(); // override
+	 void fingerprint (std::string &f); // override
 	 
      int _line;  // source line of switch token
 };
@@ -241,6 +348,7 @@ public:
 		  _hasBreak = hasBreak;
           _next = NULL;
           _label = -1;  // will be set when code is generated
+          countNode (NODE_CASE);
       }
 
 
@@ -256,6 +364,7 @@ public:
       SwitchStmt (Exp *exp, Case *caselist, Stmt *default_stmt, int line);
 	  		   
 	  void genStmt (); // override
+	  void fingerprint (std::string &f); // override
 	  
 	  Exp *_exp;
 	  Case *_caselist;
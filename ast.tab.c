@@ -1,2206 +1,2234 @@
-/* A Bison parser, made by GNU Bison 2.7.  */
-
-/* Bison implementation for Yacc-like parsers in C
-   
-      Copyright (C) 1984, 1989-1990, 2000-2012 Free Software Foundation, Inc.
-   
-   This program is free software: you can redistribute it and/or modify
-   it under the terms of the GNU General Public License as published by
-   the Free Software Foundation, either version 3 of the License, or
-   (at your option) any later version.
-   
-   This program is distributed in the hope that it will be useful,
-   but WITHOUT ANY WARRANTY; without even the implied warranty of
-   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-   GNU General Public License for more details.
-   
-   You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
-
-/* As a special exception, you may create a larger work that contains
-   part or all of the Bison parser skeleton and distribute that work
-   under terms of your choice, so long as that work isn't itself a
-   parser generator using the skeleton or a modified version thereof
-   as a parser skeleton.  Alternatively, if you modify or redistribute
-   the parser skeleton itself, you may (at your option) remove this
-   special exception, which will cause the skeleton and the resulting
-   Bison output files to be licensed under the GNU General Public
-   License without this special exception.
-   
-   This special exception was added by the Free Software Foundation in
-   version 2.2 of Bison.  */
-
-/* C LALR(1) parser skeleton written by Richard Stallman, by
-   simplifying the original so-called "semantic" parser.  */
-
-/* All symbols defined below should begin with yy or YY, to avoid
-   infringing on user name space.  This should be done even for local
-   variables, as they might otherwise be expanded by user macros.
-   There are some unavoidable exceptions within include files to
-   define necessary library symbols; they are noted "INFRINGES ON
-   USER NAME SPACE" below.  */
-
-/* Identify Bison output.  */
-#define YYBISON 1
-
-/* Bison version.  */
-#define YYBISON_VERSION "2.7"
-
-/* Skeleton name.  */
-#define YYSKELETON_NAME "yacc.c"
-
-/* Pure parsers.  */
-#define YYPURE 0
-
-/* Push parsers.  */
-#define YYPUSH 0
-
-/* Pull parsers.  */
-#define YYPULL 1
-
-
-
-
-/* Copy the first part of user declarations.  */
-
-/* Line 371 of yacc.c  */
-#line 68 "ast.tab.c"
-
-# ifndef YY_NULL
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULL nullptr
-#  else
-#   define YY_NULL 0
-#  endif
-# endif
+// A Bison parser, made by GNU Bison 3.8.2.
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 1
-#endif
+// Skeleton implementation for Bison LALR(1) parsers in C++
 
-/* In a future release of Bison, this section will be replaced
-   by #include "ast.tab.h".  */
-#ifndef YY_YY_AST_TAB_H_INCLUDED
-# define YY_YY_AST_TAB_H_INCLUDED
-/* Enabling traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-/* "%code requires" blocks.  */
-/* Line 387 of yacc.c  */
-#line 17 "ast.y"
-
-#include "ast.h"
-
-
-/* Line 387 of yacc.c  */
-#line 105 "ast.tab.c"
-
-/* Tokens.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     INT_NUM = 258,
-     FLOAT_NUM = 259,
-     ADDOP = 260,
-     MULOP = 261,
-     RELOP = 262,
-     POWER = 263,
-     ID = 264,
-     AUTO = 265,
-     READ = 266,
-     WRITE = 267,
-     IF = 268,
-     ELSE = 269,
-     WHILE = 270,
-     FOR = 271,
-     INT = 272,
-     FLOAT = 273,
-     OR = 274,
-     AND = 275,
-     NOT = 276,
-     FAND = 277,
-     SWITCH = 278,
-     CASE = 279,
-     DEFAULT = 280,
-     BREAK = 281
-   };
-#endif
+// Copyright (C) 2002-2015, 2018-2021 Free Software Foundation, Inc.
 
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
 
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-{
-/* Line 387 of yacc.c  */
-#line 22 "ast.y"
-
-   int ival;
-   // float numbers in the source program are stored as double
-   double fval;
-   enum op op;
-   char name[100];
-   
-   myType _type;
-   
-   //  pointers to AST nodes:
-   Stmt *stmt;
-   Block *block;
-   Stmt *stmtlist; // points to first Stmt in the list (NULL if list is empty)
-   ReadStmt *read_stmt;
-   AssignStmt *assign_stmt;
-   IfStmt *if_stmt;
-   WhileStmt *while_stmt;
-   SwitchStmt *switch_stmt;
-   Case *caselist; //points to first Case in the list
-   Case *mycase;
-   BreakStmt *break_stmt;
-   Exp  *exp;
-   BoolExp *boolexp;
-   bool hasBreak;
-   ForStmt *for_stmt;
-   WriteStmt *write_stmt;
-
-
-/* Line 387 of yacc.c  */
-#line 175 "ast.tab.c"
-} YYSTYPE;
-# define YYSTYPE_IS_TRIVIAL 1
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
-#endif
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
 
-#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE
-{
-  int first_line;
-  int first_column;
-  int last_line;
-  int last_column;
-} YYLTYPE;
-# define yyltype YYLTYPE /* obsolescent; will be withdrawn */
-# define YYLTYPE_IS_DECLARED 1
-# define YYLTYPE_IS_TRIVIAL 1
-#endif
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
-extern YYSTYPE yylval;
-extern YYLTYPE yylloc;
-#ifdef YYPARSE_PARAM
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void *YYPARSE_PARAM);
-#else
-int yyparse ();
-#endif
-#else /* ! YYPARSE_PARAM */
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void);
-#else
-int yyparse ();
-#endif
-#endif /* ! YYPARSE_PARAM */
+// As a special exception, you may create a larger work that contains
+// part or all of the Bison parser skeleton and distribute that work
+// under terms of your choice, so long as that work isn't itself a
+// parser generator using the skeleton or a modified version thereof
+// as a parser skeleton.  Alternatively, if you modify or redistribute
+// the parser skeleton itself, you may (at your option) remove this
+// special exception, which will cause the skeleton and the resulting
+// Bison output files to be licensed under the GNU General Public
+// License without this special exception.
 
-#endif /* !YY_YY_AST_TAB_H_INCLUDED  */
+// This special exception was added by the Free Software Foundation in
+// version 2.2 of Bison.
 
-/* Copy the second part of user declarations.  */
+// DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+// especially those whose name start with YY_ or yy_.  They are
+// private implementation details that can be changed or removed.
 
-/* Line 390 of yacc.c  */
-#line 216 "ast.tab.c"
-/* Unqualified %code blocks.  */
-/* Line 391 of yacc.c  */
-#line 1 "ast.y"
 
-#include <stdio.h>
-#include <string>
-#include <stdarg.h>
-#include "symtab.h"
 
-  /* yylex () and yyerror() need to be declared here */
-int yylex (void);
-void yyerror (std::string s);
 
-/* void emit (const char *format, ...);  */
 
-// number of errors 
-int errors;
+#include "ast.tab.h"
 
 
-/* Line 391 of yacc.c  */
-#line 237 "ast.tab.c"
+// Unqualified %code blocks.
+#line 1 "ast.y"
 
-#ifdef short
-# undef short
-#endif
+#include <stdio.h>
+#include <string>
+#include <stdarg.h>
+#include "symtab.h"
+#include "context.h"
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
-#endif
+  /* yylex () needs to be declared here (see ast.lex).  The value of the token is built in
+     *yylval (yylval->emplace<int> (...)): the type of its value is the one of the token below */
+int yylex (yy::Parser::value_type *yylval, yy::Parser::location_type *yylloc, void *scanner);
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#elif (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-typedef signed char yytype_int8;
-#else
-typedef short int yytype_int8;
-#endif
+// yylex () counted and timed (see stats.h). The parser calls this one
+static
+int countedLex (yy::Parser::value_type *yylval, yy::Parser::location_type *yylloc, void *scanner, CompilerContext *ctx)
+{
+    PhaseTimer timer (ctx->stats, PHASE_LEX);
+	ctx->stats.tokens++;
+	return yylex (yylval, yylloc, scanner);
+}
+#define yylex(yylval, yylloc, scanner) countedLex (yylval, yylloc, scanner, ctx)
+int yyget_lineno (void *scanner);  // defined by flex
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
-#else
-typedef unsigned short int yytype_uint16;
-#endif
+/* void emit (const char *format, ...);  */
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
-#else
-typedef short int yytype_int16;
-#endif
+// -flat-ast (see the rules of expressions)
+#define FLAT (ctx->options.flatAST)
 
-#ifndef YYSIZE_T
-# ifdef __SIZE_TYPE__
-#  define YYSIZE_T __SIZE_TYPE__
-# elif defined size_t
-#  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
-#  define YYSIZE_T size_t
-# else
-#  define YYSIZE_T unsigned int
-# endif
-#endif
+// add stmt at the end of list
+static
+StmtList append (StmtList list, Stmt *stmt)
+{
+    if (list.first == NULL)
+	    list.first = stmt;
+	else
+	    list.last->_next = stmt;
+	list.last = stmt;
+	return list;
+}
+
+#line 86 "ast.tab.c"
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
 #  if ENABLE_NLS
-#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
-#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#   include <libintl.h> // FIXME: INFRINGES ON USER NAME SPACE.
+#   define YY_(msgid) dgettext ("bison-runtime", msgid)
 #  endif
 # endif
 # ifndef YY_
-#  define YY_(Msgid) Msgid
+#  define YY_(msgid) msgid
 # endif
 #endif
 
-/* Suppress unused-variable warnings by "using" E.  */
-#if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
-#else
-# define YYUSE(E) /* empty */
-#endif
-
-/* Identity function, used to suppress warnings about constant conditions.  */
-#ifndef lint
-# define YYID(N) (N)
-#else
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static int
-YYID (int yyi)
-#else
-static int
-YYID (yyi)
-    int yyi;
-#endif
-{
-  return yyi;
-}
-#endif
-
-#if ! defined yyoverflow || YYERROR_VERBOSE
-
-/* The parser invokes alloca or malloc; define the necessary symbols.  */
-
-# ifdef YYSTACK_USE_ALLOCA
-#  if YYSTACK_USE_ALLOCA
-#   ifdef __GNUC__
-#    define YYSTACK_ALLOC __builtin_alloca
-#   elif defined __BUILTIN_VA_ARG_INCR
-#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
-#   elif defined _AIX
-#    define YYSTACK_ALLOC __alloca
-#   elif defined _MSC_VER
-#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
-#    define alloca _alloca
-#   else
-#    define YYSTACK_ALLOC alloca
-#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
-#     ifndef EXIT_SUCCESS
-#      define EXIT_SUCCESS 0
-#     endif
-#    endif
-#   endif
-#  endif
-# endif
 
-# ifdef YYSTACK_ALLOC
-   /* Pacify GCC's `empty if-body' warning.  */
-#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (YYID (0))
-#  ifndef YYSTACK_ALLOC_MAXIMUM
-    /* The OS might guarantee only one guard page at the bottom of the stack,
-       and a page size can be as small as 4096 bytes.  So we cannot safely
-       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
-       to allow for a few compiler-allocated temporary stack slots.  */
-#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
-#  endif
+// Whether we are compiled with exception support.
+#ifndef YY_EXCEPTIONS
+# if defined __GNUC__ && !defined __EXCEPTIONS
+#  define YY_EXCEPTIONS 0
 # else
-#  define YYSTACK_ALLOC YYMALLOC
-#  define YYSTACK_FREE YYFREE
-#  ifndef YYSTACK_ALLOC_MAXIMUM
-#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
-#  endif
-#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
-       && ! ((defined YYMALLOC || defined malloc) \
-	     && (defined YYFREE || defined free)))
-#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#   ifndef EXIT_SUCCESS
-#    define EXIT_SUCCESS 0
-#   endif
-#  endif
-#  ifndef YYMALLOC
-#   define YYMALLOC malloc
-#   if ! defined malloc && ! defined EXIT_SUCCESS && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
-#   endif
-#  endif
-#  ifndef YYFREE
-#   define YYFREE free
-#   if ! defined free && ! defined EXIT_SUCCESS && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-void free (void *); /* INFRINGES ON USER NAME SPACE */
-#   endif
-#  endif
-# endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
-
-#if (! defined yyoverflow \
-     && (! defined __cplusplus \
-	 || (defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL \
-	     && defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
-
-/* A type that is properly aligned for any stack member.  */
-union yyalloc
-{
-  yytype_int16 yyss_alloc;
-  YYSTYPE yyvs_alloc;
-  YYLTYPE yyls_alloc;
-};
-
-/* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
-
-/* The size of an array large to enough to hold all stacks, each with
-   N elements.  */
-# define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE) + sizeof (YYLTYPE)) \
-      + 2 * YYSTACK_GAP_MAXIMUM)
-
-# define YYCOPY_NEEDED 1
-
-/* Relocate STACK from its old location to the new one.  The
-   local variables YYSIZE and YYSTACKSIZE give the old and new number of
-   elements in the stack, and YYPTR gives the new location of the
-   stack.  Advance YYPTR to a properly aligned location for the next
-   stack.  */
-# define YYSTACK_RELOCATE(Stack_alloc, Stack)				\
-    do									\
-      {									\
-	YYSIZE_T yynewbytes;						\
-	YYCOPY (&yyptr->Stack_alloc, Stack, yysize);			\
-	Stack = &yyptr->Stack_alloc;					\
-	yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-	yyptr += yynewbytes / sizeof (*yyptr);				\
-      }									\
-    while (YYID (0))
-
-#endif
-
-#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
-/* Copy COUNT objects from SRC to DST.  The source and destination do
-   not overlap.  */
-# ifndef YYCOPY
-#  if defined __GNUC__ && 1 < __GNUC__
-#   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, (Count) * sizeof (*(Src)))
-#  else
-#   define YYCOPY(Dst, Src, Count)              \
-      do                                        \
-        {                                       \
-          YYSIZE_T yyi;                         \
-          for (yyi = 0; yyi < (Count); yyi++)   \
-            (Dst)[yyi] = (Src)[yyi];            \
-        }                                       \
-      while (YYID (0))
-#  endif
-# endif
-#endif /* !YYCOPY_NEEDED */
-
-/* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  3
-/* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   154
-
-/* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  34
-/* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  20
-/* YYNRULES -- Number of rules.  */
-#define YYNRULES  46
-/* YYNRULES -- Number of states.  */
-#define YYNSTATES  116
-
-/* YYTRANSLATE(YYLEX) -- Bison symbol number corresponding to YYLEX.  */
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   281
-
-#define YYTRANSLATE(YYX)						\
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
-
-/* YYTRANSLATE[YYLEX] -- Bison symbol number corresponding to YYLEX.  */
-static const yytype_uint8 yytranslate[] =
-{
-       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-      29,    30,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,    32,    27,
-       2,    28,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,    31,     2,    33,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
-       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
-      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
-      25,    26
-};
-
-#if YYDEBUG
-/* YYPRHS[YYN] -- Index of the first RHS symbol of rule number YYN in
-   YYRHS.  */
-static const yytype_uint8 yyprhs[] =
-{
-       0,     0,     3,     6,    11,    18,    25,    26,    28,    30,
-      32,    34,    36,    38,    40,    42,    44,    46,    48,    54,
-      60,    65,    71,    79,    88,    99,   102,   104,   110,   113,
-     114,   117,   121,   124,   125,   129,   133,   137,   141,   143,
-     145,   147,   151,   155,   159,   163,   168
-};
-
-/* YYRHS -- A `-1'-separated list of the rules' RHS.  */
-static const yytype_int8 yyrhs[] =
-{
-      35,     0,    -1,    36,    38,    -1,    36,    37,     9,    27,
-      -1,    36,    10,     9,    28,    52,    27,    -1,    36,    37,
-       9,    28,    52,    27,    -1,    -1,    17,    -1,    18,    -1,
-      41,    -1,    39,    -1,    40,    -1,    42,    -1,    43,    -1,
-      44,    -1,    45,    -1,    49,    -1,    50,    -1,    11,    29,
-       9,    30,    27,    -1,    12,    29,    52,    30,    27,    -1,
-       9,    28,    52,    27,    -1,    15,    29,    53,    30,    38,
-      -1,    13,    29,    53,    30,    38,    14,    38,    -1,    16,
-      29,    41,    53,    27,    41,    30,    38,    -1,    23,    29,
-      52,    30,    31,    46,    25,    32,    38,    33,    -1,    47,
-      46,    -1,    47,    -1,    24,     3,    32,    38,    48,    -1,
-      26,    27,    -1,    -1,    26,    27,    -1,    31,    51,    33,
-      -1,    38,    51,    -1,    -1,    52,     5,    52,    -1,    52,
-       6,    52,    -1,    52,     8,    52,    -1,    29,    52,    30,
-      -1,     9,    -1,     3,    -1,     4,    -1,    52,     7,    52,
-      -1,    53,    19,    53,    -1,    53,    20,    53,    -1,    53,
-      22,    53,    -1,    21,    29,    53,    30,    -1,    29,    53,
-      30,    -1
-};
-
-/* YYRLINE[YYN] -- source line where rule number YYN was defined.  */
-static const yytype_uint8 yyrline[] =
-{
-       0,    86,    86,    92,    95,   100,   105,   107,   108,   110,
-     111,   112,   113,   114,   115,   116,   117,   118,   120,   123,
-     125,   128,   130,   132,   135,   139,   143,   145,   147,   147,
-     149,   151,   159,   162,   164,   166,   168,   171,   172,   173,
-     174,   176,   178,   179,   180,   181,   182
-};
-#endif
-
-#if YYDEBUG || YYERROR_VERBOSE || 1
-/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
-   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
-static const char *const yytname[] =
-{
-  "$end", "error", "$undefined", "INT_NUM", "FLOAT_NUM", "ADDOP", "MULOP",
-  "RELOP", "POWER", "ID", "AUTO", "READ", "WRITE", "IF", "ELSE", "WHILE",
-  "FOR", "INT", "FLOAT", "OR", "AND", "NOT", "FAND", "SWITCH", "CASE",
-  "DEFAULT", "BREAK", "';'", "'='", "'('", "')'", "'{'", "':'", "'}'",
-  "$accept", "program", "declarations", "type", "stmt", "read_stmt",
-  "write_stmt", "assign_stmt", "while_stmt", "if_stmt", "for_stmt",
-  "switch_stmt", "caselist", "case", "optional_break", "break_stmt",
-  "block", "stmtlist", "expression", "boolexp", YY_NULL
-};
-#endif
-
-# ifdef YYPRINT
-/* YYTOKNUM[YYLEX-NUM] -- Internal token number corresponding to
-   token YYLEX-NUM.  */
-static const yytype_uint16 yytoknum[] =
-{
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,    59,    61,    40,
-      41,   123,    58,   125
-};
+#  define YY_EXCEPTIONS 1
 # endif
-
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
-{
-       0,    34,    35,    36,    36,    36,    36,    37,    37,    38,
-      38,    38,    38,    38,    38,    38,    38,    38,    39,    40,
-      41,    42,    43,    44,    45,    46,    46,    47,    48,    48,
-      49,    50,    51,    51,    52,    52,    52,    52,    52,    52,
-      52,    53,    53,    53,    53,    53,    53
-};
-
-/* YYR2[YYN] -- Number of symbols composing right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
-{
-       0,     2,     2,     4,     6,     6,     0,     1,     1,     1,
-       1,     1,     1,     1,     1,     1,     1,     1,     5,     5,
-       4,     5,     7,     8,    10,     2,     1,     5,     2,     0,
-       2,     3,     2,     0,     3,     3,     3,     3,     1,     1,
-       1,     3,     3,     3,     3,     4,     3
-};
-
-/* YYDEFACT[STATE-NAME] -- Default reduction number in state STATE-NUM.
-   Performed when YYTABLE doesn't specify something else to do.  Zero
-   means the default is an error.  */
-static const yytype_uint8 yydefact[] =
-{
-       6,     0,     0,     1,     0,     0,     0,     0,     0,     0,
-       0,     7,     8,     0,     0,    33,     0,     2,    10,    11,
-       9,    12,    13,    14,    15,    16,    17,     0,     0,     0,
-       0,     0,     0,     0,     0,    30,    33,     0,     0,    39,
-      40,    38,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,    32,    31,     3,     0,     0,     0,
-       0,     0,    20,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,    37,    34,
-      35,    36,     4,    18,    19,     0,    46,    41,    42,    43,
-      44,     0,    21,     0,     0,     5,    45,     0,     0,     0,
-       0,    26,    22,     0,     0,     0,    25,    23,     0,     0,
-      29,     0,     0,    27,    24,    28
-};
-
-/* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int8 yydefgoto[] =
-{
-      -1,     1,     2,    16,    36,    18,    19,    20,    21,    22,
-      23,    24,   100,   101,   113,    25,    26,    37,    49,    50
-};
-
-/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-   STATE-NUM.  */
-#define YYPACT_NINF -33
-static const yytype_int16 yypact[] =
-{
-     -33,    10,    87,   -33,   -21,    16,   -13,    12,    14,    26,
-      30,   -33,   -33,    35,    18,   108,    59,   -33,   -33,   -33,
-     -33,   -33,   -33,   -33,   -33,   -33,   -33,    11,    42,    66,
-      11,     9,     9,    72,    11,   -33,   108,     6,    -6,   -33,
-     -33,   -33,    11,    61,    11,    43,    48,    51,     9,   136,
-       7,    64,     9,    52,   -33,   -33,   -33,    11,    57,    11,
-      11,    11,   -33,    84,    58,    85,     9,    44,   110,    11,
-       9,     9,     9,   108,   108,   -16,    60,   120,   -33,    25,
-     106,   106,   -33,   -33,   -33,   116,   -33,    71,    73,   -33,
-      89,   101,   -33,    72,    92,   -33,   -33,   108,    97,   119,
-     112,    92,   -33,   108,   113,   117,   -33,   -33,   108,   108,
-     107,   115,   123,   -33,   -33,   -33
-};
-
-/* YYPGOTO[NTERM-NUM].  */
-static const yytype_int8 yypgoto[] =
-{
-     -33,   -33,   -33,   -33,    -2,   -33,   -33,   -32,   -33,   -33,
-     -33,   -33,    50,   -33,   -33,   -33,   -33,   118,   -25,   -24
-};
-
-/* YYTABLE[YYPACT[STATE-NUM]].  What to do in state STATE-NUM.  If
-   positive, shift that token.  If negative, reduce the rule which
-   number is the opposite.  If YYTABLE_NINF, syntax error.  */
-#define YYTABLE_NINF -1
-static const yytype_uint8 yytable[] =
-{
-      17,    52,    43,    70,    71,    46,    72,    27,    51,    53,
-       3,    93,    39,    40,    39,    40,    29,    58,    41,    63,
-      41,    56,    57,    67,    68,    28,    70,    71,    75,    72,
-      47,    60,    77,    61,    79,    80,    81,    73,    48,    55,
-      42,    30,    85,    31,    87,    35,    88,    89,    90,    59,
-      60,    69,    61,    59,    60,    32,    61,    59,    60,    33,
-      61,    98,    59,    60,    34,    61,    59,    60,    38,    61,
-      44,    91,    92,    64,    78,    45,    59,    60,    65,    61,
-      66,     4,    76,    70,    71,    83,    72,    78,    62,    59,
-      60,    94,    61,    71,    74,   102,     4,     5,     6,     7,
-       8,   107,     9,    10,    11,    12,   110,   111,    70,    71,
-      13,    82,    84,    14,    61,    97,    99,     4,    15,     6,
-       7,     8,   104,     9,    10,    59,    60,   103,    61,    70,
-      71,    13,    72,   112,    14,    70,    71,   105,    72,    15,
-      86,    59,    60,    69,    61,   108,    96,    95,   114,   109,
-     115,   106,     0,     0,    54
-};
-
-#define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-33)))
-
-#define yytable_value_is_error(Yytable_value) \
-  YYID (0)
-
-static const yytype_int8 yycheck[] =
-{
-       2,    33,    27,    19,    20,    30,    22,    28,    32,    34,
-       0,    27,     3,     4,     3,     4,    29,    42,     9,    44,
-       9,    27,    28,    48,    48,     9,    19,    20,    52,    22,
-      21,     6,    57,     8,    59,    60,    61,    30,    29,    33,
-      29,    29,    66,    29,    69,    27,    70,    71,    72,     5,
-       6,     7,     8,     5,     6,    29,     8,     5,     6,    29,
-       8,    93,     5,     6,    29,     8,     5,     6,     9,     8,
-      28,    73,    74,    30,    30,     9,     5,     6,    30,     8,
-      29,     9,    30,    19,    20,    27,    22,    30,    27,     5,
-       6,    31,     8,    20,    30,    97,     9,    10,    11,    12,
-      13,   103,    15,    16,    17,    18,   108,   109,    19,    20,
-      23,    27,    27,    26,     8,    14,    24,     9,    31,    11,
-      12,    13,     3,    15,    16,     5,     6,    30,     8,    19,
-      20,    23,    22,    26,    26,    19,    20,    25,    22,    31,
-      30,     5,     6,     7,     8,    32,    30,    27,    33,    32,
-      27,   101,    -1,    -1,    36
-};
-
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
-{
-       0,    35,    36,     0,     9,    10,    11,    12,    13,    15,
-      16,    17,    18,    23,    26,    31,    37,    38,    39,    40,
-      41,    42,    43,    44,    45,    49,    50,    28,     9,    29,
-      29,    29,    29,    29,    29,    27,    38,    51,     9,     3,
-       4,     9,    29,    52,    28,     9,    52,    21,    29,    52,
-      53,    53,    41,    52,    51,    33,    27,    28,    52,     5,
-       6,     8,    27,    52,    30,    30,    29,    52,    53,     7,
-      19,    20,    22,    30,    30,    53,    30,    52,    30,    52,
-      52,    52,    27,    27,    27,    53,    30,    52,    53,    53,
-      53,    38,    38,    27,    31,    27,    30,    14,    41,    24,
-      46,    47,    38,    30,     3,    25,    46,    38,    32,    32,
-      38,    38,    26,    48,    33,    27
-};
-
-#define yyerrok		(yyerrstatus = 0)
-#define yyclearin	(yychar = YYEMPTY)
-#define YYEMPTY		(-2)
-#define YYEOF		0
-
-#define YYACCEPT	goto yyacceptlab
-#define YYABORT		goto yyabortlab
-#define YYERROR		goto yyerrorlab
-
-
-/* Like YYERROR except do call yyerror.  This remains here temporarily
-   to ease the transition to the new meaning of YYERROR, for GCC.
-   Once GCC version 2 has supplanted version 1, this can go.  However,
-   YYFAIL appears to be in use.  Nevertheless, it is formally deprecated
-   in Bison 2.4.2's NEWS entry, where a plan to phase it out is
-   discussed.  */
-
-#define YYFAIL		goto yyerrlab
-#if defined YYFAIL
-  /* This is here to suppress warnings from the GCC cpp's
-     -Wunused-macros.  Normally we don't worry about that warning, but
-     some users do, and we want to make it easy for users to remove
-     YYFAIL uses, which will produce warnings from Bison 2.5.  */
 #endif
 
-#define YYRECOVERING()  (!!yyerrstatus)
-
-#define YYBACKUP(Token, Value)                                  \
-do                                                              \
-  if (yychar == YYEMPTY)                                        \
-    {                                                           \
-      yychar = (Token);                                         \
-      yylval = (Value);                                         \
-      YYPOPSTACK (yylen);                                       \
-      yystate = *yyssp;                                         \
-      goto yybackup;                                            \
-    }                                                           \
-  else                                                          \
-    {                                                           \
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;							\
-    }								\
-while (YYID (0))
-
-/* Error token number */
-#define YYTERROR	1
-#define YYERRCODE	256
-
-
+#define YYRHSLOC(Rhs, K) ((Rhs)[K].location)
 /* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
    If N is 0, then set CURRENT to the empty location which ends
    the previous symbol: RHS[0] (always defined).  */
 
-#ifndef YYLLOC_DEFAULT
-# define YYLLOC_DEFAULT(Current, Rhs, N)                                \
+# ifndef YYLLOC_DEFAULT
+#  define YYLLOC_DEFAULT(Current, Rhs, N)                               \
     do                                                                  \
-      if (YYID (N))                                                     \
+      if (N)                                                            \
         {                                                               \
-          (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;        \
-          (Current).first_column = YYRHSLOC (Rhs, 1).first_column;      \
-          (Current).last_line    = YYRHSLOC (Rhs, N).last_line;         \
-          (Current).last_column  = YYRHSLOC (Rhs, N).last_column;       \
+          (Current).begin  = YYRHSLOC (Rhs, 1).begin;                   \
+          (Current).end    = YYRHSLOC (Rhs, N).end;                     \
         }                                                               \
       else                                                              \
         {                                                               \
-          (Current).first_line   = (Current).last_line   =              \
-            YYRHSLOC (Rhs, 0).last_line;                                \
-          (Current).first_column = (Current).last_column =              \
-            YYRHSLOC (Rhs, 0).last_column;                              \
+          (Current).begin = (Current).end = YYRHSLOC (Rhs, 0).end;      \
         }                                                               \
-    while (YYID (0))
-#endif
-
-#define YYRHSLOC(Rhs, K) ((Rhs)[K])
-
-
-/* YY_LOCATION_PRINT -- Print the location on the stream.
-   This macro was not mandated originally: define only if we know
-   we won't break user code: when these are the locations we know.  */
-
-#ifndef __attribute__
-/* This feature is available in gcc versions 2.5 and later.  */
-# if (! defined __GNUC__ || __GNUC__ < 2 \
-      || (__GNUC__ == 2 && __GNUC_MINOR__ < 5))
-#  define __attribute__(Spec) /* empty */
+    while (false)
 # endif
-#endif
 
-#ifndef YY_LOCATION_PRINT
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
 
-/* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
+// Enable debugging if requested.
+#if YYDEBUG
 
-__attribute__((__unused__))
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static unsigned
-yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
+// A pseudo ostream that takes yydebug_ into account.
+# define YYCDEBUG if (yydebug_) (*yycdebug_)
+
+# define YY_SYMBOL_PRINT(Title, Symbol)         \
+  do {                                          \
+    if (yydebug_)                               \
+    {                                           \
+      *yycdebug_ << Title << ' ';               \
+      yy_print_ (*yycdebug_, Symbol);           \
+      *yycdebug_ << '\n';                       \
+    }                                           \
+  } while (false)
+
+# define YY_REDUCE_PRINT(Rule)          \
+  do {                                  \
+    if (yydebug_)                       \
+      yy_reduce_print_ (Rule);          \
+  } while (false)
+
+# define YY_STACK_PRINT()               \
+  do {                                  \
+    if (yydebug_)                       \
+      yy_stack_print_ ();                \
+  } while (false)
+
+#else // !YYDEBUG
+
+# define YYCDEBUG if (false) std::cerr
+# define YY_SYMBOL_PRINT(Title, Symbol)  YY_USE (Symbol)
+# define YY_REDUCE_PRINT(Rule)           static_cast<void> (0)
+# define YY_STACK_PRINT()                static_cast<void> (0)
+
+#endif // !YYDEBUG
+
+#define yyerrok         (yyerrstatus_ = 0)
+#define yyclearin       (yyla.clear ())
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYRECOVERING()  (!!yyerrstatus_)
+
+namespace yy {
+#line 178 "ast.tab.c"
+
+  /// Build a parser object.
+  Parser::Parser (void *scanner_yyarg, CompilerContext *ctx_yyarg)
+#if YYDEBUG
+    : yydebug_ (false),
+      yycdebug_ (&std::cerr),
 #else
-static unsigned
-yy_location_print_ (yyo, yylocp)
-    FILE *yyo;
-    YYLTYPE const * const yylocp;
+    :
 #endif
-{
-  unsigned res = 0;
-  int end_col = 0 != yylocp->last_column ? yylocp->last_column - 1 : 0;
-  if (0 <= yylocp->first_line)
-    {
-      res += fprintf (yyo, "%d", yylocp->first_line);
-      if (0 <= yylocp->first_column)
-        res += fprintf (yyo, ".%d", yylocp->first_column);
-    }
-  if (0 <= yylocp->last_line)
+      scanner (scanner_yyarg),
+      ctx (ctx_yyarg)
+  {}
+
+  Parser::~Parser ()
+  {}
+
+  Parser::syntax_error::~syntax_error () YY_NOEXCEPT YY_NOTHROW
+  {}
+
+  /*---------.
+  | symbol.  |
+  `---------*/
+
+  // basic_symbol.
+  template <typename Base>
+  Parser::basic_symbol<Base>::basic_symbol (const basic_symbol& that)
+    : Base (that)
+    , value ()
+    , location (that.location)
+  {
+    switch (this->kind ())
     {
-      if (yylocp->first_line < yylocp->last_line)
-        {
-          res += fprintf (yyo, "-%d", yylocp->last_line);
-          if (0 <= end_col)
-            res += fprintf (yyo, ".%d", end_col);
-        }
-      else if (0 <= end_col && yylocp->first_column < end_col)
-        res += fprintf (yyo, "-%d", end_col);
-    }
-  return res;
- }
+      case symbol_kind::S_assign_stmt: // assign_stmt
+        value.copy< AssignStmt * > (YY_MOVE (that.value));
+        break;
 
-#  define YY_LOCATION_PRINT(File, Loc)          \
-  yy_location_print_ (File, &(Loc))
+      case symbol_kind::S_outer_block: // outer_block
+      case symbol_kind::S_block: // block
+        value.copy< Block * > (YY_MOVE (that.value));
+        break;
 
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
+      case symbol_kind::S_boolexp: // boolexp
+        value.copy< BoolExp * > (YY_MOVE (that.value));
+        break;
 
+      case symbol_kind::S_break_stmt: // break_stmt
+        value.copy< BreakStmt * > (YY_MOVE (that.value));
+        break;
 
-/* YYLEX -- calling `yylex' with the right arguments.  */
-#ifdef YYLEX_PARAM
-# define YYLEX yylex (YYLEX_PARAM)
-#else
-# define YYLEX yylex ()
-#endif
+      case symbol_kind::S_caselist: // caselist
+      case symbol_kind::S_case: // case
+        value.copy< Case * > (YY_MOVE (that.value));
+        break;
 
-/* Enable debugging if requested.  */
-#if YYDEBUG
+      case symbol_kind::S_expression: // expression
+        value.copy< Exp * > (YY_MOVE (that.value));
+        break;
 
-# ifndef YYFPRINTF
-#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
-#  define YYFPRINTF fprintf
-# endif
+      case symbol_kind::S_for_stmt: // for_stmt
+        value.copy< ForStmt * > (YY_MOVE (that.value));
+        break;
 
-# define YYDPRINTF(Args)			\
-do {						\
-  if (yydebug)					\
-    YYFPRINTF Args;				\
-} while (YYID (0))
-
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)			  \
-do {									  \
-  if (yydebug)								  \
-    {									  \
-      YYFPRINTF (stderr, "%s ", Title);					  \
-      yy_symbol_print (stderr,						  \
-		  Type, Value, Location); \
-      YYFPRINTF (stderr, "\n");						  \
-    }									  \
-} while (YYID (0))
-
-
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
-
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
-#else
-static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-    YYLTYPE const * const yylocationp;
-#endif
-{
-  FILE *yyo = yyoutput;
-  YYUSE (yyo);
-  if (!yyvaluep)
-    return;
-  YYUSE (yylocationp);
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# else
-  YYUSE (yyoutput);
-# endif
-  switch (yytype)
-    {
-      default:
+      case symbol_kind::S_if_stmt: // if_stmt
+        value.copy< IfStmt * > (YY_MOVE (that.value));
         break;
-    }
-}
 
+      case symbol_kind::S_read_stmt: // read_stmt
+        value.copy< ReadStmt * > (YY_MOVE (that.value));
+        break;
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+      case symbol_kind::S_program_stmt: // program_stmt
+      case symbol_kind::S_stmt: // stmt
+      case symbol_kind::S_nonblock_stmt: // nonblock_stmt
+        value.copy< Stmt * > (YY_MOVE (that.value));
+        break;
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
-#else
-static void
-yy_symbol_print (yyoutput, yytype, yyvaluep, yylocationp)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-    YYLTYPE const * const yylocationp;
-#endif
-{
-  if (yytype < YYNTOKENS)
-    YYFPRINTF (yyoutput, "token %s (", yytname[yytype]);
-  else
-    YYFPRINTF (yyoutput, "nterm %s (", yytname[yytype]);
-
-  YY_LOCATION_PRINT (yyoutput, *yylocationp);
-  YYFPRINTF (yyoutput, ": ");
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep, yylocationp);
-  YYFPRINTF (yyoutput, ")");
-}
+      case symbol_kind::S_outer_stmtlist: // outer_stmtlist
+      case symbol_kind::S_stmtlist: // stmtlist
+        value.copy< StmtList > (YY_MOVE (that.value));
+        break;
 
-/*------------------------------------------------------------------.
-| yy_stack_print -- Print the state stack from its BOTTOM up to its |
-| TOP (included).                                                   |
-`------------------------------------------------------------------*/
+      case symbol_kind::S_switch_stmt: // switch_stmt
+        value.copy< SwitchStmt * > (YY_MOVE (that.value));
+        break;
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_stack_print (yytype_int16 *yybottom, yytype_int16 *yytop)
-#else
-static void
-yy_stack_print (yybottom, yytop)
-    yytype_int16 *yybottom;
-    yytype_int16 *yytop;
-#endif
-{
-  YYFPRINTF (stderr, "Stack now");
-  for (; yybottom <= yytop; yybottom++)
-    {
-      int yybot = *yybottom;
-      YYFPRINTF (stderr, " %d", yybot);
-    }
-  YYFPRINTF (stderr, "\n");
-}
+      case symbol_kind::S_while_stmt: // while_stmt
+        value.copy< WhileStmt * > (YY_MOVE (that.value));
+        break;
 
-# define YY_STACK_PRINT(Bottom, Top)				\
-do {								\
-  if (yydebug)							\
-    yy_stack_print ((Bottom), (Top));				\
-} while (YYID (0))
+      case symbol_kind::S_write_stmt: // write_stmt
+        value.copy< WriteStmt * > (YY_MOVE (that.value));
+        break;
 
+      case symbol_kind::S_optional_break: // optional_break
+        value.copy< bool > (YY_MOVE (that.value));
+        break;
 
-/*------------------------------------------------.
-| Report that the YYRULE is going to be reduced.  |
-`------------------------------------------------*/
+      case symbol_kind::S_ID: // ID
+        value.copy< const char * > (YY_MOVE (that.value));
+        break;
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_reduce_print (YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule)
-#else
-static void
-yy_reduce_print (yyvsp, yylsp, yyrule)
-    YYSTYPE *yyvsp;
-    YYLTYPE *yylsp;
-    int yyrule;
-#endif
-{
-  int yynrhs = yyr2[yyrule];
-  int yyi;
-  unsigned long int yylno = yyrline[yyrule];
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
-	     yyrule - 1, yylno);
-  /* The symbols being reduced.  */
-  for (yyi = 0; yyi < yynrhs; yyi++)
-    {
-      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
-      yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
-		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       , &(yylsp[(yyi + 1) - (yynrhs)])		       );
-      YYFPRINTF (stderr, "\n");
-    }
-}
+      case symbol_kind::S_FLOAT_NUM: // FLOAT_NUM
+        value.copy< double > (YY_MOVE (that.value));
+        break;
 
-# define YY_REDUCE_PRINT(Rule)		\
-do {					\
-  if (yydebug)				\
-    yy_reduce_print (yyvsp, yylsp, Rule); \
-} while (YYID (0))
-
-/* Nonzero means print parse trace.  It is left uninitialized so that
-   multiple parsers can coexist.  */
-int yydebug;
-#else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
-# define YY_STACK_PRINT(Bottom, Top)
-# define YY_REDUCE_PRINT(Rule)
-#endif /* !YYDEBUG */
-
-
-/* YYINITDEPTH -- initial size of the parser's stacks.  */
-#ifndef	YYINITDEPTH
-# define YYINITDEPTH 200
-#endif
+      case symbol_kind::S_ADDOP: // ADDOP
+      case symbol_kind::S_MULOP: // MULOP
+      case symbol_kind::S_RELOP: // RELOP
+      case symbol_kind::S_POWER: // POWER
+        value.copy< enum op > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_INT_NUM: // INT_NUM
+        value.copy< int > (YY_MOVE (that.value));
+        break;
 
-/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
-   if the built-in stack extension method is used).
+      case symbol_kind::S_type: // type
+        value.copy< myType > (YY_MOVE (that.value));
+        break;
 
-   Do not make this value too large; the results are undefined if
-   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
-   evaluated with infinite-precision integer arithmetic.  */
+      default:
+        break;
+    }
 
-#ifndef YYMAXDEPTH
-# define YYMAXDEPTH 10000
-#endif
+  }
 
 
-#if YYERROR_VERBOSE
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static YYSIZE_T
-yystrlen (const char *yystr)
-#else
-static YYSIZE_T
-yystrlen (yystr)
-    const char *yystr;
-#endif
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
 
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-#else
-static char *
-yystpcpy (yydest, yysrc)
-    char *yydest;
-    const char *yysrc;
-#endif
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
+  template <typename Base>
+  Parser::symbol_kind_type
+  Parser::basic_symbol<Base>::type_get () const YY_NOEXCEPT
+  {
+    return this->kind ();
+  }
 
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
 
-  return yyd - 1;
-}
-#  endif
-# endif
+  template <typename Base>
+  bool
+  Parser::basic_symbol<Base>::empty () const YY_NOEXCEPT
+  {
+    return this->kind () == symbol_kind::S_YYEMPTY;
+  }
 
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
+  template <typename Base>
+  void
+  Parser::basic_symbol<Base>::move (basic_symbol& s)
+  {
+    super_type::move (s);
+    switch (this->kind ())
     {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-	switch (*++yyp)
-	  {
-	  case '\'':
-	  case ',':
-	    goto do_not_strip_quotes;
-
-	  case '\\':
-	    if (*++yyp != '\\')
-	      goto do_not_strip_quotes;
-	    /* Fall through.  */
-	  default:
-	    if (yyres)
-	      yyres[yyn] = *yyp;
-	    yyn++;
-	    break;
-
-	  case '"':
-	    if (yyres)
-	      yyres[yyn] = '\0';
-	    return yyn;
-	  }
-    do_not_strip_quotes: ;
-    }
+      case symbol_kind::S_assign_stmt: // assign_stmt
+        value.move< AssignStmt * > (YY_MOVE (s.value));
+        break;
 
-  if (! yyres)
-    return yystrlen (yystr);
+      case symbol_kind::S_outer_block: // outer_block
+      case symbol_kind::S_block: // block
+        value.move< Block * > (YY_MOVE (s.value));
+        break;
 
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
+      case symbol_kind::S_boolexp: // boolexp
+        value.move< BoolExp * > (YY_MOVE (s.value));
+        break;
 
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
-
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int
-yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
-                yytype_int16 *yyssp, int yytoken)
-{
-  YYSIZE_T yysize0 = yytnamerr (YY_NULL, yytname[yytoken]);
-  YYSIZE_T yysize = yysize0;
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULL;
-  /* Arguments of yyformat. */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Number of reported tokens (one for the "unexpected", one per
-     "expected"). */
-  int yycount = 0;
-
-  /* There are many possibilities here to consider:
-     - Assume YYFAIL is not used.  It's too flawed to consider.  See
-       <http://lists.gnu.org/archive/html/bison-patches/2009-12/msg00024.html>
-       for details.  YYERROR is fine as it does not invoke this
-       function.
-     - If this state is a consistent state with a default action, then
-       the only way this function was invoked is if the default action
-       is an error action.  In that case, don't check for expected
-       tokens because there are none.
-     - The only way there can be no lookahead present (in yychar) is if
-       this state is a consistent state with a default action.  Thus,
-       detecting the absence of a lookahead is sufficient to determine
-       that there is no unexpected or expected token to report.  In that
-       case, just report a simple "syntax error".
-     - Don't assume there isn't a lookahead just because this state is a
-       consistent state with a default action.  There might have been a
-       previous inconsistent state, consistent state with a non-default
-       action, or user semantic action that manipulated yychar.
-     - Of course, the expected token list depends on states to have
-       correct lookahead information, and it depends on the parser not
-       to perform extra reductions after fetching a lookahead from the
-       scanner and before detecting a syntax error.  Thus, state merging
-       (from LALR or IELR) and default reductions corrupt the expected
-       token list.  However, the list is correct for canonical LR with
-       one exception: it will still contain any token that will not be
-       accepted due to an error action in a later state.
-  */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[*yyssp];
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYSIZE_T yysize1 = yysize + yytnamerr (YY_NULL, yytname[yyx]);
-                  if (! (yysize <= yysize1
-                         && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-                    return 2;
-                  yysize = yysize1;
-                }
-              }
-        }
-    }
+      case symbol_kind::S_break_stmt: // break_stmt
+        value.move< BreakStmt * > (YY_MOVE (s.value));
+        break;
 
-  switch (yycount)
-    {
-# define YYCASE_(N, S)                      \
-      case N:                               \
-        yyformat = S;                       \
-      break
-      YYCASE_(0, YY_("syntax error"));
-      YYCASE_(1, YY_("syntax error, unexpected %s"));
-      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
+      case symbol_kind::S_caselist: // caselist
+      case symbol_kind::S_case: // case
+        value.move< Case * > (YY_MOVE (s.value));
+        break;
 
-  {
-    YYSIZE_T yysize1 = yysize + yystrlen (yyformat);
-    if (! (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-      return 2;
-    yysize = yysize1;
-  }
+      case symbol_kind::S_expression: // expression
+        value.move< Exp * > (YY_MOVE (s.value));
+        break;
 
-  if (*yymsg_alloc < yysize)
-    {
-      *yymsg_alloc = 2 * yysize;
-      if (! (yysize <= *yymsg_alloc
-             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
-    }
+      case symbol_kind::S_for_stmt: // for_stmt
+        value.move< ForStmt * > (YY_MOVE (s.value));
+        break;
 
-  /* Avoid sprintf, as that infringes on the user's name space.
-     Don't have undefined behavior even if the translation
-     produced a string with the wrong number of "%s"s.  */
-  {
-    char *yyp = *yymsg;
-    int yyi = 0;
-    while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
-        {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
-          yyformat += 2;
-        }
-      else
-        {
-          yyp++;
-          yyformat++;
-        }
-  }
-  return 0;
-}
-#endif /* YYERROR_VERBOSE */
+      case symbol_kind::S_if_stmt: // if_stmt
+        value.move< IfStmt * > (YY_MOVE (s.value));
+        break;
 
-/*-----------------------------------------------.
-| Release the memory associated to this symbol.  |
-`-----------------------------------------------*/
+      case symbol_kind::S_read_stmt: // read_stmt
+        value.move< ReadStmt * > (YY_MOVE (s.value));
+        break;
 
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
-#else
-static void
-yydestruct (yymsg, yytype, yyvaluep, yylocationp)
-    const char *yymsg;
-    int yytype;
-    YYSTYPE *yyvaluep;
-    YYLTYPE *yylocationp;
-#endif
-{
-  YYUSE (yyvaluep);
-  YYUSE (yylocationp);
+      case symbol_kind::S_program_stmt: // program_stmt
+      case symbol_kind::S_stmt: // stmt
+      case symbol_kind::S_nonblock_stmt: // nonblock_stmt
+        value.move< Stmt * > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_outer_stmtlist: // outer_stmtlist
+      case symbol_kind::S_stmtlist: // stmtlist
+        value.move< StmtList > (YY_MOVE (s.value));
+        break;
 
-  if (!yymsg)
-    yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+      case symbol_kind::S_switch_stmt: // switch_stmt
+        value.move< SwitchStmt * > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_while_stmt: // while_stmt
+        value.move< WhileStmt * > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_write_stmt: // write_stmt
+        value.move< WriteStmt * > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_optional_break: // optional_break
+        value.move< bool > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_ID: // ID
+        value.move< const char * > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_FLOAT_NUM: // FLOAT_NUM
+        value.move< double > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_ADDOP: // ADDOP
+      case symbol_kind::S_MULOP: // MULOP
+      case symbol_kind::S_RELOP: // RELOP
+      case symbol_kind::S_POWER: // POWER
+        value.move< enum op > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_INT_NUM: // INT_NUM
+        value.move< int > (YY_MOVE (s.value));
+        break;
+
+      case symbol_kind::S_type: // type
+        value.move< myType > (YY_MOVE (s.value));
+        break;
+
+      default:
+        break;
+    }
+
+    location = YY_MOVE (s.location);
+  }
+
+  // by_kind.
+  Parser::by_kind::by_kind () YY_NOEXCEPT
+    : kind_ (symbol_kind::S_YYEMPTY)
+  {}
+
+#if 201103L <= YY_CPLUSPLUS
+  Parser::by_kind::by_kind (by_kind&& that) YY_NOEXCEPT
+    : kind_ (that.kind_)
+  {
+    that.clear ();
+  }
+#endif
+
+  Parser::by_kind::by_kind (const by_kind& that) YY_NOEXCEPT
+    : kind_ (that.kind_)
+  {}
+
+  Parser::by_kind::by_kind (token_kind_type t) YY_NOEXCEPT
+    : kind_ (yytranslate_ (t))
+  {}
+
+
+
+  void
+  Parser::by_kind::clear () YY_NOEXCEPT
+  {
+    kind_ = symbol_kind::S_YYEMPTY;
+  }
+
+  void
+  Parser::by_kind::move (by_kind& that)
+  {
+    kind_ = that.kind_;
+    that.clear ();
+  }
+
+  Parser::symbol_kind_type
+  Parser::by_kind::kind () const YY_NOEXCEPT
+  {
+    return kind_;
+  }
+
+
+  Parser::symbol_kind_type
+  Parser::by_kind::type_get () const YY_NOEXCEPT
+  {
+    return this->kind ();
+  }
+
+
+
+  // by_state.
+  Parser::by_state::by_state () YY_NOEXCEPT
+    : state (empty_state)
+  {}
+
+  Parser::by_state::by_state (const by_state& that) YY_NOEXCEPT
+    : state (that.state)
+  {}
+
+  void
+  Parser::by_state::clear () YY_NOEXCEPT
+  {
+    state = empty_state;
+  }
+
+  void
+  Parser::by_state::move (by_state& that)
+  {
+    state = that.state;
+    that.clear ();
+  }
+
+  Parser::by_state::by_state (state_type s) YY_NOEXCEPT
+    : state (s)
+  {}
+
+  Parser::symbol_kind_type
+  Parser::by_state::kind () const YY_NOEXCEPT
+  {
+    if (state == empty_state)
+      return symbol_kind::S_YYEMPTY;
+    else
+      return YY_CAST (symbol_kind_type, yystos_[+state]);
+  }
+
+  Parser::stack_symbol_type::stack_symbol_type ()
+  {}
+
+  Parser::stack_symbol_type::stack_symbol_type (YY_RVREF (stack_symbol_type) that)
+    : super_type (YY_MOVE (that.state), YY_MOVE (that.location))
+  {
+    switch (that.kind ())
+    {
+      case symbol_kind::S_assign_stmt: // assign_stmt
+        value.YY_MOVE_OR_COPY< AssignStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_outer_block: // outer_block
+      case symbol_kind::S_block: // block
+        value.YY_MOVE_OR_COPY< Block * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_boolexp: // boolexp
+        value.YY_MOVE_OR_COPY< BoolExp * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_break_stmt: // break_stmt
+        value.YY_MOVE_OR_COPY< BreakStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_caselist: // caselist
+      case symbol_kind::S_case: // case
+        value.YY_MOVE_OR_COPY< Case * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_expression: // expression
+        value.YY_MOVE_OR_COPY< Exp * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_for_stmt: // for_stmt
+        value.YY_MOVE_OR_COPY< ForStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_if_stmt: // if_stmt
+        value.YY_MOVE_OR_COPY< IfStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_read_stmt: // read_stmt
+        value.YY_MOVE_OR_COPY< ReadStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_program_stmt: // program_stmt
+      case symbol_kind::S_stmt: // stmt
+      case symbol_kind::S_nonblock_stmt: // nonblock_stmt
+        value.YY_MOVE_OR_COPY< Stmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_outer_stmtlist: // outer_stmtlist
+      case symbol_kind::S_stmtlist: // stmtlist
+        value.YY_MOVE_OR_COPY< StmtList > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_switch_stmt: // switch_stmt
+        value.YY_MOVE_OR_COPY< SwitchStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_while_stmt: // while_stmt
+        value.YY_MOVE_OR_COPY< WhileStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_write_stmt: // write_stmt
+        value.YY_MOVE_OR_COPY< WriteStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_optional_break: // optional_break
+        value.YY_MOVE_OR_COPY< bool > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_ID: // ID
+        value.YY_MOVE_OR_COPY< const char * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_FLOAT_NUM: // FLOAT_NUM
+        value.YY_MOVE_OR_COPY< double > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_ADDOP: // ADDOP
+      case symbol_kind::S_MULOP: // MULOP
+      case symbol_kind::S_RELOP: // RELOP
+      case symbol_kind::S_POWER: // POWER
+        value.YY_MOVE_OR_COPY< enum op > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_INT_NUM: // INT_NUM
+        value.YY_MOVE_OR_COPY< int > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_type: // type
+        value.YY_MOVE_OR_COPY< myType > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+#if 201103L <= YY_CPLUSPLUS
+    // that is emptied.
+    that.state = empty_state;
+#endif
+  }
+
+  Parser::stack_symbol_type::stack_symbol_type (state_type s, YY_MOVE_REF (symbol_type) that)
+    : super_type (s, YY_MOVE (that.location))
+  {
+    switch (that.kind ())
+    {
+      case symbol_kind::S_assign_stmt: // assign_stmt
+        value.move< AssignStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_outer_block: // outer_block
+      case symbol_kind::S_block: // block
+        value.move< Block * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_boolexp: // boolexp
+        value.move< BoolExp * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_break_stmt: // break_stmt
+        value.move< BreakStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_caselist: // caselist
+      case symbol_kind::S_case: // case
+        value.move< Case * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_expression: // expression
+        value.move< Exp * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_for_stmt: // for_stmt
+        value.move< ForStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_if_stmt: // if_stmt
+        value.move< IfStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_read_stmt: // read_stmt
+        value.move< ReadStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_program_stmt: // program_stmt
+      case symbol_kind::S_stmt: // stmt
+      case symbol_kind::S_nonblock_stmt: // nonblock_stmt
+        value.move< Stmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_outer_stmtlist: // outer_stmtlist
+      case symbol_kind::S_stmtlist: // stmtlist
+        value.move< StmtList > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_switch_stmt: // switch_stmt
+        value.move< SwitchStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_while_stmt: // while_stmt
+        value.move< WhileStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_write_stmt: // write_stmt
+        value.move< WriteStmt * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_optional_break: // optional_break
+        value.move< bool > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_ID: // ID
+        value.move< const char * > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_FLOAT_NUM: // FLOAT_NUM
+        value.move< double > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_ADDOP: // ADDOP
+      case symbol_kind::S_MULOP: // MULOP
+      case symbol_kind::S_RELOP: // RELOP
+      case symbol_kind::S_POWER: // POWER
+        value.move< enum op > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_INT_NUM: // INT_NUM
+        value.move< int > (YY_MOVE (that.value));
+        break;
+
+      case symbol_kind::S_type: // type
+        value.move< myType > (YY_MOVE (that.value));
+        break;
+
+      default:
+        break;
+    }
+
+    // that is emptied.
+    that.kind_ = symbol_kind::S_YYEMPTY;
+  }
+
+#if YY_CPLUSPLUS < 201103L
+  Parser::stack_symbol_type&
+  Parser::stack_symbol_type::operator= (const stack_symbol_type& that)
+  {
+    state = that.state;
+    switch (that.kind ())
+    {
+      case symbol_kind::S_assign_stmt: // assign_stmt
+        value.copy< AssignStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_outer_block: // outer_block
+      case symbol_kind::S_block: // block
+        value.copy< Block * > (that.value);
+        break;
+
+      case symbol_kind::S_boolexp: // boolexp
+        value.copy< BoolExp * > (that.value);
+        break;
+
+      case symbol_kind::S_break_stmt: // break_stmt
+        value.copy< BreakStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_caselist: // caselist
+      case symbol_kind::S_case: // case
+        value.copy< Case * > (that.value);
+        break;
+
+      case symbol_kind::S_expression: // expression
+        value.copy< Exp * > (that.value);
+        break;
+
+      case symbol_kind::S_for_stmt: // for_stmt
+        value.copy< ForStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_if_stmt: // if_stmt
+        value.copy< IfStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_read_stmt: // read_stmt
+        value.copy< ReadStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_program_stmt: // program_stmt
+      case symbol_kind::S_stmt: // stmt
+      case symbol_kind::S_nonblock_stmt: // nonblock_stmt
+        value.copy< Stmt * > (that.value);
+        break;
+
+      case symbol_kind::S_outer_stmtlist: // outer_stmtlist
+      case symbol_kind::S_stmtlist: // stmtlist
+        value.copy< StmtList > (that.value);
+        break;
+
+      case symbol_kind::S_switch_stmt: // switch_stmt
+        value.copy< SwitchStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_while_stmt: // while_stmt
+        value.copy< WhileStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_write_stmt: // write_stmt
+        value.copy< WriteStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_optional_break: // optional_break
+        value.copy< bool > (that.value);
+        break;
+
+      case symbol_kind::S_ID: // ID
+        value.copy< const char * > (that.value);
+        break;
+
+      case symbol_kind::S_FLOAT_NUM: // FLOAT_NUM
+        value.copy< double > (that.value);
+        break;
+
+      case symbol_kind::S_ADDOP: // ADDOP
+      case symbol_kind::S_MULOP: // MULOP
+      case symbol_kind::S_RELOP: // RELOP
+      case symbol_kind::S_POWER: // POWER
+        value.copy< enum op > (that.value);
+        break;
+
+      case symbol_kind::S_INT_NUM: // INT_NUM
+        value.copy< int > (that.value);
+        break;
+
+      case symbol_kind::S_type: // type
+        value.copy< myType > (that.value);
+        break;
+
+      default:
+        break;
+    }
+
+    location = that.location;
+    return *this;
+  }
+
+  Parser::stack_symbol_type&
+  Parser::stack_symbol_type::operator= (stack_symbol_type& that)
+  {
+    state = that.state;
+    switch (that.kind ())
+    {
+      case symbol_kind::S_assign_stmt: // assign_stmt
+        value.move< AssignStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_outer_block: // outer_block
+      case symbol_kind::S_block: // block
+        value.move< Block * > (that.value);
+        break;
+
+      case symbol_kind::S_boolexp: // boolexp
+        value.move< BoolExp * > (that.value);
+        break;
+
+      case symbol_kind::S_break_stmt: // break_stmt
+        value.move< BreakStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_caselist: // caselist
+      case symbol_kind::S_case: // case
+        value.move< Case * > (that.value);
+        break;
+
+      case symbol_kind::S_expression: // expression
+        value.move< Exp * > (that.value);
+        break;
+
+      case symbol_kind::S_for_stmt: // for_stmt
+        value.move< ForStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_if_stmt: // if_stmt
+        value.move< IfStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_read_stmt: // read_stmt
+        value.move< ReadStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_program_stmt: // program_stmt
+      case symbol_kind::S_stmt: // stmt
+      case symbol_kind::S_nonblock_stmt: // nonblock_stmt
+        value.move< Stmt * > (that.value);
+        break;
+
+      case symbol_kind::S_outer_stmtlist: // outer_stmtlist
+      case symbol_kind::S_stmtlist: // stmtlist
+        value.move< StmtList > (that.value);
+        break;
+
+      case symbol_kind::S_switch_stmt: // switch_stmt
+        value.move< SwitchStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_while_stmt: // while_stmt
+        value.move< WhileStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_write_stmt: // write_stmt
+        value.move< WriteStmt * > (that.value);
+        break;
+
+      case symbol_kind::S_optional_break: // optional_break
+        value.move< bool > (that.value);
+        break;
+
+      case symbol_kind::S_ID: // ID
+        value.move< const char * > (that.value);
+        break;
+
+      case symbol_kind::S_FLOAT_NUM: // FLOAT_NUM
+        value.move< double > (that.value);
+        break;
+
+      case symbol_kind::S_ADDOP: // ADDOP
+      case symbol_kind::S_MULOP: // MULOP
+      case symbol_kind::S_RELOP: // RELOP
+      case symbol_kind::S_POWER: // POWER
+        value.move< enum op > (that.value);
+        break;
+
+      case symbol_kind::S_INT_NUM: // INT_NUM
+        value.move< int > (that.value);
+        break;
+
+      case symbol_kind::S_type: // type
+        value.move< myType > (that.value);
+        break;
+
+      default:
+        break;
+    }
+
+    location = that.location;
+    // that is emptied.
+    that.state = empty_state;
+    return *this;
+  }
+#endif
+
+  template <typename Base>
+  void
+  Parser::yy_destroy_ (const char* yymsg, basic_symbol<Base>& yysym) const
+  {
+    if (yymsg)
+      YY_SYMBOL_PRINT (yymsg, yysym);
+  }
+
+#if YYDEBUG
+  template <typename Base>
+  void
+  Parser::yy_print_ (std::ostream& yyo, const basic_symbol<Base>& yysym) const
+  {
+    std::ostream& yyoutput = yyo;
+    YY_USE (yyoutput);
+    if (yysym.empty ())
+      yyo << "empty symbol";
+    else
+      {
+        symbol_kind_type yykind = yysym.kind ();
+        yyo << (yykind < YYNTOKENS ? "token" : "nterm")
+            << ' ' << yysym.name () << " ("
+            << yysym.location << ": ";
+        YY_USE (yykind);
+        yyo << ')';
+      }
+  }
+#endif
+
+  void
+  Parser::yypush_ (const char* m, YY_MOVE_REF (stack_symbol_type) sym)
+  {
+    if (m)
+      YY_SYMBOL_PRINT (m, sym);
+    yystack_.push (YY_MOVE (sym));
+  }
+
+  void
+  Parser::yypush_ (const char* m, state_type s, YY_MOVE_REF (symbol_type) sym)
+  {
+#if 201103L <= YY_CPLUSPLUS
+    yypush_ (m, stack_symbol_type (s, std::move (sym)));
+#else
+    stack_symbol_type ss (s, sym);
+    yypush_ (m, ss);
+#endif
+  }
+
+  void
+  Parser::yypop_ (int n) YY_NOEXCEPT
+  {
+    yystack_.pop (n);
+  }
+
+#if YYDEBUG
+  std::ostream&
+  Parser::debug_stream () const
+  {
+    return *yycdebug_;
+  }
+
+  void
+  Parser::set_debug_stream (std::ostream& o)
+  {
+    yycdebug_ = &o;
+  }
+
+
+  Parser::debug_level_type
+  Parser::debug_level () const
+  {
+    return yydebug_;
+  }
+
+  void
+  Parser::set_debug_level (debug_level_type l)
+  {
+    yydebug_ = l;
+  }
+#endif // YYDEBUG
+
+  Parser::state_type
+  Parser::yy_lr_goto_state_ (state_type yystate, int yysym)
+  {
+    int yyr = yypgoto_[yysym - YYNTOKENS] + yystate;
+    if (0 <= yyr && yyr <= yylast_ && yycheck_[yyr] == yystate)
+      return yytable_[yyr];
+    else
+      return yydefgoto_[yysym - YYNTOKENS];
+  }
+
+  bool
+  Parser::yy_pact_value_is_default_ (int yyvalue) YY_NOEXCEPT
+  {
+    return yyvalue == yypact_ninf_;
+  }
+
+  bool
+  Parser::yy_table_value_is_error_ (int yyvalue) YY_NOEXCEPT
+  {
+    return yyvalue == yytable_ninf_;
+  }
+
+  int
+  Parser::operator() ()
+  {
+    return parse ();
+  }
+
+  int
+  Parser::parse ()
+  {
+    int yyn;
+    /// Length of the RHS of the rule being reduced.
+    int yylen = 0;
+
+    // Error handling.
+    int yynerrs_ = 0;
+    int yyerrstatus_ = 0;
+
+    /// The lookahead symbol.
+    symbol_type yyla;
+
+    /// The locations where the error started and ended.
+    stack_symbol_type yyerror_range[3];
+
+    /// The return value of parse ().
+    int yyresult;
+
+#if YY_EXCEPTIONS
+    try
+#endif // YY_EXCEPTIONS
+      {
+    YYCDEBUG << "Starting parse\n";
 
-  switch (yytype)
-    {
 
-      default:
-        break;
-    }
-}
+    /* Initialize the stack.  The initial state will be set in
+       yynewstate, since the latter expects the semantical and the
+       location values to have been already stored, initialize these
+       stacks with a primary value.  */
+    yystack_.clear ();
+    yypush_ (YY_NULLPTR, 0, YY_MOVE (yyla));
 
+  /*-----------------------------------------------.
+  | yynewstate -- push a new symbol on the stack.  |
+  `-----------------------------------------------*/
+  yynewstate:
+    YYCDEBUG << "Entering state " << int (yystack_[0].state) << '\n';
+    YY_STACK_PRINT ();
 
+    // Accept?
+    if (yystack_[0].state == yyfinal_)
+      YYACCEPT;
 
+    goto yybackup;
 
-/* The lookahead symbol.  */
-int yychar;
 
+  /*-----------.
+  | yybackup.  |
+  `-----------*/
+  yybackup:
+    // Try to take a decision without lookahead.
+    yyn = yypact_[+yystack_[0].state];
+    if (yy_pact_value_is_default_ (yyn))
+      goto yydefault;
 
-#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END
-#endif
-#ifndef YY_INITIAL_VALUE
-# define YY_INITIAL_VALUE(Value) /* Nothing. */
-#endif
+    // Read a lookahead token.
+    if (yyla.empty ())
+      {
+        YYCDEBUG << "Reading a token\n";
+#if YY_EXCEPTIONS
+        try
+#endif // YY_EXCEPTIONS
+          {
+            yyla.kind_ = yytranslate_ (yylex (&yyla.value, &yyla.location, scanner));
+          }
+#if YY_EXCEPTIONS
+        catch (const syntax_error& yyexc)
+          {
+            YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
+            error (yyexc);
+            goto yyerrlab1;
+          }
+#endif // YY_EXCEPTIONS
+      }
+    YY_SYMBOL_PRINT ("Next token is", yyla);
 
-/* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval YY_INITIAL_VALUE(yyval_default);
+    if (yyla.kind () == symbol_kind::S_YYerror)
+    {
+      // The scanner already issued an error message, process directly
+      // to error recovery.  But do not keep the error token as
+      // lookahead, it is too special and may lead us to an endless
+      // loop in error recovery. */
+      yyla.kind_ = symbol_kind::S_YYUNDEF;
+      goto yyerrlab1;
+    }
 
-/* Location data for the lookahead symbol.  */
-YYLTYPE yylloc
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
-  = { 1, 1, 1, 1 }
-# endif
-;
+    /* If the proper action on seeing token YYLA.TYPE is to reduce or
+       to detect an error, take that action.  */
+    yyn += yyla.kind ();
+    if (yyn < 0 || yylast_ < yyn || yycheck_[yyn] != yyla.kind ())
+      {
+        goto yydefault;
+      }
 
+    // Reduce or error.
+    yyn = yytable_[yyn];
+    if (yyn <= 0)
+      {
+        if (yy_table_value_is_error_ (yyn))
+          goto yyerrlab;
+        yyn = -yyn;
+        goto yyreduce;
+      }
 
-/* Number of syntax errors so far.  */
-int yynerrs;
+    // Count tokens shifted since error; after three, turn off error status.
+    if (yyerrstatus_)
+      --yyerrstatus_;
 
+    // Shift the lookahead token.
+    yypush_ ("Shifting", state_type (yyn), YY_MOVE (yyla));
+    goto yynewstate;
 
-/*----------.
-| yyparse.  |
-`----------*/
 
-#ifdef YYPARSE_PARAM
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void *YYPARSE_PARAM)
-#else
-int
-yyparse (YYPARSE_PARAM)
-    void *YYPARSE_PARAM;
-#endif
-#else /* ! YYPARSE_PARAM */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void)
-#else
-int
-yyparse ()
+  /*-----------------------------------------------------------.
+  | yydefault -- do the default action for the current state.  |
+  `-----------------------------------------------------------*/
+  yydefault:
+    yyn = yydefact_[+yystack_[0].state];
+    if (yyn == 0)
+      goto yyerrlab;
+    goto yyreduce;
 
-#endif
-#endif
-{
-    int yystate;
-    /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
-
-    /* The stacks and their tools:
-       `yyss': related to states.
-       `yyvs': related to semantic values.
-       `yyls': related to locations.
-
-       Refer to the stacks through separate pointers, to allow yyoverflow
-       to reallocate them elsewhere.  */
-
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
-
-    /* The semantic value stack.  */
-    YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
-
-    /* The location stack.  */
-    YYLTYPE yylsa[YYINITDEPTH];
-    YYLTYPE *yyls;
-    YYLTYPE *yylsp;
-
-    /* The locations where the error started and ended.  */
-    YYLTYPE yyerror_range[3];
-
-    YYSIZE_T yystacksize;
-
-  int yyn;
-  int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
-  /* The variables used to return semantic value and location from the
-     action routines.  */
-  YYSTYPE yyval;
-  YYLTYPE yyloc;
-
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
 
-#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
+  /*-----------------------------.
+  | yyreduce -- do a reduction.  |
+  `-----------------------------*/
+  yyreduce:
+    yylen = yyr2_[yyn];
+    {
+      stack_symbol_type yylhs;
+      yylhs.state = yy_lr_goto_state_ (yystack_[yylen].state, yyr1_[yyn]);
+      /* Variants are always initialized to an empty instance of the
+         correct type. The default '$$ = $1' action is NOT applied
+         when using variants.  */
+      switch (yyr1_[yyn])
+    {
+      case symbol_kind::S_assign_stmt: // assign_stmt
+        yylhs.value.emplace< AssignStmt * > ();
+        break;
 
-  /* The number of symbols on the RHS of the reduced rule.
-     Keep to zero when no symbol should be popped.  */
-  int yylen = 0;
+      case symbol_kind::S_outer_block: // outer_block
+      case symbol_kind::S_block: // block
+        yylhs.value.emplace< Block * > ();
+        break;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yylsp = yyls = yylsa;
-  yystacksize = YYINITDEPTH;
+      case symbol_kind::S_boolexp: // boolexp
+        yylhs.value.emplace< BoolExp * > ();
+        break;
 
-  YYDPRINTF ((stderr, "Starting parse\n"));
+      case symbol_kind::S_break_stmt: // break_stmt
+        yylhs.value.emplace< BreakStmt * > ();
+        break;
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
-  yychar = YYEMPTY; /* Cause a token to be read.  */
-  yylsp[0] = yylloc;
-  goto yysetstate;
+      case symbol_kind::S_caselist: // caselist
+      case symbol_kind::S_case: // case
+        yylhs.value.emplace< Case * > ();
+        break;
 
-/*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
-`------------------------------------------------------------*/
- yynewstate:
-  /* In all cases, when you get here, the value and location stacks
-     have just been pushed.  So pushing a state here evens the stacks.  */
-  yyssp++;
+      case symbol_kind::S_expression: // expression
+        yylhs.value.emplace< Exp * > ();
+        break;
 
- yysetstate:
-  *yyssp = yystate;
+      case symbol_kind::S_for_stmt: // for_stmt
+        yylhs.value.emplace< ForStmt * > ();
+        break;
 
-  if (yyss + yystacksize - 1 <= yyssp)
-    {
-      /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      case symbol_kind::S_if_stmt: // if_stmt
+        yylhs.value.emplace< IfStmt * > ();
+        break;
 
-#ifdef yyoverflow
-      {
-	/* Give user a chance to reallocate the stack.  Use copies of
-	   these so that the &'s don't force the real ones into
-	   memory.  */
-	YYSTYPE *yyvs1 = yyvs;
-	yytype_int16 *yyss1 = yyss;
-	YYLTYPE *yyls1 = yyls;
-
-	/* Each stack pointer address is followed by the size of the
-	   data in use in that stack, in bytes.  This used to be a
-	   conditional around just the two extra args, but that might
-	   be undefined if yyoverflow is a macro.  */
-	yyoverflow (YY_("memory exhausted"),
-		    &yyss1, yysize * sizeof (*yyssp),
-		    &yyvs1, yysize * sizeof (*yyvsp),
-		    &yyls1, yysize * sizeof (*yylsp),
-		    &yystacksize);
-
-	yyls = yyls1;
-	yyss = yyss1;
-	yyvs = yyvs1;
-      }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
-      /* Extend the stack our own way.  */
-      if (YYMAXDEPTH <= yystacksize)
-	goto yyexhaustedlab;
-      yystacksize *= 2;
-      if (YYMAXDEPTH < yystacksize)
-	yystacksize = YYMAXDEPTH;
+      case symbol_kind::S_read_stmt: // read_stmt
+        yylhs.value.emplace< ReadStmt * > ();
+        break;
 
-      {
-	yytype_int16 *yyss1 = yyss;
-	union yyalloc *yyptr =
-	  (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
-	if (! yyptr)
-	  goto yyexhaustedlab;
-	YYSTACK_RELOCATE (yyss_alloc, yyss);
-	YYSTACK_RELOCATE (yyvs_alloc, yyvs);
-	YYSTACK_RELOCATE (yyls_alloc, yyls);
-#  undef YYSTACK_RELOCATE
-	if (yyss1 != yyssa)
-	  YYSTACK_FREE (yyss1);
-      }
-# endif
-#endif /* no yyoverflow */
+      case symbol_kind::S_program_stmt: // program_stmt
+      case symbol_kind::S_stmt: // stmt
+      case symbol_kind::S_nonblock_stmt: // nonblock_stmt
+        yylhs.value.emplace< Stmt * > ();
+        break;
 
-      yyssp = yyss + yysize - 1;
-      yyvsp = yyvs + yysize - 1;
-      yylsp = yyls + yysize - 1;
+      case symbol_kind::S_outer_stmtlist: // outer_stmtlist
+      case symbol_kind::S_stmtlist: // stmtlist
+        yylhs.value.emplace< StmtList > ();
+        break;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-		  (unsigned long int) yystacksize));
+      case symbol_kind::S_switch_stmt: // switch_stmt
+        yylhs.value.emplace< SwitchStmt * > ();
+        break;
 
-      if (yyss + yystacksize - 1 <= yyssp)
-	YYABORT;
-    }
+      case symbol_kind::S_while_stmt: // while_stmt
+        yylhs.value.emplace< WhileStmt * > ();
+        break;
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+      case symbol_kind::S_write_stmt: // write_stmt
+        yylhs.value.emplace< WriteStmt * > ();
+        break;
 
-  if (yystate == YYFINAL)
-    YYACCEPT;
+      case symbol_kind::S_optional_break: // optional_break
+        yylhs.value.emplace< bool > ();
+        break;
 
-  goto yybackup;
+      case symbol_kind::S_ID: // ID
+        yylhs.value.emplace< const char * > ();
+        break;
 
-/*-----------.
-| yybackup.  |
-`-----------*/
-yybackup:
+      case symbol_kind::S_FLOAT_NUM: // FLOAT_NUM
+        yylhs.value.emplace< double > ();
+        break;
 
-  /* Do appropriate processing given the current state.  Read a
-     lookahead token if we need one and don't already have one.  */
+      case symbol_kind::S_ADDOP: // ADDOP
+      case symbol_kind::S_MULOP: // MULOP
+      case symbol_kind::S_RELOP: // RELOP
+      case symbol_kind::S_POWER: // POWER
+        yylhs.value.emplace< enum op > ();
+        break;
 
-  /* First try to decide what to do without reference to lookahead token.  */
-  yyn = yypact[yystate];
-  if (yypact_value_is_default (yyn))
-    goto yydefault;
+      case symbol_kind::S_INT_NUM: // INT_NUM
+        yylhs.value.emplace< int > ();
+        break;
 
-  /* Not known => get a lookahead token if don't already have one.  */
+      case symbol_kind::S_type: // type
+        yylhs.value.emplace< myType > ();
+        break;
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
-  if (yychar == YYEMPTY)
-    {
-      YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = YYLEX;
+      default:
+        break;
     }
 
-  if (yychar <= YYEOF)
-    {
-      yychar = yytoken = YYEOF;
-      YYDPRINTF ((stderr, "Now at end of input.\n"));
-    }
-  else
-    {
-      yytoken = YYTRANSLATE (yychar);
-      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
-    }
 
-  /* If the proper action on seeing token YYTOKEN is to reduce or to
-     detect an error, take that action.  */
-  yyn += yytoken;
-  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
-    goto yydefault;
-  yyn = yytable[yyn];
-  if (yyn <= 0)
-    {
-      if (yytable_value_is_error (yyn))
-        goto yyerrlab;
-      yyn = -yyn;
-      goto yyreduce;
-    }
+      // Default location.
+      {
+        stack_type::slice range (yystack_, yylen);
+        YYLLOC_DEFAULT (yylhs.location, range, yylen);
+        yyerror_range[1].location = yylhs.location;
+      }
 
-  /* Count tokens shifted since error; after three, turn off error
-     status.  */
-  if (yyerrstatus)
-    yyerrstatus--;
-
-  /* Shift the lookahead token.  */
-  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
-  yystate = yyn;
-  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  *++yyvsp = yylval;
-  YY_IGNORE_MAYBE_UNINITIALIZED_END
-  *++yylsp = yylloc;
-  goto yynewstate;
-
-
-/*-----------------------------------------------------------.
-| yydefault -- do the default action for the current state.  |
-`-----------------------------------------------------------*/
-yydefault:
-  yyn = yydefact[yystate];
-  if (yyn == 0)
-    goto yyerrlab;
-  goto yyreduce;
-
-
-/*-----------------------------.
-| yyreduce -- Do a reduction.  |
-`-----------------------------*/
-yyreduce:
-  /* yyn is the number of a rule to reduce with.  */
-  yylen = yyr2[yyn];
-
-  /* If YYLEN is nonzero, implement the default value of the action:
-     `$$ = $1'.
-
-     Otherwise, the following line sets YYVAL to garbage.
-     This behavior is undocumented and Bison
-     users should not rely upon it.  Assigning to YYVAL
-     unconditionally makes the parser a bit smaller, and it avoids a
-     GCC warning that YYVAL may be used uninitialized.  */
-  yyval = yyvsp[1-yylen];
-
-  /* Default location.  */
-  YYLLOC_DEFAULT (yyloc, (yylsp - yylen), yylen);
-  YY_REDUCE_PRINT (yyn);
-  switch (yyn)
-    {
-        case 2:
-/* Line 1792 of yacc.c  */
-#line 86 "ast.y"
-    { 
-                      if (errors == 0) { /* for debugging: generate code even if errors found */
-					     (yyvsp[(2) - (2)].stmt)->genStmt (); emit ("halt"); 
+      // Perform the reduction.
+      YY_REDUCE_PRINT (yyn);
+#if YY_EXCEPTIONS
+      try
+#endif // YY_EXCEPTIONS
+        {
+          switch (yyn)
+            {
+  case 2: // program: declarations program_stmt
+#line 126 "ast.y"
+                                       { 
+                      if (ctx->errors == 0) { /* for debugging: generate code even if errors found */
+					     ctx->generate (yystack_[0].value.as < Stmt * > ()); emit (Instr (IR_HALT)); ctx->finishCode (); 
 						 } 
 				     }
+#line 1288 "ast.tab.c"
     break;
 
-  case 3:
-/* Line 1792 of yacc.c  */
-#line 92 "ast.y"
-    { if (!(putSymbol ((yyvsp[(3) - (4)].name), (yyvsp[(2) - (4)]._type)))) 
+  case 3: // declarations: declarations type ID ';'
+#line 132 "ast.y"
+                                       { if (!(putSymbol (yystack_[1].value.as < const char * > (), yystack_[2].value.as < myType > ()))) 
                                              errorMsg ("line %d: redeclaration of %s\n",
-											            (yylsp[(3) - (4)]).first_line, (yyvsp[(3) - (4)].name)); }
+											            yystack_[1].location.first_line, yystack_[1].value.as < const char * > ()); }
+#line 1296 "ast.tab.c"
     break;
 
-  case 4:
-/* Line 1792 of yacc.c  */
-#line 95 "ast.y"
-    { if (!(putSymbol ((yyvsp[(3) - (6)].name), (yyvsp[(5) - (6)].exp)->_type))) 
+  case 4: // declarations: declarations AUTO ID '=' expression ';'
+#line 135 "ast.y"
+                                                       { if (!(putSymbol (yystack_[3].value.as < const char * > (), yystack_[1].value.as < Exp * > ()->_type))) 
 															errorMsg ("line %d: redeclaration of %s\n",
-															(yylsp[(3) - (6)]).first_line, (yyvsp[(3) - (6)].name));
-															AssignStmt (new IdNode ((yyvsp[(3) - (6)].name), (yylsp[(3) - (6)]).first_line),(yyvsp[(5) - (6)].exp), (yylsp[(2) - (6)]).first_line).genStmt();
+															yystack_[3].location.first_line, yystack_[3].value.as < const char * > ());
+															AssignStmt (new IdNode (yystack_[3].value.as < const char * > (), yystack_[3].location.first_line),yystack_[1].value.as < Exp * > (), yystack_[4].location.first_line).genStmt();
 														}
+#line 1306 "ast.tab.c"
     break;
 
-  case 5:
-/* Line 1792 of yacc.c  */
-#line 100 "ast.y"
-    { 	if (!(putSymbol ((yyvsp[(3) - (6)].name), (yyvsp[(2) - (6)]._type)))) 
-																errorMsg ("line %d: redeclaration of %s\n",(yylsp[(3) - (6)]).first_line, (yyvsp[(3) - (6)].name)); 
+  case 5: // declarations: declarations type ID '=' expression ';'
+#line 140 "ast.y"
+                                                                    { 	if (!(putSymbol (yystack_[3].value.as < const char * > (), yystack_[4].value.as < myType > ()))) 
+																errorMsg ("line %d: redeclaration of %s\n",yystack_[3].location.first_line, yystack_[3].value.as < const char * > ()); 
 															else
-																AssignStmt (new IdNode ((yyvsp[(3) - (6)].name), (yylsp[(3) - (6)]).first_line),(yyvsp[(5) - (6)].exp), (yylsp[(2) - (6)]).first_line).genStmt();
+																AssignStmt (new IdNode (yystack_[3].value.as < const char * > (), yystack_[3].location.first_line),yystack_[1].value.as < Exp * > (), yystack_[4].location.first_line).genStmt();
 														}
+#line 1316 "ast.tab.c"
     break;
 
-  case 7:
-/* Line 1792 of yacc.c  */
-#line 107 "ast.y"
-    { (yyval._type) = _INT; }
+  case 7: // type: INT
+#line 147 "ast.y"
+          { yylhs.value.as < myType > () = _INT; }
+#line 1322 "ast.tab.c"
     break;
 
-  case 8:
-/* Line 1792 of yacc.c  */
-#line 108 "ast.y"
-    { (yyval._type) = _FLOAT; }
+  case 8: // type: FLOAT
+#line 148 "ast.y"
+            { yylhs.value.as < myType > () = _FLOAT; }
+#line 1328 "ast.tab.c"
     break;
 
-  case 9:
-/* Line 1792 of yacc.c  */
-#line 110 "ast.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].assign_stmt); }
+  case 9: // program_stmt: nonblock_stmt
+#line 152 "ast.y"
+                             { yylhs.value.as < Stmt * > () = yystack_[0].value.as < Stmt * > (); }
+#line 1334 "ast.tab.c"
     break;
 
-  case 10:
-/* Line 1792 of yacc.c  */
-#line 111 "ast.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].read_stmt); }
+  case 10: // program_stmt: outer_block
+#line 153 "ast.y"
+                             { yylhs.value.as < Stmt * > () = yystack_[0].value.as < Block * > (); }
+#line 1340 "ast.tab.c"
     break;
 
-  case 11:
-/* Line 1792 of yacc.c  */
-#line 112 "ast.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].write_stmt); }
+  case 11: // outer_block: '{' outer_stmtlist '}'
+#line 155 "ast.y"
+                                    { yylhs.value.as < Block * > () = new Block (yystack_[1].value.as < StmtList > ().first); }
+#line 1346 "ast.tab.c"
     break;
 
-  case 12:
-/* Line 1792 of yacc.c  */
-#line 113 "ast.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].while_stmt); }
+  case 12: // outer_stmtlist: outer_stmtlist stmt
+#line 157 "ast.y"
+                                    { if (ctx->streamStatement (yystack_[0].value.as < Stmt * > ()))
+                                          yylhs.value.as < StmtList > () = yystack_[1].value.as < StmtList > (); // its code was generated. It is not kept
+									  else
+									      yylhs.value.as < StmtList > () = append (yystack_[1].value.as < StmtList > (), yystack_[0].value.as < Stmt * > ());
+									}
+#line 1356 "ast.tab.c"
     break;
 
-  case 13:
-/* Line 1792 of yacc.c  */
-#line 114 "ast.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].if_stmt); }
+  case 13: // outer_stmtlist: %empty
+#line 162 "ast.y"
+                             { yylhs.value.as < StmtList > ().first = yylhs.value.as < StmtList > ().last = NULL; }
+#line 1362 "ast.tab.c"
     break;
 
-  case 14:
-/* Line 1792 of yacc.c  */
-#line 115 "ast.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].for_stmt); }
+  case 14: // stmt: nonblock_stmt
+#line 164 "ast.y"
+                            { yylhs.value.as < Stmt * > () = yystack_[0].value.as < Stmt * > (); }
+#line 1368 "ast.tab.c"
     break;
 
-  case 15:
-/* Line 1792 of yacc.c  */
-#line 116 "ast.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].switch_stmt); }
+  case 15: // stmt: block
+#line 165 "ast.y"
+                                        { yylhs.value.as < Stmt * > () = yystack_[0].value.as < Block * > (); }
+#line 1374 "ast.tab.c"
     break;
 
-  case 16:
-/* Line 1792 of yacc.c  */
-#line 117 "ast.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].break_stmt); }
+  case 16: // nonblock_stmt: assign_stmt
+#line 167 "ast.y"
+                             { yylhs.value.as < Stmt * > () = yystack_[0].value.as < AssignStmt * > (); }
+#line 1380 "ast.tab.c"
     break;
 
-  case 17:
-/* Line 1792 of yacc.c  */
-#line 118 "ast.y"
-    { (yyval.stmt) = (yyvsp[(1) - (1)].block); }
+  case 17: // nonblock_stmt: read_stmt
+#line 168 "ast.y"
+                          { yylhs.value.as < Stmt * > () = yystack_[0].value.as < ReadStmt * > (); }
+#line 1386 "ast.tab.c"
     break;
 
-  case 18:
-/* Line 1792 of yacc.c  */
-#line 120 "ast.y"
-    { 
-                (yyval.read_stmt) = new ReadStmt (new IdNode ((yyvsp[(3) - (5)].name), (yylsp[(3) - (5)]).first_line), (yylsp[(1) - (5)]).first_line); }
+  case 18: // nonblock_stmt: write_stmt
+#line 169 "ast.y"
+                          { yylhs.value.as < Stmt * > () = yystack_[0].value.as < WriteStmt * > (); }
+#line 1392 "ast.tab.c"
     break;
 
-  case 19:
-/* Line 1792 of yacc.c  */
-#line 123 "ast.y"
-    { (yyval.write_stmt) = new WriteStmt ((yyvsp[(3) - (5)].exp), (yylsp[(1) - (5)]).first_line); }
+  case 19: // nonblock_stmt: while_stmt
+#line 170 "ast.y"
+                                      { yylhs.value.as < Stmt * > () = yystack_[0].value.as < WhileStmt * > (); }
+#line 1398 "ast.tab.c"
     break;
 
-  case 20:
-/* Line 1792 of yacc.c  */
-#line 125 "ast.y"
-    { (yyval.assign_stmt) = new AssignStmt (new IdNode ((yyvsp[(1) - (4)].name), (yylsp[(1) - (4)]).first_line),
-                                                            (yyvsp[(3) - (4)].exp), (yylsp[(2) - (4)]).first_line); }
+  case 20: // nonblock_stmt: if_stmt
+#line 171 "ast.y"
+                              { yylhs.value.as < Stmt * > () = yystack_[0].value.as < IfStmt * > (); }
+#line 1404 "ast.tab.c"
     break;
 
-  case 21:
-/* Line 1792 of yacc.c  */
-#line 128 "ast.y"
-    { (yyval.while_stmt) = new WhileStmt ((yyvsp[(3) - (5)].boolexp), (yyvsp[(5) - (5)].stmt)); }
+  case 21: // nonblock_stmt: for_stmt
+#line 172 "ast.y"
+                                      { yylhs.value.as < Stmt * > () = yystack_[0].value.as < ForStmt * > (); }
+#line 1410 "ast.tab.c"
     break;
 
-  case 22:
-/* Line 1792 of yacc.c  */
-#line 130 "ast.y"
-    { (yyval.if_stmt) = new IfStmt ((yyvsp[(3) - (7)].boolexp), (yyvsp[(5) - (7)].stmt), (yyvsp[(7) - (7)].stmt)); }
+  case 22: // nonblock_stmt: switch_stmt
+#line 173 "ast.y"
+                                      { yylhs.value.as < Stmt * > () = yystack_[0].value.as < SwitchStmt * > (); }
+#line 1416 "ast.tab.c"
     break;
 
-  case 23:
-/* Line 1792 of yacc.c  */
-#line 132 "ast.y"
-    { (yyval.for_stmt) = new ForStmt ((yyvsp[(3) - (8)].assign_stmt), (yyvsp[(4) - (8)].boolexp), (yyvsp[(8) - (8)].stmt), (yyvsp[(6) - (8)].assign_stmt)); }
+  case 23: // nonblock_stmt: break_stmt
+#line 174 "ast.y"
+                                      { yylhs.value.as < Stmt * > () = yystack_[0].value.as < BreakStmt * > (); }
+#line 1422 "ast.tab.c"
     break;
 
-  case 24:
-/* Line 1792 of yacc.c  */
-#line 135 "ast.y"
-    { (yyval.switch_stmt) = new SwitchStmt ((yyvsp[(3) - (10)].exp), (yyvsp[(6) - (10)].caselist), (yyvsp[(9) - (10)].stmt), (yylsp[(1) - (10)]).first_line); }
+  case 24: // read_stmt: READ '(' ID ')' ';'
+#line 176 "ast.y"
+                                 { 
+                yylhs.value.as < ReadStmt * > () = new ReadStmt (new IdNode (yystack_[2].value.as < const char * > (), yystack_[2].location.first_line), yystack_[4].location.first_line); }
+#line 1429 "ast.tab.c"
     break;
 
-  case 25:
-/* Line 1792 of yacc.c  */
-#line 139 "ast.y"
-    { (yyvsp[(1) - (2)].mycase)->_next = (yyvsp[(2) - (2)].caselist);   
-                           (yyval.caselist) = (yyvsp[(1) - (2)].mycase); }
+  case 25: // write_stmt: WRITE '(' expression ')' ';'
+#line 179 "ast.y"
+                                           { yylhs.value.as < WriteStmt * > () = new WriteStmt (yystack_[2].value.as < Exp * > (), yystack_[4].location.first_line); }
+#line 1435 "ast.tab.c"
     break;
 
-  case 26:
-/* Line 1792 of yacc.c  */
-#line 143 "ast.y"
-    { (yyval.caselist) = (yyvsp[(1) - (1)].mycase);}
+  case 26: // assign_stmt: ID '=' expression ';'
+#line 181 "ast.y"
+                                     { yylhs.value.as < AssignStmt * > () = new AssignStmt (new IdNode (yystack_[3].value.as < const char * > (), yystack_[3].location.first_line),
+                                                            yystack_[1].value.as < Exp * > (), yystack_[2].location.first_line); }
+#line 1442 "ast.tab.c"
     break;
 
-  case 27:
-/* Line 1792 of yacc.c  */
-#line 145 "ast.y"
-    { (yyval.mycase) = new Case ((yyvsp[(2) - (5)].ival), (yyvsp[(4) - (5)].stmt), (yyvsp[(5) - (5)].hasBreak)); }
+  case 27: // while_stmt: WHILE '(' boolexp ')' stmt
+#line 184 "ast.y"
+                                         { yylhs.value.as < WhileStmt * > () = new WhileStmt (yystack_[2].value.as < BoolExp * > (), yystack_[0].value.as < Stmt * > ()); }
+#line 1448 "ast.tab.c"
     break;
 
-  case 28:
-/* Line 1792 of yacc.c  */
-#line 147 "ast.y"
-    { (yyval.hasBreak) = true; }
+  case 28: // if_stmt: IF '(' boolexp ')' stmt ELSE stmt
+#line 186 "ast.y"
+                                                { yylhs.value.as < IfStmt * > () = new IfStmt (yystack_[4].value.as < BoolExp * > (), yystack_[2].value.as < Stmt * > (), yystack_[0].value.as < Stmt * > ()); }
+#line 1454 "ast.tab.c"
     break;
 
-  case 29:
-/* Line 1792 of yacc.c  */
-#line 147 "ast.y"
-    { (yyval.hasBreak) = false; }
+  case 29: // for_stmt: FOR '(' assign_stmt boolexp ';' assign_stmt ')' stmt
+#line 188 "ast.y"
+                                                                   { yylhs.value.as < ForStmt * > () = new ForStmt (yystack_[5].value.as < AssignStmt * > (), yystack_[4].value.as < BoolExp * > (), yystack_[0].value.as < Stmt * > (), yystack_[2].value.as < AssignStmt * > ()); }
+#line 1460 "ast.tab.c"
     break;
 
-  case 30:
-/* Line 1792 of yacc.c  */
-#line 149 "ast.y"
-    { (yyval.break_stmt) = new BreakStmt ((yylsp[(1) - (2)]).first_line); }
+  case 30: // switch_stmt: SWITCH '(' expression ')' '{' caselist DEFAULT ':' stmt '}'
+#line 191 "ast.y"
+                                                                          { yylhs.value.as < SwitchStmt * > () = new SwitchStmt (yystack_[7].value.as < Exp * > (), yystack_[4].value.as < Case * > (), yystack_[1].value.as < Stmt * > (), yystack_[9].location.first_line); }
+#line 1466 "ast.tab.c"
     break;
 
-  case 31:
-/* Line 1792 of yacc.c  */
-#line 151 "ast.y"
-    { (yyval.block) = new Block ((yyvsp[(2) - (3)].stmtlist)); }
+  case 31: // caselist: case caselist
+#line 195 "ast.y"
+                         { yystack_[1].value.as < Case * > ()->_next = yystack_[0].value.as < Case * > ();   
+                           yylhs.value.as < Case * > () = yystack_[1].value.as < Case * > (); }
+#line 1473 "ast.tab.c"
     break;
 
-  case 32:
-/* Line 1792 of yacc.c  */
-#line 159 "ast.y"
-    {  (yyvsp[(1) - (2)].stmt)->_next = (yyvsp[(2) - (2)].stmtlist);  // also works when $2 is NULL
-                            (yyval.stmtlist) = (yyvsp[(1) - (2)].stmt);  
-						 }
+  case 32: // caselist: case
+#line 199 "ast.y"
+                 { yylhs.value.as < Case * > () = yystack_[0].value.as < Case * > ();}
+#line 1479 "ast.tab.c"
     break;
 
-  case 33:
-/* Line 1792 of yacc.c  */
-#line 162 "ast.y"
-    { (yyval.stmtlist) = NULL; }
+  case 33: // case: CASE INT_NUM ':' stmt optional_break
+#line 201 "ast.y"
+                                            { yylhs.value.as < Case * > () = new Case (yystack_[3].value.as < int > (), yystack_[1].value.as < Stmt * > (), yystack_[0].value.as < bool > ()); }
+#line 1485 "ast.tab.c"
     break;
 
-  case 34:
-/* Line 1792 of yacc.c  */
-#line 164 "ast.y"
-    {
-                  (yyval.exp) = new BinaryOp ((yyvsp[(2) - (3)].op), (yyvsp[(1) - (3)].exp), (yyvsp[(3) - (3)].exp), (yylsp[(2) - (3)]).first_line); }
+  case 34: // optional_break: BREAK ';'
+#line 203 "ast.y"
+                         { yylhs.value.as < bool > () = true; }
+#line 1491 "ast.tab.c"
     break;
 
-  case 35:
-/* Line 1792 of yacc.c  */
-#line 166 "ast.y"
-    {
-                  (yyval.exp) = new BinaryOp ((yyvsp[(2) - (3)].op), (yyvsp[(1) - (3)].exp), (yyvsp[(3) - (3)].exp), (yylsp[(2) - (3)]).first_line); }
+  case 35: // optional_break: %empty
+#line 203 "ast.y"
+                                                      { yylhs.value.as < bool > () = false; }
+#line 1497 "ast.tab.c"
     break;
 
-  case 36:
-/* Line 1792 of yacc.c  */
-#line 168 "ast.y"
-    {
-                  (yyval.exp) = new BinaryOp ((yyvsp[(2) - (3)].op), (yyvsp[(1) - (3)].exp), (yyvsp[(3) - (3)].exp), (yylsp[(2) - (3)]).first_line); }
+  case 36: // break_stmt: BREAK ';'
+#line 205 "ast.y"
+                         { yylhs.value.as < BreakStmt * > () = new BreakStmt (yystack_[1].location.first_line); }
+#line 1503 "ast.tab.c"
     break;
 
-  case 37:
-/* Line 1792 of yacc.c  */
-#line 171 "ast.y"
-    { (yyval.exp) = (yyvsp[(2) - (3)].exp); }
+  case 37: // block: '{' stmtlist '}'
+#line 207 "ast.y"
+                        { yylhs.value.as < Block * > () = new Block (yystack_[1].value.as < StmtList > ().first); }
+#line 1509 "ast.tab.c"
     break;
 
-  case 38:
-/* Line 1792 of yacc.c  */
-#line 172 "ast.y"
-    { (yyval.exp) = new IdNode ((yyvsp[(1) - (1)].name), (yylsp[(1) - (1)]).first_line);}
+  case 38: // stmtlist: stmtlist stmt
+#line 213 "ast.y"
+                         { yylhs.value.as < StmtList > () = append (yystack_[1].value.as < StmtList > (), yystack_[0].value.as < Stmt * > ()); }
+#line 1515 "ast.tab.c"
     break;
 
-  case 39:
-/* Line 1792 of yacc.c  */
-#line 173 "ast.y"
-    { (yyval.exp) = new NumNode ((yyvsp[(1) - (1)].ival)); }
+  case 39: // stmtlist: %empty
+#line 214 "ast.y"
+                       { yylhs.value.as < StmtList > ().first = yylhs.value.as < StmtList > ().last = NULL; }
+#line 1521 "ast.tab.c"
     break;
 
-  case 40:
-/* Line 1792 of yacc.c  */
-#line 174 "ast.y"
-    { (yyval.exp) = new NumNode ((yyvsp[(1) - (1)].fval)); }
+  case 40: // expression: expression ADDOP expression
+#line 219 "ast.y"
+                                         {
+                  yylhs.value.as < Exp * > () = FLAT ? ctx->flatAST.binaryOp (yystack_[1].value.as < enum op > (), yystack_[2].value.as < Exp * > (), yystack_[0].value.as < Exp * > ()) : ctx->exps.binaryOp (yystack_[1].value.as < enum op > (), yystack_[2].value.as < Exp * > (), yystack_[0].value.as < Exp * > ()); }
+#line 1528 "ast.tab.c"
     break;
 
-  case 41:
-/* Line 1792 of yacc.c  */
-#line 176 "ast.y"
-    { (yyval.boolexp) = new SimpleBoolExp ((yyvsp[(2) - (3)].op), (yyvsp[(1) - (3)].exp), (yyvsp[(3) - (3)].exp)); }
+  case 41: // expression: expression MULOP expression
+#line 221 "ast.y"
+                                                 {
+                  yylhs.value.as < Exp * > () = FLAT ? ctx->flatAST.binaryOp (yystack_[1].value.as < enum op > (), yystack_[2].value.as < Exp * > (), yystack_[0].value.as < Exp * > ()) : ctx->exps.binaryOp (yystack_[1].value.as < enum op > (), yystack_[2].value.as < Exp * > (), yystack_[0].value.as < Exp * > ()); }
+#line 1535 "ast.tab.c"
     break;
 
-  case 42:
-/* Line 1792 of yacc.c  */
-#line 178 "ast.y"
-    { (yyval.boolexp) = new Or ((yyvsp[(1) - (3)].boolexp), (yyvsp[(3) - (3)].boolexp)); }
+  case 42: // expression: expression POWER expression
+#line 223 "ast.y"
+                                                     {
+                  yylhs.value.as < Exp * > () = FLAT ? ctx->flatAST.binaryOp (yystack_[1].value.as < enum op > (), yystack_[2].value.as < Exp * > (), yystack_[0].value.as < Exp * > ()) : ctx->exps.binaryOp (yystack_[1].value.as < enum op > (), yystack_[2].value.as < Exp * > (), yystack_[0].value.as < Exp * > ()); }
+#line 1542 "ast.tab.c"
     break;
 
-  case 43:
-/* Line 1792 of yacc.c  */
-#line 179 "ast.y"
-    { (yyval.boolexp) = new And ((yyvsp[(1) - (3)].boolexp), (yyvsp[(3) - (3)].boolexp)); }
+  case 43: // expression: '(' expression ')'
+#line 226 "ast.y"
+                               { yylhs.value.as < Exp * > () = yystack_[1].value.as < Exp * > (); }
+#line 1548 "ast.tab.c"
     break;
 
-  case 44:
-/* Line 1792 of yacc.c  */
-#line 180 "ast.y"
-    { (yyval.boolexp) = new Fand ((yyvsp[(1) - (3)].boolexp), (yyvsp[(3) - (3)].boolexp)); }
+  case 44: // expression: ID
+#line 227 "ast.y"
+                        { yylhs.value.as < Exp * > () = FLAT ? ctx->flatAST.id (yystack_[0].value.as < const char * > (), yystack_[0].location.first_line) : ctx->exps.id (yystack_[0].value.as < const char * > (), yystack_[0].location.first_line);}
+#line 1554 "ast.tab.c"
     break;
 
-  case 45:
-/* Line 1792 of yacc.c  */
-#line 181 "ast.y"
-    { (yyval.boolexp) = new Not ((yyvsp[(3) - (4)].boolexp)); }
+  case 45: // expression: INT_NUM
+#line 228 "ast.y"
+                        { yylhs.value.as < Exp * > () = FLAT ? ctx->flatAST.num (yystack_[0].value.as < int > ()) : ctx->exps.num (yystack_[0].value.as < int > ()); }
+#line 1560 "ast.tab.c"
+    break;
+
+  case 46: // expression: FLOAT_NUM
+#line 229 "ast.y"
+                                    { yylhs.value.as < Exp * > () = FLAT ? ctx->flatAST.num (yystack_[0].value.as < double > ()) : ctx->exps.num (yystack_[0].value.as < double > ()); }
+#line 1566 "ast.tab.c"
+    break;
+
+  case 47: // boolexp: expression RELOP expression
+#line 231 "ast.y"
+                                     { yylhs.value.as < BoolExp * > () = FLAT ? ctx->flatAST.simpleBoolExp (yystack_[1].value.as < enum op > (), yystack_[2].value.as < Exp * > (), yystack_[0].value.as < Exp * > (), yystack_[1].location.first_line) : new SimpleBoolExp (yystack_[1].value.as < enum op > (), yystack_[2].value.as < Exp * > (), yystack_[0].value.as < Exp * > (), yystack_[1].location.first_line); }
+#line 1572 "ast.tab.c"
+    break;
+
+  case 48: // boolexp: boolexp OR boolexp
+#line 233 "ast.y"
+                            { yylhs.value.as < BoolExp * > () = FLAT ? ctx->flatAST.orExp (yystack_[2].value.as < BoolExp * > (), yystack_[0].value.as < BoolExp * > ()) : new Or (yystack_[2].value.as < BoolExp * > (), yystack_[0].value.as < BoolExp * > ()); }
+#line 1578 "ast.tab.c"
+    break;
+
+  case 49: // boolexp: boolexp AND boolexp
+#line 234 "ast.y"
+                             { yylhs.value.as < BoolExp * > () = FLAT ? ctx->flatAST.andExp (yystack_[2].value.as < BoolExp * > (), yystack_[0].value.as < BoolExp * > ()) : new And (yystack_[2].value.as < BoolExp * > (), yystack_[0].value.as < BoolExp * > ()); }
+#line 1584 "ast.tab.c"
+    break;
+
+  case 50: // boolexp: boolexp FAND boolexp
+#line 235 "ast.y"
+                                      { yylhs.value.as < BoolExp * > () = FLAT ? ctx->flatAST.fandExp (yystack_[2].value.as < BoolExp * > (), yystack_[0].value.as < BoolExp * > ()) : new Fand (yystack_[2].value.as < BoolExp * > (), yystack_[0].value.as < BoolExp * > ()); }
+#line 1590 "ast.tab.c"
+    break;
+
+  case 51: // boolexp: NOT '(' boolexp ')'
+#line 236 "ast.y"
+                             { yylhs.value.as < BoolExp * > () = FLAT ? ctx->flatAST.notExp (yystack_[1].value.as < BoolExp * > ()) : new Not (yystack_[1].value.as < BoolExp * > ()); }
+#line 1596 "ast.tab.c"
     break;
 
-  case 46:
-/* Line 1792 of yacc.c  */
-#line 182 "ast.y"
-    { (yyval.boolexp) = (yyvsp[(2) - (3)].boolexp);}
+  case 52: // boolexp: '(' boolexp ')'
+#line 237 "ast.y"
+                                  { yylhs.value.as < BoolExp * > () = yystack_[1].value.as < BoolExp * > ();}
+#line 1602 "ast.tab.c"
     break;
 
 
-/* Line 1792 of yacc.c  */
-#line 1925 "ast.tab.c"
-      default: break;
+#line 1606 "ast.tab.c"
+
+            default:
+              break;
+            }
+        }
+#if YY_EXCEPTIONS
+      catch (const syntax_error& yyexc)
+        {
+          YYCDEBUG << "Caught exception: " << yyexc.what() << '\n';
+          error (yyexc);
+          YYERROR;
+        }
+#endif // YY_EXCEPTIONS
+      YY_SYMBOL_PRINT ("-> $$ =", yylhs);
+      yypop_ (yylen);
+      yylen = 0;
+
+      // Shift the result of the reduction.
+      yypush_ (YY_NULLPTR, YY_MOVE (yylhs));
     }
-  /* User semantic actions sometimes alter yychar, and that requires
-     that yytoken be updated with the new translation.  We take the
-     approach of translating immediately before every use of yytoken.
-     One alternative is translating here after every semantic action,
-     but that translation would be missed if the semantic action invokes
-     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
-     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
-     incorrect destructor might then be invoked immediately.  In the
-     case of YYERROR or YYBACKUP, subsequent parser actions might lead
-     to an incorrect destructor call or verbose syntax error message
-     before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
-
-  YYPOPSTACK (yylen);
-  yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
-
-  *++yyvsp = yyval;
-  *++yylsp = yyloc;
-
-  /* Now `shift' the result of the reduction.  Determine what state
-     that goes to, based on the state we popped back to and the rule
-     number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
-
-  goto yynewstate;
-
-
-/*------------------------------------.
-| yyerrlab -- here on detecting error |
-`------------------------------------*/
-yyerrlab:
-  /* Make sure we have latest lookahead translation.  See comments at
-     user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
-  /* If not already recovering from an error, report this error.  */
-  if (!yyerrstatus)
-    {
-      ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
+    goto yynewstate;
+
+
+  /*--------------------------------------.
+  | yyerrlab -- here on detecting error.  |
+  `--------------------------------------*/
+  yyerrlab:
+    // If not already recovering from an error, report this error.
+    if (!yyerrstatus_)
+      {
+        ++yynerrs_;
+        context yyctx (*this, yyla);
+        std::string msg = yysyntax_error_ (yyctx);
+        error (yyla.location, YY_MOVE (msg));
+      }
+
+
+    yyerror_range[1].location = yyla.location;
+    if (yyerrstatus_ == 3)
       {
-        char const *yymsgp = YY_("syntax error");
-        int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
-        if (yysyntax_error_status == 0)
-          yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
+        /* If just tried and failed to reuse lookahead token after an
+           error, discard it.  */
+
+        // Return failure if at end of input.
+        if (yyla.kind () == symbol_kind::S_YYEOF)
+          YYABORT;
+        else if (!yyla.empty ())
           {
-            if (yymsg != yymsgbuf)
-              YYSTACK_FREE (yymsg);
-            yymsg = (char *) YYSTACK_ALLOC (yymsg_alloc);
-            if (!yymsg)
-              {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
-              }
-            else
+            yy_destroy_ ("Error: discarding", yyla);
+            yyla.clear ();
+          }
+      }
+
+    // Else will try to reuse lookahead token after shifting the error token.
+    goto yyerrlab1;
+
+
+  /*---------------------------------------------------.
+  | yyerrorlab -- error raised explicitly by YYERROR.  |
+  `---------------------------------------------------*/
+  yyerrorlab:
+    /* Pacify compilers when the user code never invokes YYERROR and
+       the label yyerrorlab therefore never appears in user code.  */
+    if (false)
+      YYERROR;
+
+    /* Do not reclaim the symbols of the rule whose action triggered
+       this YYERROR.  */
+    yypop_ (yylen);
+    yylen = 0;
+    YY_STACK_PRINT ();
+    goto yyerrlab1;
+
+
+  /*-------------------------------------------------------------.
+  | yyerrlab1 -- common code for both syntax error and YYERROR.  |
+  `-------------------------------------------------------------*/
+  yyerrlab1:
+    yyerrstatus_ = 3;   // Each real token shifted decrements this.
+    // Pop stack until we find a state that shifts the error token.
+    for (;;)
+      {
+        yyn = yypact_[+yystack_[0].state];
+        if (!yy_pact_value_is_default_ (yyn))
+          {
+            yyn += symbol_kind::S_YYerror;
+            if (0 <= yyn && yyn <= yylast_
+                && yycheck_[yyn] == symbol_kind::S_YYerror)
               {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
+                yyn = yytable_[yyn];
+                if (0 < yyn)
+                  break;
               }
           }
-        yyerror (yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
-      }
-# undef YYSYNTAX_ERROR
-#endif
-    }
 
-  yyerror_range[1] = yylloc;
+        // Pop the current state because it cannot handle the error token.
+        if (yystack_.size () == 1)
+          YYABORT;
 
-  if (yyerrstatus == 3)
+        yyerror_range[1].location = yystack_[0].location;
+        yy_destroy_ ("Error: popping", yystack_[0]);
+        yypop_ ();
+        YY_STACK_PRINT ();
+      }
     {
-      /* If just tried and failed to reuse lookahead token after an
-	 error, discard it.  */
-
-      if (yychar <= YYEOF)
-	{
-	  /* Return failure if at end of input.  */
-	  if (yychar == YYEOF)
-	    YYABORT;
-	}
-      else
-	{
-	  yydestruct ("Error: discarding",
-		      yytoken, &yylval, &yylloc);
-	  yychar = YYEMPTY;
-	}
+      stack_symbol_type error_token;
+
+      yyerror_range[2].location = yyla.location;
+      YYLLOC_DEFAULT (error_token.location, yyerror_range, 2);
+
+      // Shift the error token.
+      error_token.state = state_type (yyn);
+      yypush_ ("Shifting", YY_MOVE (error_token));
     }
+    goto yynewstate;
 
-  /* Else will try to reuse lookahead token after shifting the error
-     token.  */
-  goto yyerrlab1;
 
+  /*-------------------------------------.
+  | yyacceptlab -- YYACCEPT comes here.  |
+  `-------------------------------------*/
+  yyacceptlab:
+    yyresult = 0;
+    goto yyreturn;
 
-/*---------------------------------------------------.
-| yyerrorlab -- error raised explicitly by YYERROR.  |
-`---------------------------------------------------*/
-yyerrorlab:
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
+  /*-----------------------------------.
+  | yyabortlab -- YYABORT comes here.  |
+  `-----------------------------------*/
+  yyabortlab:
+    yyresult = 1;
+    goto yyreturn;
 
-  yyerror_range[1] = yylsp[1-yylen];
-  /* Do not reclaim the symbols of the rule which action triggered
-     this YYERROR.  */
-  YYPOPSTACK (yylen);
-  yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
-  yystate = *yyssp;
-  goto yyerrlab1;
 
+  /*-----------------------------------------------------.
+  | yyreturn -- parsing is finished, return the result.  |
+  `-----------------------------------------------------*/
+  yyreturn:
+    if (!yyla.empty ())
+      yy_destroy_ ("Cleanup: discarding lookahead", yyla);
 
-/*-------------------------------------------------------------.
-| yyerrlab1 -- common code for both syntax error and YYERROR.  |
-`-------------------------------------------------------------*/
-yyerrlab1:
-  yyerrstatus = 3;	/* Each real token shifted decrements this.  */
+    /* Do not reclaim the symbols of the rule whose action triggered
+       this YYABORT or YYACCEPT.  */
+    yypop_ (yylen);
+    YY_STACK_PRINT ();
+    while (1 < yystack_.size ())
+      {
+        yy_destroy_ ("Cleanup: popping", yystack_[0]);
+        yypop_ ();
+      }
 
-  for (;;)
-    {
-      yyn = yypact[yystate];
-      if (!yypact_value_is_default (yyn))
-	{
-	  yyn += YYTERROR;
-	  if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
-	    {
-	      yyn = yytable[yyn];
-	      if (0 < yyn)
-		break;
-	    }
-	}
-
-      /* Pop the current state because it cannot handle the error token.  */
-      if (yyssp == yyss)
-	YYABORT;
-
-      yyerror_range[1] = *yylsp;
-      yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp, yylsp);
-      YYPOPSTACK (1);
-      yystate = *yyssp;
-      YY_STACK_PRINT (yyss, yyssp);
-    }
+    return yyresult;
+  }
+#if YY_EXCEPTIONS
+    catch (...)
+      {
+        YYCDEBUG << "Exception caught: cleaning lookahead and stack\n";
+        // Do not try to display the values of the reclaimed symbols,
+        // as their printers might throw an exception.
+        if (!yyla.empty ())
+          yy_destroy_ (YY_NULLPTR, yyla);
 
-  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  *++yyvsp = yylval;
-  YY_IGNORE_MAYBE_UNINITIALIZED_END
-
-  yyerror_range[2] = yylloc;
-  /* Using YYLLOC is tempting, but would change the location of
-     the lookahead.  YYLOC is available though.  */
-  YYLLOC_DEFAULT (yyloc, yyerror_range, 2);
-  *++yylsp = yyloc;
-
-  /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
-
-  yystate = yyn;
-  goto yynewstate;
-
-
-/*-------------------------------------.
-| yyacceptlab -- YYACCEPT comes here.  |
-`-------------------------------------*/
-yyacceptlab:
-  yyresult = 0;
-  goto yyreturn;
-
-/*-----------------------------------.
-| yyabortlab -- YYABORT comes here.  |
-`-----------------------------------*/
-yyabortlab:
-  yyresult = 1;
-  goto yyreturn;
-
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
-yyexhaustedlab:
-  yyerror (YY_("memory exhausted"));
-  yyresult = 2;
-  /* Fall through.  */
-#endif
+        while (1 < yystack_.size ())
+          {
+            yy_destroy_ (YY_NULLPTR, yystack_[0]);
+            yypop_ ();
+          }
+        throw;
+      }
+#endif // YY_EXCEPTIONS
+  }
 
-yyreturn:
-  if (yychar != YYEMPTY)
-    {
-      /* Make sure we have latest lookahead translation.  See comments at
-         user semantic actions for why this is necessary.  */
-      yytoken = YYTRANSLATE (yychar);
-      yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval, &yylloc);
-    }
-  /* Do not reclaim the symbols of the rule which action triggered
-     this YYABORT or YYACCEPT.  */
-  YYPOPSTACK (yylen);
-  YY_STACK_PRINT (yyss, yyssp);
-  while (yyssp != yyss)
-    {
-      yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp, yylsp);
-      YYPOPSTACK (1);
-    }
-#ifndef yyoverflow
-  if (yyss != yyssa)
-    YYSTACK_FREE (yyss);
-#endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
-  /* Make sure YYID is used.  */
-  return YYID (yyresult);
-}
+  void
+  Parser::error (const syntax_error& yyexc)
+  {
+    error (yyexc.location, yyexc.what ());
+  }
 
+  /* Return YYSTR after stripping away unnecessary quotes and
+     backslashes, so that it's suitable for yyerror.  The heuristic is
+     that double-quoting is unnecessary unless the string contains an
+     apostrophe, a comma, or backslash (other than backslash-backslash).
+     YYSTR is taken from yytname.  */
+  std::string
+  Parser::yytnamerr_ (const char *yystr)
+  {
+    if (*yystr == '"')
+      {
+        std::string yyr;
+        char const *yyp = yystr;
+
+        for (;;)
+          switch (*++yyp)
+            {
+            case '\'':
+            case ',':
+              goto do_not_strip_quotes;
+
+            case '\\':
+              if (*++yyp != '\\')
+                goto do_not_strip_quotes;
+              else
+                goto append;
+
+            append:
+            default:
+              yyr += *yyp;
+              break;
+
+            case '"':
+              return yyr;
+            }
+      do_not_strip_quotes: ;
+      }
 
-/* Line 2055 of yacc.c  */
-#line 185 "ast.y"
+    return yystr;
+  }
 
-main (int argc, char **argv)
-{
-  extern FILE *yyin;
-  if (argc != 2) {
-     fprintf (stderr, "Usage: %s <input-file-name>\n", argv[0]);
-	 return 1;
+  std::string
+  Parser::symbol_name (symbol_kind_type yysymbol)
+  {
+    return yytnamerr_ (yytname_[yysymbol]);
   }
-  yyin = fopen (argv [1], "r");
-  if (yyin == NULL) {
-       fprintf (stderr, "failed to open %s\n", argv[1]);
-	   return 2;
+
+
+
+  // Parser::context.
+  Parser::context::context (const Parser& yyparser, const symbol_type& yyla)
+    : yyparser_ (yyparser)
+    , yyla_ (yyla)
+  {}
+
+  int
+  Parser::context::expected_tokens (symbol_kind_type yyarg[], int yyargn) const
+  {
+    // Actual number of expected tokens
+    int yycount = 0;
+
+    const int yyn = yypact_[+yyparser_.yystack_[0].state];
+    if (!yy_pact_value_is_default_ (yyn))
+      {
+        /* Start YYX at -YYN if negative to avoid negative indexes in
+           YYCHECK.  In other words, skip the first -YYN actions for
+           this state because they are default actions.  */
+        const int yyxbegin = yyn < 0 ? -yyn : 0;
+        // Stay within bounds of both yycheck and yytname.
+        const int yychecklim = yylast_ - yyn + 1;
+        const int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+        for (int yyx = yyxbegin; yyx < yyxend; ++yyx)
+          if (yycheck_[yyx + yyn] == yyx && yyx != symbol_kind::S_YYerror
+              && !yy_table_value_is_error_ (yytable_[yyx + yyn]))
+            {
+              if (!yyarg)
+                ++yycount;
+              else if (yycount == yyargn)
+                return 0;
+              else
+                yyarg[yycount++] = YY_CAST (symbol_kind_type, yyx);
+            }
+      }
+
+    if (yyarg && yycount == 0 && 0 < yyargn)
+      yyarg[0] = symbol_kind::S_YYEMPTY;
+    return yycount;
   }
-  
-  errors = 0;
-  yyparse ();
-   
-  if (errors > 0) {
-      fprintf(stderr, "compilation failed\n");
-	  return 3;
+
+
+
+
+
+
+  int
+  Parser::yy_syntax_error_arguments_ (const context& yyctx,
+                                                 symbol_kind_type yyarg[], int yyargn) const
+  {
+    /* There are many possibilities here to consider:
+       - If this state is a consistent state with a default action, then
+         the only way this function was invoked is if the default action
+         is an error action.  In that case, don't check for expected
+         tokens because there are none.
+       - The only way there can be no lookahead present (in yyla) is
+         if this state is a consistent state with a default action.
+         Thus, detecting the absence of a lookahead is sufficient to
+         determine that there is no unexpected or expected token to
+         report.  In that case, just report a simple "syntax error".
+       - Don't assume there isn't a lookahead just because this state is
+         a consistent state with a default action.  There might have
+         been a previous inconsistent state, consistent state with a
+         non-default action, or user semantic action that manipulated
+         yyla.  (However, yyla is currently not documented for users.)
+       - Of course, the expected token list depends on states to have
+         correct lookahead information, and it depends on the parser not
+         to perform extra reductions after fetching a lookahead from the
+         scanner and before detecting a syntax error.  Thus, state merging
+         (from LALR or IELR) and default reductions corrupt the expected
+         token list.  However, the list is correct for canonical LR with
+         one exception: it will still contain any token that will not be
+         accepted due to an error action in a later state.
+    */
+
+    if (!yyctx.lookahead ().empty ())
+      {
+        if (yyarg)
+          yyarg[0] = yyctx.token ();
+        int yyn = yyctx.expected_tokens (yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+        return yyn + 1;
+      }
+    return 0;
   }
-  
-  fclose (yyin);
-  return 0;
-}
 
-void yyerror (std::string s)
+  // Generate an error message.
+  std::string
+  Parser::yysyntax_error_ (const context& yyctx) const
+  {
+    // Its maximum.
+    enum { YYARGS_MAX = 5 };
+    // Arguments of yyformat.
+    symbol_kind_type yyarg[YYARGS_MAX];
+    int yycount = yy_syntax_error_arguments_ (yyctx, yyarg, YYARGS_MAX);
+
+    char const* yyformat = YY_NULLPTR;
+    switch (yycount)
+      {
+#define YYCASE_(N, S)                         \
+        case N:                               \
+          yyformat = S;                       \
+        break
+      default: // Avoid compiler warnings.
+        YYCASE_ (0, YY_("syntax error"));
+        YYCASE_ (1, YY_("syntax error, unexpected %s"));
+        YYCASE_ (2, YY_("syntax error, unexpected %s, expecting %s"));
+        YYCASE_ (3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+        YYCASE_ (4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+        YYCASE_ (5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+      }
+
+    std::string yyres;
+    // Argument number.
+    std::ptrdiff_t yyi = 0;
+    for (char const* yyp = yyformat; *yyp; ++yyp)
+      if (yyp[0] == '%' && yyp[1] == 's' && yyi < yycount)
+        {
+          yyres += symbol_name (yyarg[yyi++]);
+          ++yyp;
+        }
+      else
+        yyres += *yyp;
+    return yyres;
+  }
+
+
+  const signed char Parser::yypact_ninf_ = -58;
+
+  const signed char Parser::yytable_ninf_ = -1;
+
+  const short
+  Parser::yypact_[] =
+  {
+     -58,     6,   122,   -58,   -19,     5,     3,     8,    23,    30,
+      41,   -58,   -58,    45,    57,   -58,    88,   -58,   -58,   -58,
+     -58,   -58,   -58,   -58,   -58,   -58,   -58,   -58,     9,    22,
+      91,     9,     7,     7,    97,     9,   -58,    78,    37,   -58,
+     -58,   -58,     9,    61,     9,    82,    19,    86,     7,    73,
+      63,   127,     7,    36,   -58,   -58,   -58,   -58,   -58,   -58,
+       9,    54,     9,     9,     9,   -58,    65,    92,    93,     7,
+      24,   143,     9,     7,     7,     7,   141,   141,    83,    89,
+     100,    69,   -58,    47,   113,   113,   -58,   -58,   -58,   149,
+     -58,    -3,   102,   -58,    79,   110,   -58,    97,   101,   -58,
+     -58,   -58,   -58,   141,    95,   125,   111,   101,   -58,   141,
+     108,   109,   -58,   -58,   141,   141,   117,   114,   128,   -58,
+     -58,   -58
+  };
+
+  const signed char
+  Parser::yydefact_[] =
+  {
+       6,     0,     0,     1,     0,     0,     0,     0,     0,     0,
+       0,     7,     8,     0,     0,    13,     0,     2,    10,     9,
+      17,    18,    16,    19,    20,    21,    22,    23,     0,     0,
+       0,     0,     0,     0,     0,     0,    36,     0,     0,    45,
+      46,    44,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,    39,    11,    12,    14,    15,     3,
+       0,     0,     0,     0,     0,    26,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,    43,    40,    41,    42,     4,    24,    25,     0,
+      52,    47,    48,    49,    50,     0,    27,     0,     0,    37,
+      38,     5,    51,     0,     0,     0,     0,    32,    28,     0,
+       0,     0,    31,    29,     0,     0,    35,     0,     0,    33,
+      30,    34
+  };
+
+  const short
+  Parser::yypgoto_[] =
+  {
+     -58,   -58,   -58,   -58,   -58,   -58,   -58,   -57,   156,   -58,
+     -58,   -34,   -58,   -58,   -58,   -58,    53,   -58,   -58,   -58,
+     -58,   -58,   -27,   -26
+  };
+
+  const signed char
+  Parser::yydefgoto_[] =
+  {
+       0,     1,     2,    16,    17,    18,    37,    56,    57,    20,
+      21,    22,    23,    24,    25,    26,   106,   107,   119,    27,
+      58,    80,    49,    50
+  };
+
+  const signed char
+  Parser::yytable_[] =
+  {
+      52,    43,    62,    63,    46,    64,     3,    51,    53,    28,
+      39,    40,    39,    40,    29,    61,    41,    66,    41,    95,
+      96,    70,    71,   100,    62,    63,    78,    64,    47,    62,
+      63,    72,    64,    81,    30,    83,    84,    85,    48,    31,
+      42,    62,    63,    89,    64,    91,   108,    92,    93,    94,
+      44,    68,   113,    63,    32,    64,    82,   116,   117,    62,
+      63,    33,    64,   104,    59,    60,    62,    63,    79,    64,
+      62,    63,    34,    64,    62,    63,    35,    64,    62,    63,
+      72,    64,    73,    74,    36,    75,    82,     4,    65,     6,
+       7,     8,    86,     9,    10,    76,   101,    38,    73,    74,
+      45,    13,    73,    74,    14,    75,     4,    54,    55,     4,
+      97,     6,     7,     8,    67,     9,    10,    69,    98,    87,
+      88,    64,    74,    13,   103,   105,    14,   109,   110,    54,
+      99,     4,     5,     6,     7,     8,   111,     9,    10,    11,
+      12,   114,   115,   118,   120,    13,    73,    74,    14,    75,
+       4,    15,     6,     7,     8,   121,     9,    10,    19,    77,
+     112,     0,    73,    74,    13,    75,     0,    14,    73,    74,
+      54,    75,     0,     0,     0,    90,     0,     0,     0,     0,
+       0,   102
+  };
+
+  const signed char
+  Parser::yycheck_[] =
+  {
+      34,    28,     5,     6,    31,     8,     0,    33,    35,    28,
+       3,     4,     3,     4,     9,    42,     9,    44,     9,    76,
+      77,    48,    48,    80,     5,     6,    52,     8,    21,     5,
+       6,     7,     8,    60,    31,    62,    63,    64,    31,    31,
+      31,     5,     6,    69,     8,    72,   103,    73,    74,    75,
+      28,    32,   109,     6,    31,     8,    32,   114,   115,     5,
+       6,    31,     8,    97,    27,    28,     5,     6,    32,     8,
+       5,     6,    31,     8,     5,     6,    31,     8,     5,     6,
+       7,     8,    19,    20,    27,    22,    32,     9,    27,    11,
+      12,    13,    27,    15,    16,    32,    27,     9,    19,    20,
+       9,    23,    19,    20,    26,    22,     9,    29,    30,     9,
+      27,    11,    12,    13,    32,    15,    16,    31,    29,    27,
+      27,     8,    20,    23,    14,    24,    26,    32,     3,    29,
+      30,     9,    10,    11,    12,    13,    25,    15,    16,    17,
+      18,    33,    33,    26,    30,    23,    19,    20,    26,    22,
+       9,    29,    11,    12,    13,    27,    15,    16,     2,    32,
+     107,    -1,    19,    20,    23,    22,    -1,    26,    19,    20,
+      29,    22,    -1,    -1,    -1,    32,    -1,    -1,    -1,    -1,
+      -1,    32
+  };
+
+  const signed char
+  Parser::yystos_[] =
+  {
+       0,    35,    36,     0,     9,    10,    11,    12,    13,    15,
+      16,    17,    18,    23,    26,    29,    37,    38,    39,    42,
+      43,    44,    45,    46,    47,    48,    49,    53,    28,     9,
+      31,    31,    31,    31,    31,    31,    27,    40,     9,     3,
+       4,     9,    31,    56,    28,     9,    56,    21,    31,    56,
+      57,    57,    45,    56,    29,    30,    41,    42,    54,    27,
+      28,    56,     5,     6,     8,    27,    56,    32,    32,    31,
+      56,    57,     7,    19,    20,    22,    32,    32,    57,    32,
+      55,    56,    32,    56,    56,    56,    27,    27,    27,    57,
+      32,    56,    57,    57,    57,    41,    41,    27,    29,    30,
+      41,    27,    32,    14,    45,    24,    50,    51,    41,    32,
+       3,    25,    50,    41,    33,    33,    41,    41,    26,    52,
+      30,    27
+  };
+
+  const signed char
+  Parser::yyr1_[] =
+  {
+       0,    34,    35,    36,    36,    36,    36,    37,    37,    38,
+      38,    39,    40,    40,    41,    41,    42,    42,    42,    42,
+      42,    42,    42,    42,    43,    44,    45,    46,    47,    48,
+      49,    50,    50,    51,    52,    52,    53,    54,    55,    55,
+      56,    56,    56,    56,    56,    56,    56,    57,    57,    57,
+      57,    57,    57
+  };
+
+  const signed char
+  Parser::yyr2_[] =
+  {
+       0,     2,     2,     4,     6,     6,     0,     1,     1,     1,
+       1,     3,     2,     0,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     5,     5,     4,     5,     7,     8,
+      10,     2,     1,     5,     2,     0,     2,     3,     2,     0,
+       3,     3,     3,     3,     1,     1,     1,     3,     3,     3,
+       3,     4,     3
+  };
+
+
+#if YYDEBUG || 1
+  // YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+  // First, the terminals, then, starting at \a YYNTOKENS, nonterminals.
+  const char*
+  const Parser::yytname_[] =
+  {
+  "\"end of file\"", "error", "\"invalid token\"", "INT_NUM", "FLOAT_NUM",
+  "ADDOP", "MULOP", "RELOP", "POWER", "ID", "AUTO", "READ", "WRITE", "IF",
+  "ELSE", "WHILE", "FOR", "INT", "FLOAT", "OR", "AND", "NOT", "FAND",
+  "SWITCH", "CASE", "DEFAULT", "BREAK", "';'", "'='", "'{'", "'}'", "'('",
+  "')'", "':'", "$accept", "program", "declarations", "type",
+  "program_stmt", "outer_block", "outer_stmtlist", "stmt", "nonblock_stmt",
+  "read_stmt", "write_stmt", "assign_stmt", "while_stmt", "if_stmt",
+  "for_stmt", "switch_stmt", "caselist", "case", "optional_break",
+  "break_stmt", "block", "stmtlist", "expression", "boolexp", YY_NULLPTR
+  };
+#endif
+
+
+#if YYDEBUG
+  const unsigned char
+  Parser::yyrline_[] =
+  {
+       0,   126,   126,   132,   135,   140,   145,   147,   148,   152,
+     153,   155,   157,   162,   164,   165,   167,   168,   169,   170,
+     171,   172,   173,   174,   176,   179,   181,   184,   186,   188,
+     191,   195,   199,   201,   203,   203,   205,   207,   213,   214,
+     219,   221,   223,   226,   227,   228,   229,   231,   233,   234,
+     235,   236,   237
+  };
+
+  void
+  Parser::yy_stack_print_ () const
+  {
+    *yycdebug_ << "Stack now";
+    for (stack_type::const_iterator
+           i = yystack_.begin (),
+           i_end = yystack_.end ();
+         i != i_end; ++i)
+      *yycdebug_ << ' ' << int (i->state);
+    *yycdebug_ << '\n';
+  }
+
+  void
+  Parser::yy_reduce_print_ (int yyrule) const
+  {
+    int yylno = yyrline_[yyrule];
+    int yynrhs = yyr2_[yyrule];
+    // Print the symbols being reduced, and their result.
+    *yycdebug_ << "Reducing stack by rule " << yyrule - 1
+               << " (line " << yylno << "):\n";
+    // The symbols being reduced.
+    for (int yyi = 0; yyi < yynrhs; yyi++)
+      YY_SYMBOL_PRINT ("   $" << yyi + 1 << " =",
+                       yystack_[(yynrhs) - (yyi + 1)]);
+  }
+#endif // YYDEBUG
+
+  Parser::symbol_kind_type
+  Parser::yytranslate_ (int t) YY_NOEXCEPT
+  {
+    // YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to
+    // TOKEN-NUM as returned by yylex.
+    static
+    const signed char
+    translate_table[] =
+    {
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+      31,    32,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,    33,    27,
+       2,    28,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    29,     2,    30,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26
+    };
+    // Last valid token kind.
+    const int code_max = 281;
+
+    if (t <= 0)
+      return symbol_kind::S_YYEOF;
+    else if (t <= code_max)
+      return static_cast <symbol_kind_type> (translate_table[t]);
+    else
+      return symbol_kind::S_YYUNDEF;
+  }
+
+} // yy
+#line 2212 "ast.tab.c"
+
+#line 240 "ast.y"
+
+// (the line of the error is the line of the scanner, not of loc)
+void yy::Parser::error (const location_type &loc, const std::string &s)
 {
-  extern int yylineno;  // defined by flex
-  errors++;
-  fprintf (stderr, "line %d: %s\n", yylineno, s.c_str ());
+  ctx->errors++;
+  fprintf (ctx->err, "line %d: %s\n", yyget_lineno (scanner), s.c_str ());
 }
 
 void errorMsg (const char *format, ...)
 {
+    CompilerContext *ctx = CompilerContext::current ();
+	if (ctx->quiet > 0)
+	    return;  // (printed and counted with the first copy of the code)
     va_list argptr;
 	va_start (argptr, format);
 	// all the arguments following 'format' are passed on to vfprintf
-	vfprintf (stderr, format, argptr); 
+	vfprintf (ctx->err, format, argptr); 
 	va_end (argptr);
 	
-	errors++;
-} 
\ No newline at end of file
+	ctx->errors++;
+} 
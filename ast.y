@@ -3,74 +3,114 @@
 #include <string>
 #include <stdarg.h>
 #include "symtab.h"
+#include "context.h"
 
-  /* yylex () and yyerror() need to be declared here */
-int yylex (void);
-void yyerror (std::string s);
+  /* yylex () needs to be declared here (see ast.lex).  The value of the token is built in
+     *yylval (yylval->emplace<int> (...)): the type of its value is the one of the token below */
+int yylex (yy::Parser::value_type *yylval, yy::Parser::location_type *yylloc, void *scanner);
+
+// yylex () counted and timed (see stats.h). The parser calls this one
+static
+int countedLex (yy::Parser::value_type *yylval, yy::Parser::location_type *yylloc, void *scanner, CompilerContext *ctx)
+{
+    PhaseTimer timer (ctx->stats, PHASE_LEX);
+	ctx->stats.tokens++;
+	return yylex (yylval, yylloc, scanner);
+}
+#define yylex(yylval, yylloc, scanner) countedLex (yylval, yylloc, scanner, ctx)
+int yyget_lineno (void *scanner);  // defined by flex
 
 /* void emit (const char *format, ...);  */
 
-// number of errors 
-int errors;
+// -flat-ast (see the rules of expressions)
+#define FLAT (ctx->options.flatAST)
+
+// add stmt at the end of list
+static
+StmtList append (StmtList list, Stmt *stmt)
+{
+    if (list.first == NULL)
+	    list.first = stmt;
+	else
+	    list.last->_next = stmt;
+	list.last = stmt;
+	return list;
+}
 }
 
 %code requires {
 #include "ast.h"
-}
+class CompilerContext;
 
-/* note: no semicolon after the union */
-%union {
-   int ival;
-   // float numbers in the source program are stored as double
-   double fval;
-   enum op op;
-   char name[100];
-   
-   myType _type;
-   
-   //  pointers to AST nodes:
-   Stmt *stmt;
-   Block *block;
-   Stmt *stmtlist; // points to first Stmt in the list (NULL if list is empty)
-   ReadStmt *read_stmt;
-   AssignStmt *assign_stmt;
-   IfStmt *if_stmt;
-   WhileStmt *while_stmt;
-   SwitchStmt *switch_stmt;
-   Case *caselist; //points to first Case in the list
-   Case *mycase;
-   BreakStmt *break_stmt;
-   Exp  *exp;
-   BoolExp *boolexp;
-   bool hasBreak;
-   ForStmt *for_stmt;
-   WriteStmt *write_stmt;
+// the semantic value of stmtlist
+struct StmtList {
+    Stmt *first;  // NULL if the list is empty
+	Stmt *last;
+};
+
+// the location of a symbol: its lines (the scanner does not track columns, see ast.lex)
+struct Location {
+    int first_line;
+	int last_line;
+};
+#define YYLLOC_DEFAULT(Current, Rhs, N)                                        \
+    do {                                                                       \
+	    if (N) {                                                               \
+		    (Current).first_line = YYRHSLOC (Rhs, 1).first_line;               \
+			(Current).last_line = YYRHSLOC (Rhs, N).last_line;                 \
+		} else                                                                 \
+		    (Current).first_line = (Current).last_line = YYRHSLOC (Rhs, 0).last_line; \
+	} while (0)
 }
 
-%token <ival> INT_NUM
-%token <fval> FLOAT_NUM
-%token <op> ADDOP MULOP RELOP POWER
-%token <name> ID
+/* the parser is a C++ class (yy::Parser, bison's lalr1.cc skeleton, bison 3.2 or later):
+   an object for each parse, no global state.  scanner is the (reentrant) flex scanner, ctx is
+   the compilation the parser works for:  CompilerContext::compile () does
+       yy::Parser parser (scanner, ctx);
+	   parser.parse ();
+   The location of a symbol is a Location (above) */
+%require "3.2"
+%skeleton "lalr1.cc"
+%define api.parser.class {Parser}
+%define api.location.type {Location}
+%locations
+%param { void *scanner }
+%parse-param { CompilerContext *ctx }
+
+/* the semantic values are variants: each symbol has a value of its own type (below), built in
+   place on the stack of the parser.  There is no union of all the types to copy at each
+   reduction:  a value is 8 bytes (16 for a StmtList).  The stack is a vector that grows as
+   needed (there is no YYMAXDEPTH: deeply nested expressions parse).  The nodes of the AST are in the arena (see ast.h) and a value
+   is a pointer to one (a handle: nothing to free or move), and the value of an ID is its name
+   interned by the scanner (see internName () in symtab.h) */
+%define api.value.type variant
+
+%token <int> INT_NUM
+// float numbers in the source program are stored as double
+%token <double> FLOAT_NUM
+%token <enum op> ADDOP MULOP RELOP POWER
+%token <const char *> ID
 
 %token AUTO READ WRITE IF ELSE WHILE  FOR INT FLOAT OR AND NOT FAND SWITCH CASE DEFAULT BREAK
-%type <_type> type
-
-%type <exp> expression
-%type <boolexp> boolexp 
-%type <stmt> stmt
-%type <block> block
-%type <stmtlist> stmtlist
-%type <read_stmt> read_stmt 
-%type <assign_stmt> assign_stmt 
-%type <while_stmt> while_stmt
-%type <if_stmt>  if_stmt
-%type <switch_stmt> switch_stmt;
-%type <caselist> caselist
-%type <mycase> case
-%type <hasBreak> optional_break;
-%type <break_stmt> break_stmt
-%type <for_stmt> for_stmt
-%type <write_stmt> write_stmt
+%type <myType> type
+
+%type <Exp *> expression
+%type <BoolExp *> boolexp 
+%type <Stmt *> stmt nonblock_stmt program_stmt
+%type <Block *> block
+%type <StmtList> stmtlist outer_stmtlist
+%type <Block *> outer_block
+%type <ReadStmt *> read_stmt 
+%type <AssignStmt *> assign_stmt 
+%type <WhileStmt *> while_stmt
+%type <IfStmt *>  if_stmt
+%type <SwitchStmt *> switch_stmt;
+%type <Case *> caselist  //points to first Case in the list
+%type <Case *> case
+%type <bool> optional_break;
+%type <BreakStmt *> break_stmt
+%type <ForStmt *> for_stmt
+%type <WriteStmt *> write_stmt
 
 
 %left FAND
@@ -80,12 +120,12 @@ int errors;
 %left MULOP
 %right POWER
 
-%error-verbose
+%define parse.error verbose
 
 %%
-program    : declarations stmt { 
-                      if (errors == 0) { /* for debugging: generate code even if errors found */
-					     $2->genStmt (); emit ("halt"); 
+program    : declarations program_stmt { 
+                      if (ctx->errors == 0) { /* for debugging: generate code even if errors found */
+					     ctx->generate ($2); emit (Instr (IR_HALT)); ctx->finishCode (); 
 						 } 
 				     }
 
@@ -107,15 +147,31 @@ declarations: declarations type ID ';' { if (!(putSymbol ($3, $2)))
 type: INT { $$ = _INT; } |
       FLOAT { $$ = _FLOAT; };			  
 
-stmt       :  assign_stmt { $$ = $1; } |
+/* the outermost block of the program is parsed by its own rules so each of its statements
+   can be compiled as soon as it ends (see streamStatement() in context.h) */
+program_stmt : nonblock_stmt { $$ = $1; } |
+               outer_block   { $$ = $1; } ;
+			   
+outer_block: '{' outer_stmtlist '}' { $$ = new Block ($2.first); };
+
+outer_stmtlist: outer_stmtlist stmt { if (ctx->streamStatement ($2))
+                                          $$ = $1; // its code was generated. It is not kept
+									  else
+									      $$ = append ($1, $2);
+									};
+outer_stmtlist:  /* empty */ { $$.first = $$.last = NULL; };
+
+stmt       :  nonblock_stmt { $$ = $1; } |
+			  block         { $$ = $1; } ;
+
+nonblock_stmt :  assign_stmt { $$ = $1; } |
               read_stmt   { $$ = $1; } |
               write_stmt  { $$ = $1; } | 
 			  while_stmt  { $$ = $1; } |
 	          if_stmt     { $$ = $1; } |
 			  for_stmt    { $$ = $1; } |
 			  switch_stmt { $$ = $1; } |
-			  break_stmt  { $$ = $1; } |
-			  block       { $$ = $1; } ;
+			  break_stmt  { $$ = $1; } ;
 			  
 read_stmt:    READ '(' ID ')' ';'{ 
                 $$ = new ReadStmt (new IdNode ($3, @3.first_line), @1.first_line); };
@@ -148,80 +204,57 @@ optional_break: BREAK ';'{ $$ = true; } | /* empty */ { $$ = false; } ;
 
 break_stmt :  BREAK ';'  { $$ = new BreakStmt (@1.first_line); };
 
-block: '{' stmtlist '}' { $$ = new Block ($2); };
+block: '{' stmtlist '}' { $$ = new Block ($2.first); };
 
-/*  right recursion is used here because it simplifies the code  a bit.
-    but left recursion  (i.e. stmtlist: stmtlist stmt)  would be better
-    because it uses less stack space.
-    Semantic value of stmtlist is a pointer to the first Stmt in a list 
+/*  left recursion is used here: it uses less stack space than right recursion.
+    Semantic value of stmtlist is a pointer to the first and to the last Stmt in a list 
 	of Stmts. Each Stmt points to the next Stmt on the list
 */
-stmtlist:  stmt stmtlist {  $1->_next = $2;  // also works when $2 is NULL
-                            $$ = $1;  
-						 };
-stmtlist:  /* empty */ { $$ = NULL; };
+stmtlist:  stmtlist stmt { $$ = append ($1, $2); };
+stmtlist:  /* empty */ { $$.first = $$.last = NULL; };
 	  
+/* with -flat-ast the nodes of expressions and conditions are put in the flat form of the AST
+   (see flatast.h):  ctx->flatAST makes them.  Else ctx->exps makes the nodes of expressions.
+   Both give an expression the node of an identical one when there is one (see hashcons.h) */
 expression : expression ADDOP expression {
-                  $$ = new BinaryOp ($2, $1, $3, @2.first_line); } |
+                  $$ = FLAT ? ctx->flatAST.binaryOp ($2, $1, $3) : ctx->exps.binaryOp ($2, $1, $3); } |
 		     expression MULOP expression {
-                  $$ = new BinaryOp ($2, $1, $3, @2.first_line); } |
+                  $$ = FLAT ? ctx->flatAST.binaryOp ($2, $1, $3) : ctx->exps.binaryOp ($2, $1, $3); } |
 			 expression POWER expression {
-                  $$ = new BinaryOp ($2, $1, $3, @2.first_line); };
+                  $$ = FLAT ? ctx->flatAST.binaryOp ($2, $1, $3) : ctx->exps.binaryOp ($2, $1, $3); };
 
 expression: '(' expression ')' { $$ = $2; } |
-            ID          { $$ = new IdNode ($1, @1.first_line);} |
-            INT_NUM     { $$ = new NumNode ($1); } |
-			FLOAT_NUM   { $$ = new NumNode ($1); };
+            ID          { $$ = FLAT ? ctx->flatAST.id ($1, @1.first_line) : ctx->exps.id ($1, @1.first_line);} |
+            INT_NUM     { $$ = FLAT ? ctx->flatAST.num ($1) : ctx->exps.num ($1); } |
+			FLOAT_NUM   { $$ = FLAT ? ctx->flatAST.num ($1) : ctx->exps.num ($1); };
 			
-boolexp: expression RELOP expression { $$ = new SimpleBoolExp ($2, $1, $3); };
+boolexp: expression RELOP expression { $$ = FLAT ? ctx->flatAST.simpleBoolExp ($2, $1, $3, @2.first_line) : new SimpleBoolExp ($2, $1, $3, @2.first_line); };
 
-boolexp: boolexp OR boolexp { $$ = new Or ($1, $3); } |
-         boolexp AND boolexp { $$ = new And ($1, $3); } |
-		 boolexp FAND boolexp { $$ = new Fand ($1, $3); } |
-         NOT '(' boolexp ')' { $$ = new Not ($3); } |
+boolexp: boolexp OR boolexp { $$ = FLAT ? ctx->flatAST.orExp ($1, $3) : new Or ($1, $3); } |
+         boolexp AND boolexp { $$ = FLAT ? ctx->flatAST.andExp ($1, $3) : new And ($1, $3); } |
+		 boolexp FAND boolexp { $$ = FLAT ? ctx->flatAST.fandExp ($1, $3) : new Fand ($1, $3); } |
+         NOT '(' boolexp ')' { $$ = FLAT ? ctx->flatAST.notExp ($3) : new Not ($3); } |
 		 '(' boolexp ')'  { $$ = $2;}
 		 ;
 
 %%
-main (int argc, char **argv)
-{
-  extern FILE *yyin;
-  if (argc != 2) {
-     fprintf (stderr, "Usage: %s <input-file-name>\n", argv[0]);
-	 return 1;
-  }
-  yyin = fopen (argv [1], "r");
-  if (yyin == NULL) {
-       fprintf (stderr, "failed to open %s\n", argv[1]);
-	   return 2;
-  }
-  
-  errors = 0;
-  yyparse ();
-   
-  if (errors > 0) {
-      fprintf(stderr, "compilation failed\n");
-	  return 3;
-  }
-  
-  fclose (yyin);
-  return 0;
-}
-
-void yyerror (std::string s)
+// (the line of the error is the line of the scanner, not of loc)
+void yy::Parser::error (const location_type &loc, const std::string &s)
 {
-  extern int yylineno;  // defined by flex
-  errors++;
-  fprintf (stderr, "line %d: %s\n", yylineno, s.c_str ());
+  ctx->errors++;
+  fprintf (ctx->err, "line %d: %s\n", yyget_lineno (scanner), s.c_str ());
 }
 
 void errorMsg (const char *format, ...)
 {
+    CompilerContext *ctx = CompilerContext::current ();
+	if (ctx->quiet > 0)
+	    return;  // (printed and counted with the first copy of the code)
     va_list argptr;
 	va_start (argptr, format);
 	// all the arguments following 'format' are passed on to vfprintf
-	vfprintf (stderr, format, argptr); 
+	vfprintf (ctx->err, format, argptr); 
 	va_end (argptr);
 	
-	errors++;
+	ctx->errors++;
 } 
\ No newline at end of file
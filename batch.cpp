@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "batch.h"
+#include "context.h"
+#include "pool.h"
+#include "incremental.h"
+#include "trace.h"
+
+static
+bool endsWith (const std::string &s, const char *suffix)
+{
+    size_t n = strlen (suffix);
+	return s.size () >= n && s.compare (s.size () - n, n, suffix) == 0;
+}
+
+static
+bool isDirectory (const std::string &path)
+{
+    struct stat st;
+	return stat (path.c_str (), &st) == 0 && S_ISDIR (st.st_mode);
+}
+
+// add the names of the source files in 'dir' to 'files' (sorted, so the order is deterministic)
+static
+bool listDirectory (const std::string &dir, std::vector<std::string> &files)
+{
+    DIR *d = opendir (dir.c_str ());
+	if (d == NULL)
+	    return false;
+	std::vector<std::string> names;
+	struct dirent *entry;
+	while ((entry = readdir (d)) != NULL) {
+	    std::string name = entry->d_name;
+		if (name [0] == '.' || endsWith (name, ".tac") || endsWith (name, ".tacb") || endsWith (name, ".inc") || endsWith (name, ".prof") || endsWith (name, "_out.txt"))
+		    continue;
+		std::string path = dir + "/" + name;
+		struct stat st;
+		if (stat (path.c_str (), &st) == 0 && S_ISREG (st.st_mode))
+		    names.push_back (path);
+	}
+	closedir (d);
+	std::sort (names.begin (), names.end ());
+	files.insert (files.end (), names.begin (), names.end ());
+	return true;
+}
+
+// add the file names listed in 'listfile' (one per line) to 'files'
+static
+bool readList (const std::string &listfile, std::vector<std::string> &files)
+{
+    FILE *f = fopen (listfile.c_str (), "r");
+	if (f == NULL)
+	    return false;
+	char line [4096];
+	while (fgets (line, sizeof line, f) != NULL) {
+	    size_t len = strcspn (line, "\r\n");
+		line [len] = '\0';
+		if (len > 0)
+		    files.push_back (line);
+	}
+	fclose (f);
+	return true;
+}
+
+// dir/name.txt  --> dir/name.tac  (or outdir/name.tac).  name.tacb for a binary IR file
+static
+std::string outputName (const std::string &source, const char *outdir, bool binary)
+{
+    std::string name = source;
+	if (outdir != NULL) {
+	    size_t slash = name.find_last_of ("/\\");
+		if (slash != std::string::npos)
+		    name = name.substr (slash + 1);
+		name = std::string (outdir) + "/" + name;
+	}
+	size_t dot = name.find_last_of ('.');
+	size_t slash = name.find_last_of ("/\\");
+	if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+	    name = name.substr (0, dot);
+	return name + (binary ? ".tacb" : ".tac");
+}
+
+// path with its directory made absolute, without . .. and links, to compare file names (the
+// file itself need not exist).  path as it is if its directory cannot be found
+static
+std::string canonicalPath (const std::string &path)
+{
+    size_t slash = path.find_last_of ("/\\");
+	std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr (0, slash);
+	char *real = realpath (dir.c_str (), NULL);
+	if (real == NULL)
+	    return path;
+	std::string name = std::string (real) + "/" + path.substr (slash + 1);  // (npos + 1 is 0)
+	free (real);
+	return name;
+}
+
+// what the compilation of one file produced
+struct BatchResult {
+    BatchResult () { errors = 0; opened = true; diagStart = diagEnd = 0; reused = total = 0; }
+	
+    int errors;
+	int reused, total;  // statements (see CompilerContext::statementsReused)
+	CompileStats stats;
+	bool opened;  // false if the source file could not be opened
+	long diagStart, diagEnd;  // the error messages are in this range of the worker's diagnostics file
+};
+
+// copy the error messages of one file from the worker's diagnostics file to stderr
+static
+void printDiagnostics (const std::string &source, FILE *diags, long start, long end)
+{
+    if (start == end)
+	    return;
+    fseek (diags, start, SEEK_SET);
+	std::string text (end - start, '\0');
+	text.resize (fread (&text [0], 1, end - start, diags));
+	
+	size_t pos = 0;
+	while (pos < text.size ()) {
+	    size_t eol = text.find ('\n', pos);
+		if (eol == std::string::npos)
+		    eol = text.size ();
+	    fprintf (stderr, "%s: %s\n", source.c_str (), text.substr (pos, eol - pos).c_str ());
+		pos = eol + 1;
+	}
+}
+
+int compileBatch (const std::vector<std::string> &inputs, const BatchOptions &options)
+{
+    std::vector<std::string> files;
+	int status = 0;
+	
+	for (size_t i = 0; i < inputs.size (); i++) {
+	    const std::string &input = inputs [i];
+		bool ok;
+	    if (input [0] == '@')
+		    ok = readList (input.substr (1), files);
+		else if (isDirectory (input))
+		    ok = listDirectory (input, files);
+		else {
+		    files.push_back (input);
+			ok = true;
+		}
+		if (!ok) {
+		    fprintf (stderr, "failed to read %s\n", input.c_str ());
+			status = 2;
+		}
+	}
+	
+	// a file given twice is compiled once.  Two files whose code would go to the same file (x/p.txt
+	// and y/p.txt with -o, p.txt and p.y) are an error: the second one is not compiled
+	std::vector<std::string> unique;
+	std::map<std::string, std::string> sources, targets;  // canonical name --> file
+	for (size_t i = 0; i < files.size (); i++) {
+	    if (!sources.insert (std::make_pair (canonicalPath (files [i]), files [i])).second)
+		    continue;
+		std::string target = outputName (files [i], options.outdir, options.compile.binaryIR);
+		std::pair<std::map<std::string, std::string>::iterator, bool> t = targets.insert (std::make_pair (canonicalPath (target), files [i]));
+		if (!t.second) {
+		    fprintf (stderr, "%s and %s would both be written to %s\n", t.first->second.c_str (), files [i].c_str (), target.c_str ());
+			status = 2;
+			continue;
+		}
+		unique.push_back (files [i]);
+	}
+	files.swap (unique);
+	
+	int nthreads = options.threads > 0 ? options.threads : ThreadPool::hardwareThreads ();
+	if (nthreads > (int) files.size ())
+	    nthreads = files.size () > 0 ? (int) files.size () : 1;
+	
+	// one compiler context and one diagnostics file per worker
+	std::vector<CompilerContext *> contexts;
+	std::vector<FILE *> diags;
+	for (int i = 0; i < nthreads; i++) {
+	    contexts.push_back (new CompilerContext);
+		diags.push_back (tmpfile ());
+		if (diags.back () == NULL) {
+		    fprintf (stderr, "failed to create a temporary file\n");
+			return 2;
+		}
+	}
+	std::vector<BatchResult> results (files.size ());
+	std::vector<int> worker_of (files.size ());
+	
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+	
+	ThreadPool pool (nthreads);
+	pool.run ((int) files.size (), [&] (int item, int worker) {
+	    const std::string &source = files [item];
+		TraceSpan span ("compile", source.c_str ());
+		BatchResult &result = results [item];
+		CompilerContext *ctx = contexts [worker];
+		worker_of [item] = worker;
+		result.diagStart = result.diagEnd = ftell (diags [worker]);
+		
+	    FILE *in = fopen (source.c_str (), "r");
+		if (in == NULL) {
+		    result.opened = false;
+			return;
+		}
+		// the code is written to a temporary file renamed to target at the end (as in cache.cpp):
+		// a program reading target never sees half of it
+		std::string target = outputName (source, options.outdir, options.compile.binaryIR);
+		char suffix [50];
+		snprintf (suffix, sizeof suffix, ".%ld.tmp", (long) getpid ());
+		std::string tmppath = target + suffix;
+		FILE *out = fopen (tmppath.c_str (), "wb");
+		if (out == NULL) {
+		    fclose (in);
+		    fprintf (diags [worker], "failed to create %s\n", target.c_str ());
+			result.errors = 1;
+		    result.diagEnd = ftell (diags [worker]);
+			return;
+		}
+		
+		ctx->out = out;
+		ctx->err = diags [worker];
+		ctx->options = options.compile;
+		ctx->incrementalFile = source + ".inc";
+		ctx->profileFile = source + ".prof";
+		result.errors = compileCached (*ctx, in, options.cache);
+		result.reused = ctx->statementsReused;
+		result.total = ctx->statementsTotal;
+		result.stats = ctx->stats;
+		if (result.errors > 0)
+		    fprintf (ctx->err, "compilation failed\n");
+		
+		fclose (in);
+		bool written = !ferror (out);
+		written = fclose (out) == 0 && written;
+		if (result.errors == 0 && (!written || rename (tmppath.c_str (), target.c_str ()) != 0)) {
+		    fprintf (ctx->err, "failed to write %s\n", target.c_str ());
+			result.errors = 1;
+		}
+		if (result.errors > 0) {
+		    remove (tmppath.c_str ());
+			remove (target.c_str ());
+		}
+		result.diagEnd = ftell (diags [worker]);
+		ctx->reset ();  // release the AST now rather than at the start of the next compilation
+	});
+	
+	double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+	
+	int failed = 0;
+	long reused = 0, total = 0;
+	CompileStats stats;  // of all files
+	stats.timing = options.compile.timeReport != TIME_REPORT_NONE;
+	for (size_t i = 0; i < files.size (); i++) {
+	    reused += results [i].reused;
+		total += results [i].total;
+		stats.add (results [i].stats);
+	    if (!results [i].opened) {
+		    fprintf (stderr, "failed to open %s\n", files [i].c_str ());
+			status = 2;
+			continue;
+		}
+	    printDiagnostics (files [i], diags [worker_of [i]], results [i].diagStart, results [i].diagEnd);
+		if (results [i].errors > 0) {
+		    failed++;
+			if (status == 0)
+			    status = 3;
+		}
+	}
+	
+	if (options.verbose)
+	    fprintf (stderr, "compiled %d files (%d failed) in %.3f seconds using %d threads: %.0f files/sec\n",
+		         (int) files.size (), failed, seconds, nthreads, seconds > 0 ? files.size () / seconds : 0.0);
+	if (options.verbose && options.compile.incremental)
+	    printReuse (stderr, reused, total);
+	if (options.compile.timeReport != TIME_REPORT_NONE)
+	    stats.print (stderr, options.compile.timeReport);  // the times of all threads added up
+	
+	for (int i = 0; i < nthreads; i++) {
+	    delete contexts [i];
+		fclose (diags [i]);
+	}
+	return status;
+}
@@ -0,0 +1,39 @@
+#ifndef __BATCH_H
+#define __BATCH_H 1
+
+#include <string>
+#include <vector>
+
+#include "context.h"
+#include "cache.h"
+
+struct BatchOptions {
+    BatchOptions () { threads = 0; outdir = NULL; verbose = false; cache = NULL; }
+	
+    int threads;         // number of worker threads. 0 means one per hardware thread
+	const char *outdir;  // where to write the output files. NULL means next to each source file
+	bool verbose;        // print the number of files compiled per second
+	CompileCache *cache; // NULL if the compilation cache is not used
+	CompileOptions compile;  // options of each compilation
+};
+
+/*  Compile many source programs, using a pool of worker threads (see pool.h).
+    Each input is a source file, a directory (all its files are compiled, except *.tac and
+    *_out.txt and *.inc files) or @listfile (a file with the name of a source file on each line).
+	
+    The code generated for  dir/name.txt  is written to  dir/name.tac  (or outdir/name.tac).
+    The output file is removed if the compilation fails.  It is written under a temporary name
+    and renamed when it is complete.  A file given twice is compiled once;  a file whose output
+    file is the output file of a file before it (x/p.txt and y/p.txt with an outdir, p.txt and
+    p.y) is not compiled (an error, return value 2).
+    With -incremental the statement cache of  dir/name.txt  is  dir/name.txt.inc  (see incremental.h).
+    Error messages are written to stderr, each one prefixed by the name of its source file.
+    They are written in the order the files were given (not in the order the compilations
+    end) so the output does not depend on the number of threads.
+
+    return value: 0 if all files were compiled successfully, 3 if there were errors,
+    2 if some input could not be read or two inputs have one output file
+*/
+int compileBatch (const std::vector<std::string> &inputs, const BatchOptions &options);
+
+#endif // not defined __BATCH_H
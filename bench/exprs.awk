@@ -0,0 +1,77 @@
+# writes the program of the benchmark of -flat-ast (make bench-ast):  many statements with big
+# expressions and conditions.  awk -v n=20000 -f bench/exprs.awk   (n: the number of statements)
+# awk -v deep=n -f bench/exprs.awk  writes instead the program of make check-deep:  a sum of n
+# terms and conditions of n / 10 comparisons joined by and and by or, which print n, 1 and 1
+
+function term () {
+    r = rand ()
+	if (r < 0.4)
+	    return vars [int (rand () * 6)]
+	if (r < 0.7)
+	    return int (rand () * 100)
+	if (r < 0.8)
+	    return int (rand () * 100) ".5"
+	return "(" vars [int (rand () * 6)] " " ops [int (rand () * 4)] " " int (rand () * 9 + 1) ")"
+}
+
+function expression (size,    e, i) {
+    e = term ()
+	for (i = 1; i < size; i++)
+	    e = e " " ops [int (rand () * 4)] " " term ()
+	return e
+}
+
+function condition (size,    c, i) {
+    c = expression (3) " " relops [int (rand () * 6)] " " expression (3)
+	for (i = 1; i < size; i++)
+	    c = c " " (rand () < 0.5 ? "and" : "or") " " expression (2) " " relops [int (rand () * 6)] " " expression (2)
+	return c
+}
+
+# (the compiler walks expressions without recursion: a compiler that recursed would crash here)
+function deepProgram (n,    k) {
+    print "int i;\n{"
+	printf "  i = 1"
+	for (k = 1; k < n; k++)
+	    printf " + 1"
+	print ";\n  write (i);"
+	printf "  if (i > 0"
+	for (k = 1; k < n / 10; k++)
+	    printf " and i > %d", k
+	print ") write (1); else write (0);"
+	printf "  if (i < 0"
+	for (k = 1; k < n / 10; k++)
+	    printf " or i < 0 - %d", k
+	print " or i > 0) write (1); else write (0);\n}"
+}
+
+BEGIN {
+	if (deep > 0) {
+	    deepProgram (deep)
+		exit
+	}
+    srand (1)
+	if (n == 0)
+	    n = 20000
+	split ("a b c i x y", v, " ")
+	for (k = 0; k < 6; k++)
+	    vars [k] = v [k + 1]
+	split ("+ - * /", o, " ")
+	for (k = 0; k < 4; k++)
+	    ops [k] = o [k + 1]
+	split ("< > <= >= == !=", o, " ")
+	for (k = 0; k < 6; k++)
+	    relops [k] = o [k + 1]
+
+	print "float a;\nfloat b;\nfloat c;\nint i;\nfloat x;\nfloat y;\n{"
+	for (s = 0; s < n; s++) {
+	    r = rand ()
+		if (r < 0.6)
+		    print "  " (rand () < 0.5 ? "x" : "y") " = " expression (int (rand () * 30) + 1) ";"
+		else if (r < 0.9)
+		    print "  if (" condition (int (rand () * 6) + 1) ") a = " expression (8) "; else b = " expression (8) ";"
+		else
+		    print "  while (" condition (2) ") { c = " expression (12) "; break; }"
+	}
+	print "  write (x);\n}"
+}
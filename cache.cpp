@@ -0,0 +1,254 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cache.h"
+#include "hash.h"
+#include "trace.h"
+
+static
+bool readFile (FILE *f, std::string &data)
+{
+    char buf [64 * 1024];
+	size_t n;
+	data.clear ();
+	while ((n = fread (buf, 1, sizeof buf, f)) > 0)
+	    data.append (buf, n);
+	return !ferror (f);
+}
+
+CompileCache::CompileCache (const char *dir, unsigned long long maxBytes)
+    : _size (0), _hits (0), _misses (0), _stores (0), _evictions (0)
+{
+    _dir = dir;
+	_maxBytes = maxBytes;
+	
+	mkdir (dir, 0777);  // it is fine if it exists already
+	DIR *d = opendir (dir);
+	_ok = d != NULL;
+	if (d == NULL) {
+	    fprintf (stderr, "cannot use cache directory %s\n", dir);
+		return;
+	}
+	struct dirent *entry;
+	while ((entry = readdir (d)) != NULL) {
+	    struct stat st;
+		std::string path = _dir + "/" + entry->d_name;
+		if (stat (path.c_str (), &st) == 0 && S_ISREG (st.st_mode))
+		    _size += st.st_size;
+	}
+	closedir (d);
+}
+
+std::string CompileCache::key (const std::string &source, const CompileOptions &options)
+{
+    std::string text = COMPILER_VERSION;
+	text += '\0';
+	text += options.key ();
+	text += '\0';
+	text += source;
+	
+	char name [40];
+	Hash128 h = hash128 (text.data (), text.size ());
+	snprintf (name, sizeof name, "%016llx%016llx", h.lo, h.hi);
+	return name;
+}
+
+/*  a hit updates the modification time of the entry, but not more than once a minute:
+    setting the time is slower than reading the entry and the order of eviction does not
+    need to be more precise than that */
+static
+void markUsed (const std::string &path)
+{
+    struct stat st;
+	if (stat (path.c_str (), &st) == 0 && st.st_mtime + 60 > time (NULL))
+	    return;
+	utimes (path.c_str (), NULL);
+}
+
+/*  an entry is a file holding
+        tac-cache 1\n
+        <errors> <code bytes> <message bytes>\n
+        the code
+        the messages
+*/
+bool CompileCache::lookup (const std::string &key, int &errors, std::string &code, std::string &messages)
+{
+    std::string path = _dir + "/" + key;
+	FILE *f = fopen (path.c_str (), "rb");
+	if (f == NULL) {
+	    _misses++;
+		return false;
+	}
+	
+	std::string data;
+	bool ok = readFile (f, data);
+	fclose (f);
+	
+	size_t codeLen, messagesLen;
+	int header = 0;
+	// (not "\n%n" in the format: it would skip the white space at the start of the code too)
+	if (ok && sscanf (data.c_str (), "tac-cache 1\n%d %zu %zu%n", &errors, &codeLen, &messagesLen, &header) == 3
+	    && data [header++] == '\n' && data.size () == header + codeLen + messagesLen) {
+		code = data.substr (header, codeLen);
+		messages = data.substr (header + codeLen);
+		markUsed (path);
+		_hits++;
+		return true;
+	}
+	_misses++;  // a broken entry is like no entry. store() will replace it
+	return false;
+}
+
+void CompileCache::store (const std::string &key, int errors, const std::string &code, const std::string &messages)
+{
+    char header [100];
+	snprintf (header, sizeof header, "tac-cache 1\n%d %zu %zu\n", errors, code.size (), messages.size ());
+	
+	// a temporary name that no other thread or process uses
+	char tmpname [100];
+	static std::atomic<long> counter (0);
+	snprintf (tmpname, sizeof tmpname, "/tmp.%ld.%zu.%ld", (long) getpid (), 
+	          std::hash<std::thread::id> () (std::this_thread::get_id ()), counter++);
+	std::string tmppath = _dir + tmpname;
+	
+	FILE *f = fopen (tmppath.c_str (), "wb");
+	if (f == NULL)
+	    return;
+	std::string data = header + code + messages;
+	bool ok = fwrite (data.data (), 1, data.size (), f) == data.size ();
+	ok = fclose (f) == 0 && ok;
+	std::string path = _dir + "/" + key;
+	struct stat st;
+	long long replaced = stat (path.c_str (), &st) == 0 ? st.st_size : 0;  // the entry it replaces
+	if (!ok || rename (tmppath.c_str (), path.c_str ()) != 0) {
+	    remove (tmppath.c_str ());
+		return;
+	}
+	_stores++;
+	
+	if ((unsigned long long) (_size += (long long) data.size () - replaced) > _maxBytes)
+	    evict ();
+}
+
+// remove the least recently used entries until the directory is 10% under its size limit
+void CompileCache::evict ()
+{
+    std::unique_lock<std::mutex> guard (_evicting, std::try_to_lock);
+	if (!guard.owns_lock ())
+	    return;  // another thread is doing it
+		
+	struct Entry {
+	    std::string path;
+		long long size;
+		struct timespec used;
+		bool operator< (const Entry &other) const {
+		    if (used.tv_sec != other.used.tv_sec)
+			    return used.tv_sec < other.used.tv_sec;
+			return used.tv_nsec < other.used.tv_nsec;
+		}
+	};
+	std::vector<Entry> entries;
+	long long total = 0;
+	
+	DIR *d = opendir (_dir.c_str ());
+	if (d == NULL)
+	    return;
+	struct dirent *dirent;
+	while ((dirent = readdir (d)) != NULL) {
+	    if (dirent->d_name [0] == '.' || strncmp (dirent->d_name, "tmp.", 4) == 0)
+		    continue;
+	    Entry e;
+		e.path = _dir + "/" + dirent->d_name;
+		struct stat st;
+		if (stat (e.path.c_str (), &st) != 0 || !S_ISREG (st.st_mode))
+		    continue;
+		e.size = st.st_size;
+		e.used = st.st_mtim;
+		total += e.size;
+		entries.push_back (e);
+	}
+	closedir (d);
+	
+	std::sort (entries.begin (), entries.end ());
+	long long limit = (long long) (_maxBytes / 10 * 9);
+	for (size_t i = 0; i < entries.size () && total > limit; i++) {
+	    if (remove (entries [i].path.c_str ()) == 0) {
+		    total -= entries [i].size;
+			_evictions++;
+		}
+	}
+	_size = total;
+}
+
+void CompileCache::printStats (FILE *f)
+{
+    long lookups = _hits + _misses;
+	fprintf (f, "cache: %ld hits, %ld misses (%.1f%% hit rate), %ld stores, %ld evictions, %lld bytes\n",
+	         (long) _hits, (long) _misses, lookups > 0 ? 100.0 * _hits / lookups : 0.0, 
+			 (long) _stores, (long) _evictions, (long long) _size);
+}
+
+int compileCached (CompilerContext &ctx, FILE *in, CompileCache *cache)
+{
+    // with -pgo the code depends on the profile file too, which is not part of the key
+    if (cache == NULL || ctx.options.pgo)
+	    return ctx.compile (in);
+		
+	std::string source, key;
+	int errors;
+	std::string code, messages;
+	bool hit;
+	{
+	    TraceSpan span ("cache lookup");
+	    if (!readFile (in, source))
+	        return ctx.compile (in);  // let the compiler report the problem
+	    key = cache->key (source, ctx.options);
+		hit = cache->lookup (key, errors, code, messages);
+		span.arg ("hit", hit);
+	}
+	if (hit) {
+	    TraceSpan span ("output");
+	    ctx.reset ();
+		ctx.errors = errors;
+	    fwrite (code.data (), 1, code.size (), ctx.out);
+	    fwrite (messages.data (), 1, messages.size (), ctx.err);
+		return errors;
+	}
+	
+	// compile, keeping a copy of the code and the messages for the cache
+	char *codebuf = NULL, *messagesbuf = NULL;
+	size_t codeLen = 0, messagesLen = 0;
+	FILE *out = ctx.out, *err = ctx.err;
+	ctx.out = open_memstream (&codebuf, &codeLen);
+	ctx.err = open_memstream (&messagesbuf, &messagesLen);
+	
+	FILE *source_in = fmemopen ((void *) source.data (), source.size (), "r");
+	if (source_in == NULL)  // an empty file
+	    source_in = fopen ("/dev/null", "r");
+	errors = ctx.compile (source_in);
+	fclose (source_in);
+	
+	fclose (ctx.out);
+	fclose (ctx.err);
+	ctx.out = out;
+	ctx.err = err;
+	
+	fwrite (codebuf, 1, codeLen, out);
+	fwrite (messagesbuf, 1, messagesLen, err);
+	{
+	    TraceSpan span ("cache store");
+	    cache->store (key, errors, std::string (codebuf, codeLen), std::string (messagesbuf, messagesLen));
+	}
+	free (codebuf);
+	free (messagesbuf);
+	return errors;
+}
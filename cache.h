@@ -0,0 +1,55 @@
+#ifndef __CACHE_H
+#define __CACHE_H 1
+
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "context.h"
+
+/*  A content addressed cache of compilations, kept in a local directory.
+    The key of an entry is a hash of the source program, the compiler version and the options
+    that change the generated code.  An entry holds the generated code and the error messages,
+    so a hit skips the scanner, the parser and the code generator.
+	
+    Entries are written to a temporary file and then renamed, so a reader (another thread or
+    another process using the same directory) never sees a half written entry.
+    When the directory grows beyond its size limit the least recently used entries are removed.
+    (a hit updates the modification time of the entry. That is the "use" time).
+    One CompileCache may be used by many threads at the same time.
+*/
+class CompileCache {
+public:
+    CompileCache (const char *dir, unsigned long long maxBytes);
+	
+	// the name of the entry for this source and these options
+	std::string key (const std::string &source, const CompileOptions &options);
+
+	// returns true (and the entry) if the cache has an entry for key
+	bool lookup (const std::string &key, int &errors, std::string &code, std::string &messages);
+	
+	void store (const std::string &key, int errors, const std::string &code, const std::string &messages);
+	
+	void printStats (FILE *f);
+	
+	bool ok () { return _ok; }  // false if the directory could not be used
+
+private:
+    void evict ();
+	
+    std::string _dir;
+	unsigned long long _maxBytes;
+	bool _ok;
+	
+	std::atomic<long long> _size;  // bytes in the directory (as far as this process knows)
+	std::mutex _evicting;          // only one thread removes entries at a time
+	
+	std::atomic<long> _hits, _misses, _stores, _evictions;
+};
+
+/*  compile the program read from 'in' with ctx (ctx->out and ctx->err get the code and the
+    error messages) using the cache when cache is not NULL. Returns the number of errors */
+int compileCached (CompilerContext &ctx, FILE *in, CompileCache *cache);
+
+#endif // not defined __CACHE_H
@@ -0,0 +1,422 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#include "context.h"
+#include "ast.tab.h"  // yy::Parser
+#include "pool.h"
+#include "irfile.h"
+#include "incremental.h"
+#include "trace.h"
+#include "ssa.h"
+#include "jumps.h"
+#include "ifconvert.h"
+
+// flex does not generate a header file so the scanner functions we use are declared here.
+// (a yyscan_t is a void *. YY_EXTRA_TYPE is CompilerContext *.  See ast.lex)
+int yylex_init_extra (CompilerContext *user_defined, void **scanner);
+void yyset_in (FILE *in_str, void *scanner);
+void yyset_out (FILE *out_str, void *scanner);
+int yylex_destroy (void *scanner);
+
+// the context of the compilation running on this thread
+static thread_local
+CompilerContext *currentContext = NULL;
+
+bool parseCompileOption (CompileOptions &options, const char *arg)
+{
+    if (strncmp (arg, "-gen-threads=", 13) == 0) {
+	    // 0 means one thread per hardware thread
+	    options.genThreads = atoi (arg + 13);
+		if (options.genThreads <= 0)
+		    options.genThreads = ThreadPool::hardwareThreads ();
+		return true;
+	}
+	if (strcmp (arg, "-binary-ir") == 0) {
+	    options.binaryIR = true;
+		return true;
+	}
+	if (strcmp (arg, "-stream") == 0) {
+	    options.streaming = true;
+		return true;
+	}
+	if (strcmp (arg, "-time-report") == 0 || strcmp (arg, "-time-report=table") == 0) {
+	    options.timeReport = TIME_REPORT_TABLE;
+		return true;
+	}
+	if (strcmp (arg, "-time-report=json") == 0) {
+	    options.timeReport = TIME_REPORT_JSON;
+		return true;
+	}
+	if (strcmp (arg, "-incremental") == 0) {
+	    options.incremental = true;
+		return true;
+	}
+	if (strcmp (arg, "-pgo") == 0) {
+	    options.pgo = true;
+		return true;
+	}
+	if (strcmp (arg, "-ssa") == 0) {
+	    options.ssa = true;
+		return true;
+	}
+	if (strcmp (arg, "-print-ssa") == 0) {
+	    options.printSSA = true;
+		return true;
+	}
+	if (strcmp (arg, "-rotate-loops") == 0) {
+	    options.rotateLoops = true;
+		return true;
+	}
+	if (strcmp (arg, "-thread-jumps") == 0) {
+	    options.threadJumps = true;
+		return true;
+	}
+	if (strcmp (arg, "-if-convert") == 0) {
+	    options.ifConvert = true;
+		return true;
+	}
+	if (strcmp (arg, "-flat-ast") == 0) {
+	    options.flatAST = true;
+		return true;
+	}
+    return false;
+}
+
+CompilerContext::CompilerContext ()
+{
+    out = stdout;
+	err = stderr;
+	keepCode = false;
+	errors = 0;
+	quiet = 0;
+	tempCounter = 0;
+	labelCounter = 0;
+	line = 0;
+	scanner = NULL;
+	statementsReused = statementsTotal = 0;
+	_genPool = NULL;
+	_statements = NULL;
+	profile = NULL;
+}
+
+CompilerContext::~CompilerContext ()
+{
+    delete _genPool;
+}
+
+void CompilerContext::reset ()
+{
+    errors = 0;
+	quiet = 0;
+	symbolTable.clear ();
+	names.clear ();
+	tempCounter = 0;
+	labelCounter = 0;
+	line = 0;
+	while (!exitlabels.empty ())
+	    exitlabels.pop ();
+	conditionsSeen.clear ();
+	code.clear ();
+	statementsReused = statementsTotal = 0;
+	stats.clear ();
+	arena.reset ();
+	flatAST.clear ();
+	exps.clear ();
+}
+
+CompilerContext *CompilerContext::current ()
+{
+    return currentContext;
+}
+
+int CompilerContext::compile (FILE *in)
+{
+    CompilerContext *saved = currentContext;
+	currentContext = this;
+	
+	reset ();
+	stats.clear (options.timeReport != TIME_REPORT_NONE);
+	stats.start ();
+
+	yylex_init_extra (this, &scanner);
+	yyset_in (in, scanner);
+	yyset_out (out, scanner);
+	
+	Profile loaded;
+	if (options.pgo && !profileFile.empty ()) {
+	    if (readProfile (profileFile.c_str (), loaded))
+		    profile = &loaded;
+		else
+		    fprintf (err, "warning: cannot read the profile %s\n", profileFile.c_str ());
+	}
+	
+	// (the code of a statement depends on the profile too: it is not part of the key)
+	StatementCache statements;
+	if (options.incremental && !options.pgo && !incrementalFile.empty ()) {
+	    TraceSpan span ("statement cache load", incrementalFile.c_str ());
+	    statements.load (incrementalFile.c_str (), options.rotateLoops ? STATEMENT_CODE_ROTATE_LOOPS : 0);
+		_statements = &statements;
+	}
+	
+	{
+	    // (the code is generated and written during the parse: see generate () and echo ())
+	    TraceSpan span ("parse");
+	    PhaseTimer timer (stats, PHASE_PARSE);
+	    yy::Parser parser (scanner, this);
+		parser.parse ();
+		stats.astBytes = std::max (stats.astBytes, (long) (arena.bytesAllocated () + flatAST.bytes () + exps.bytes ()));
+		span.arg ("tokens", stats.tokens);
+		span.arg ("errors", errors);
+	}
+	
+	// with errors not all statements were looked up: the cache would lose the others
+	if (_statements != NULL && errors == 0) {
+	    TraceSpan span ("statement cache save", incrementalFile.c_str ());
+	    _statements->save (incrementalFile.c_str ());
+	}
+	_statements = NULL;
+	profile = NULL;
+	
+	TraceSpan span ("output");
+	if (keepCode)
+	    ;
+	else if (options.binaryIR) {
+	    PhaseTimer timer (stats, PHASE_OUTPUT);
+	    long bytes = writeBinaryIR (out, code, symbolTable, tempCounter, labelCounter);
+		if (bytes > 0)
+		    stats.bytes += bytes;
+		stats.instructions += code.size ();
+		code.clear ();
+	} else
+	    writeCode ();
+	fflush (out);
+	span.arg ("bytes", stats.bytes);
+	
+	yylex_destroy (scanner);
+	scanner = NULL;
+	
+	stats.temps = tempCounter;
+	stats.labels = labelCounter;
+	stats.stop ();
+
+	currentContext = saved;
+	return errors;
+}
+
+bool CompilerContext::streamStatement (Stmt *stmt)
+{
+    if (!options.streaming || options.ssa || options.printSSA || options.threadJumps || options.ifConvert)
+	    return false;
+	if (errors == 0) {
+	    {
+	        PhaseTimer timer (stats, PHASE_CODEGEN);
+	        if (_statements != NULL)
+		        generateIncremental (&stmt, 1);
+		    else
+	            stmt->genStmt ();
+		}
+		writeCode ();
+	}
+	/*  the statement is the only part of the AST left: the declarations were done with when
+	    the block started and the parser keeps no pointer to the statements before it.
+	    (names in the code are not in the arena, see internName ()) */
+	stats.astBytes = std::max (stats.astBytes, (long) (arena.bytesAllocated () + flatAST.bytes () + exps.bytes ()));
+	arena.reset ();
+	flatAST.clear ();
+	exps.clear ();
+	return true;
+}
+
+void CompilerContext::finishCode ()
+{
+    // (code with errors is written as it was generated: it need not type check)
+    if (errors > 0 || (!options.ssa && !options.printSSA && !options.threadJumps && !options.ifConvert))
+	    return;
+	PhaseTimer timer (stats, PHASE_OPTIMIZE);
+	if (options.ssa || options.printSSA) {
+	    TraceSpan span ("ssa");
+	    SSAForm ssa;
+		std::string error;
+		if (!ssa.build (code, symbolTable, error) || !ssa.verify (error)) {
+		    fprintf (err, "internal compiler error: ssa: %s\n", error.c_str ());
+			errors++;
+			return;
+		}
+		span.arg ("blocks", ssa.blocks.size ());
+		span.arg ("values", ssa.valueTypes.size () - 1);
+		span.arg ("removed", ssa.removeDeadCode ());
+		if (options.printSSA && !options.binaryIR && !keepCode) {
+		    ssa.print (out);
+			code.clear ();
+			return;
+		}
+		ssa.toCode (code, tempCounter, labelCounter, symbolTable);
+	}
+	if (options.threadJumps) {
+	    TraceSpan span ("thread jumps");
+		span.arg ("changes", threadJumps (code, symbolTable, labelCounter));
+	}
+	if (options.ifConvert) {
+	    TraceSpan span ("if conversion");
+		span.arg ("converted", convertIfs (code, symbolTable, tempCounter));
+	}
+}
+
+void CompilerContext::writeCode ()
+{
+    if (options.binaryIR || keepCode)
+	    return;
+	PhaseTimer timer (stats, PHASE_OUTPUT);
+    stats.bytes += printCode (out, code);
+	stats.instructions += code.size ();
+	code.clear ();
+}
+
+void CompilerContext::echo (const char *text, size_t len)
+{
+    if (options.binaryIR || keepCode)
+	    return;
+	writeCode ();  // the code generated so far goes before the text
+	PhaseTimer timer (stats, PHASE_OUTPUT);
+	stats.bytes += fwrite (text, 1, len, out);
+}
+
+// a part of the program whose code is generated in a context of its own (see generate ())
+struct GenPart {
+    GenPart (Stmt **stmts, size_t count) { this->stmts = stmts; this->count = count; ctx = NULL; }
+
+    Stmt **stmts;  // the statements of the part
+	size_t count;
+	CompilerContext *ctx;  // its code, counters and error count
+	std::string messages;  // its error messages
+};
+
+// runs on a thread of the pool (or on the thread of the compilation)
+static
+void generatePart (GenPart &part, const CompileOptions &options, const Profile *profile)
+{
+    TraceSpan span ("codegen part");
+	span.arg ("statements", part.count);
+    part.ctx = new CompilerContext;
+	part.ctx->options = options;
+	part.ctx->profile = profile;
+	char *buf = NULL;
+	size_t len = 0;
+	part.ctx->err = open_memstream (&buf, &len);
+	
+	CompilerContext *saved = currentContext;
+	currentContext = part.ctx;
+	for (size_t s = 0; s < part.count; s++)
+	    part.stmts [s]->genStmt ();
+	currentContext = saved;
+	
+	fclose (part.ctx->err);
+	part.ctx->err = NULL;
+	part.messages.assign (buf, len);
+	free (buf);
+}
+
+// add the code of a part (renumbered) and its messages to ctx
+static
+void appendPart (CompilerContext &ctx, GenPart &part)
+{
+    appendRenumbered (ctx.code, part.ctx->code, ctx.tempCounter, ctx.labelCounter);
+	ctx.tempCounter += part.ctx->tempCounter;
+	ctx.labelCounter += part.ctx->labelCounter;
+	fwrite (part.messages.data (), 1, part.messages.size (), ctx.err);
+	ctx.errors += part.ctx->errors;
+	ctx.stats.add (part.ctx->stats);  // (its emits: it has no timing)
+	delete part.ctx;
+	part.ctx = NULL;
+}
+
+void CompilerContext::generateParts (std::vector<GenPart> &parts)
+{
+    if (options.genThreads <= 1 || parts.size () < 2) {
+	    for (size_t i = 0; i < parts.size (); i++)
+		    generatePart (parts [i], options, profile);
+		return;
+	}
+	if (_genPool == NULL || _genPool->size () != options.genThreads) {
+	    delete _genPool;
+		_genPool = new ThreadPool (options.genThreads);
+	}
+	_genPool->run (parts.size (), [&] (int i, int worker) {
+	    generatePart (parts [i], options, profile);
+	});
+}
+
+void CompilerContext::generateIncremental (Stmt **stmts, size_t count)
+{
+    std::vector<Hash128> keys (count);
+	std::vector<GenPart> misses;
+	std::vector<int> missOf (count, -1);  // index in misses of each statement not in the cache
+	for (size_t i = 0; i < count; i++) {
+	    keys [i] = fingerprint (stmts [i]);
+		if (!_statements->contains (keys [i])) {
+		    missOf [i] = misses.size ();
+			misses.push_back (GenPart (&stmts [i], 1));
+		}
+	}
+	generateParts (misses);
+	
+	TraceSpan span ("splice");
+	for (size_t i = 0; i < count; i++) {
+	    if (missOf [i] < 0) {
+		    _statements->splice (keys [i], code, tempCounter, labelCounter);
+			continue;
+		}
+		GenPart &part = misses [missOf [i]];
+		// the messages of a statement (warnings too) are printed each time it is compiled
+		if (part.ctx->errors == 0 && part.messages.empty ())
+		    _statements->add (keys [i], part.ctx->code, part.ctx->tempCounter, part.ctx->labelCounter);
+		appendPart (*this, part);
+	}
+	statementsTotal += count;
+	statementsReused += count - misses.size ();
+	span.arg ("reused", count - misses.size ());
+}
+
+void CompilerContext::generate (Stmt *program)
+{
+    TraceSpan span ("codegen");
+    PhaseTimer timer (stats, PHASE_CODEGEN);
+    Block *block = dynamic_cast<Block *> (program);
+	std::vector<Stmt *> stmts;
+	if (block != NULL)
+	    for (Stmt *stmt = block->_stmtlist; stmt != NULL; stmt = stmt->_next)
+		    stmts.push_back (stmt);
+	span.arg ("statements", stmts.size ());
+	
+	if (_statements != NULL) {
+	    if (block == NULL)
+		    stmts.push_back (program);
+		if (!stmts.empty ())
+		    generateIncremental (&stmts [0], stmts.size ());
+		return;
+	}
+	
+	if (options.genThreads <= 1 || stmts.size () < 2) {
+	    program->genStmt ();
+		return;
+	}
+	
+	/*  a few parts per thread, so a thread that is done with a short part can take another one.
+	    The statements of a part follow each other in the block. The code of the outermost block
+	    is just the code of its statements, one after the other, and no jump goes from one
+		statement of the block to another one (a break is not in a loop there) */
+	int nparts = std::min ((int) stmts.size (), 4 * options.genThreads);
+	std::vector<GenPart> parts;
+	for (int i = 0; i < nparts; i++) {
+	    size_t begin = stmts.size () * i / nparts;
+		size_t end = stmts.size () * (i + 1) / nparts;
+		parts.push_back (GenPart (&stmts [begin], end - begin));
+	}
+	generateParts (parts);
+	
+	// put the parts together in order
+	for (int i = 0; i < nparts; i++)
+	    appendPart (*this, parts [i]);
+}
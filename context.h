@@ -0,0 +1,181 @@
+#ifndef __CONTEXT_H
+#define __CONTEXT_H 1
+
+#include <stdio.h>
+#include <map>
+#include <set>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "gen.h"  // for myType
+#include "arena.h"
+#include "ir.h"
+#include "stats.h"
+#include "profile.h"
+#include "flatast.h"
+#include "hashcons.h"
+
+class Stmt;
+class ThreadPool;
+class StatementCache;
+struct GenPart;
+
+/*  version of the compiler. It is part of the key of the compilation cache (see cache.h)
+    so it must be changed whenever the code generated for some program changes
+	(1.4: a literal that overflows is an error, 1.5: float constants are printed exactly) */
+#define COMPILER_VERSION "1.5"
+
+/*  options of one compilation. They are set by command line options or by OPTION lines
+    sent to the server (see server.h) */
+struct CompileOptions {
+    CompileOptions () { genThreads = 1; binaryIR = false; streaming = false; incremental = false; pgo = false; ssa = false; printSSA = false; rotateLoops = false; threadJumps = false; ifConvert = false; flatAST = false; timeReport = TIME_REPORT_NONE; }
+	
+    int genThreads;  // -gen-threads=N : threads generating code (see CompilerContext::generate ())
+	bool binaryIR;   // -binary-ir : the output is a binary IR file (see irfile.h), not text
+	bool streaming;  // -stream : see CompilerContext::streamStatement ()
+	bool incremental;  // -incremental : see incremental.h
+	bool pgo;        // -pgo : use the profile of the program (see profile.h)
+	bool ssa;        // -ssa : the code goes through SSA form (see ssa.h and CompilerContext::finishCode ())
+	bool printSSA;   // -print-ssa : the output is the SSA form of the code, not the code
+	bool rotateLoops;  // -rotate-loops : test the condition of a loop at its bottom (see genLoop () in gen.cpp)
+	bool threadJumps;  // -thread-jumps : thread jumps and remove labels (see jumps.h)
+	bool ifConvert;  // -if-convert : replace simple ifs by selects (see ifconvert.h)
+	bool flatAST;    // -flat-ast : the parser puts expressions in flat form (see flatast.h). The code is the same
+	int timeReport;  // -time-report[=json] : time the phases of the compilation (see stats.h)
+
+    /* a string made of the options that change the generated code. It is part of the key of
+       the compilation cache */
+    std::string key () const { return std::string (binaryIR ? "binary-ir " : "") + (streaming ? "stream " : "") + (pgo ? "pgo " : "")
+                                  + (ssa ? "ssa " : "") + (printSSA ? "print-ssa " : "")
+                                  + (rotateLoops ? "rotate-loops " : "") + (threadJumps ? "thread-jumps " : "")
+                                  + (ifConvert ? "if-convert " : ""); }
+};
+
+/*  if arg is a compilation option, set it in options and return true.
+    Otherwise return false */
+bool parseCompileOption (CompileOptions &options, const char *arg);
+
+/*  A CompilerContext holds all the state of one compilation: the error count, the symbol table,
+    the counters used by newTemp() and newlabel(), the stack of exit labels used by break
+    statements and the (reentrant) scanner.
+
+    Several compilations may run at the same time in one process, each on its own thread and
+    with its own CompilerContext.  The parser and the scanner get the context as a parameter.
+    The code in ast.cpp, gen.cpp and symtab.cpp (AST constructors, genExp(), genStmt() ...)
+    uses the context of the compilation running on the current thread:  CompilerContext::current ().
+*/
+class CompilerContext {
+public:
+    CompilerContext ();
+	~CompilerContext ();
+
+	/* compile the program read from 'in'. Generated code is written to this->out,
+	   error messages to this->err.  Returns the number of errors found.
+	   A context may be used for many compilations (one after the other):  compile() starts
+	   by calling reset() */
+	int compile (FILE *in);
+	
+	// forget everything about the previous compilation (the AST, the symbol table ...)
+	void reset ();
+
+	// returns the context of the compilation running on this thread (NULL if there is none)
+	static CompilerContext *current ();
+	
+	/*  generate the code of the program (its statement). 
+	    With options.genThreads > 1 the statements of the outermost block are split into
+	    parts and the code of each part is generated on its own thread, into its own context
+	    with temporaries and labels numbered from 1. The parts are then put together in order
+	    and renumbered, so the code is the same as the code generated by one thread.
+		With options.incremental each statement of the outermost block is a part: its code
+		is taken from the statement cache (see incremental.h) when it is there */
+	void generate (Stmt *program);
+	
+	/*  called by the parser when a statement of the outermost block of the program ends.
+	    With options.streaming its code is generated and written at once and the AST is freed
+		(so the memory used does not grow with the size of the program).  Returns true in
+		that case:  the parser does not keep the statement.  Otherwise returns false.
+		Once an error was found no code is generated (as without streaming). But the code
+		written before the error is not taken back */
+	bool streamStatement (Stmt *stmt);
+
+	/*  called by the parser once the code of the whole program was generated (its halt too).
+	    Runs the passes over the code of the whole program asked for by the options:  with
+		options.ssa the code is put in SSA form, dead code is removed from it and it is put out
+		of SSA form (see ssa.h).  With options.printSSA the SSA form is written instead of the code.
+		With options.threadJumps jumps are threaded and labels cleaned up (see jumps.h).
+		Last, with options.ifConvert the ifs that assign one variable become selects (see ifconvert.h).
+		With any of them a program is not streamed (see streamStatement ()).  Code with errors is
+		left as it is */
+	void finishCode ();
+	
+	// print the code generated so far to out (and forget it).  With a binary output the
+	// code is kept: it is written when the compilation ends
+	void writeCode ();
+	
+	// copy text of the source program to the output (only when the output is text)
+	void echo (const char *text, size_t len);
+
+	CompileOptions options;  // not changed by reset ()
+
+	// the code is not written: it is kept in 'code' (for the interpreter, see interp.h).
+	// Not changed by reset ()
+	bool keepCode;
+	
+	FILE *out;  // generated code goes here (default: stdout)
+	FILE *err;  // error messages go here (default: stderr)
+
+	int errors; // number of errors
+	int quiet;  // > 0: the messages of the code generated are dropped (see Quiet in gen.cpp)
+
+	/*  -incremental: the statement cache file of the program (usually the name of the source file
+	    followed by ".inc").  No cache is used when it is empty.  Not changed by reset () */
+	std::string incrementalFile;
+	int statementsReused;  // statements whose code was found in the statement cache
+	int statementsTotal;   // statements looked up in the statement cache
+
+	/*  -pgo: the profile file of the program (usually the name of the source file followed by
+	    ".prof").  Not changed by reset () */
+	std::string profileFile;
+	const Profile *profile;  // the profile read from it during compile () (NULL: none)
+	std::map<int, int> conditionsSeen;  // conditions generated so far on each line (see gen.cpp)
+
+	CompileStats stats;  // counters and phase times of the compilation (cleared by reset ())
+
+	std::map<std::string, myType> symbolTable;
+	std::set<std::string> names;  // see internName ()
+
+	int tempCounter;  // last temporary returned by newTemp()
+	int labelCounter; // last label returned by newlabel()
+	int line;         // source line of the code being generated (see setLine () in gen.cpp)
+
+    /*  This stack is used to implement  break statements.
+        "break"  is implemented as a goto to the exit label of the most closely enclosing loop (or switch statement).
+        This label is the top of the stack. Below it on the stack is the exit label of the enclosing loop and so on.
+        The stack is empty when we are not inside a  loop (or switch statement).
+    */
+	std::stack<int> exitlabels;
+	
+	std::vector<Instr> code;  // the generated code. See emit ()
+
+	void *scanner;  // the flex scanner (a yyscan_t).  Valid only during compile()
+	
+	Arena arena;  // AST nodes are allocated here
+	FlatAST flatAST;  // -flat-ast: the nodes of expressions are here (cleared with the arena)
+	ExpFactory exps;  // makes the nodes of expressions (without -flat-ast), see hashcons.h
+
+private:
+    CompilerContext (const CompilerContext &);  // not copyable
+	CompilerContext &operator= (const CompilerContext &);
+	
+	// generate the code of each part (on _genPool with options.genThreads > 1)
+	void generateParts (std::vector<GenPart> &parts);
+	
+	// generate the code of statements of the outermost block using _statements
+	void generateIncremental (Stmt **stmts, size_t count);
+	
+	ThreadPool *_genPool;  // used by generate ().  Created when it is first needed
+	StatementCache *_statements;  // the statement cache during compile () (NULL: none)
+};
+
+#endif // not defined __CONTEXT_H
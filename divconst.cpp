@@ -0,0 +1,47 @@
+#include "divconst.h"
+
+bool divMagic (int d, DivMagic &magic)
+{
+    magic.multiplier = 0;
+	magic.shift = 0;
+	magic.add = 0;
+	if (d == 0 || d == 1 || d == -1)
+	    return false;
+
+	/*  the smallest p >= 32 with  2^p > nc * (|d| - 2^p mod |d|),  nc the largest n (or the
+	    smallest, for d < 0) with n mod |d| = |d| - 1.  Then M = 2^p / |d| + 1 and s = p - 32.
+		q1, r1: 2^p / |nc| and its remainder, q2, r2: 2^p / |d| and its remainder */
+	const unsigned two31 = 0x80000000u;
+	unsigned ad = d < 0 ? 0u - (unsigned) d : (unsigned) d;
+	unsigned t = two31 + ((unsigned) d >> 31);
+	unsigned anc = t - 1 - t % ad;
+	int p = 31;
+	unsigned q1 = two31 / anc, r1 = two31 - q1 * anc;
+	unsigned q2 = two31 / ad, r2 = two31 - q2 * ad;
+	unsigned delta;
+	do {
+	    p++;
+		q1 = 2 * q1;
+		r1 = 2 * r1;
+		if (r1 >= anc) {
+		    q1++;
+			r1 -= anc;
+		}
+		q2 = 2 * q2;
+		r2 = 2 * r2;
+		if (r2 >= ad) {
+		    q2++;
+			r2 -= ad;
+		}
+		delta = ad - r2;
+	} while (q1 < delta || (q1 == delta && r1 == 0));
+
+	unsigned m = q2 + 1;
+	magic.multiplier = (int) (d < 0 ? 0u - m : m);
+	magic.shift = p - 32;
+	if (d > 0 && magic.multiplier < 0)
+	    magic.add = 1;
+	else if (d < 0 && magic.multiplier > 0)
+	    magic.add = -1;
+	return true;
+}
@@ -0,0 +1,42 @@
+#ifndef __DIVCONST_H
+#define __DIVCONST_H 1
+
+/*  An int divided by a constant with a multiplication (Granlund and Montgomery, "Division by
+    invariant integers using multiplication", 1994;  the magic numbers are computed as in
+	Hacker's Delight, 10-1).
+
+    For a divisor d that is not 0, 1 or -1 there are a multiplier M and a shift s such that for
+	every int n,  n / d  is
+	    q = the high 32 bits of the 64-bit product M * n
+		q = q + n  if d > 0 and M < 0,   q - n  if d < 0 and M > 0
+		q = q >> s                        (arithmetic)
+		q = q + 1  if q < 0               (so the quotient is rounded toward 0, as by /)
+	and  n % d  is  n - q * d.  That is 5 or 6 simple instructions instead of an idiv (which takes
+	from 10 to 90 cycles, depending on the machine).  The interpreter computes an int / or % this way when its divisor is a
+	temporary assigned only by a constant (see interp.cpp), and so does the JIT (see jit.cpp).
+*/
+struct DivMagic {
+    int multiplier;     // M.  0: no magic (the divisor is not a constant, or it is 0, 1 or -1)
+	unsigned char shift;  // s
+	signed char add;    // 1: add n to the high half, -1: subtract it, 0: neither
+};
+
+// the magic of divisor d.  Returns false (and a multiplier 0) if d is 0, 1 or -1
+bool divMagic (int d, DivMagic &magic);
+
+// n / d  (magic: the magic of d)
+inline int divideByMagic (int n, const DivMagic &magic)
+{
+    int q = (int) (((long long) magic.multiplier * n) >> 32);
+	q = (int) ((unsigned) q + (unsigned) magic.add * (unsigned) n);  // (wraps around)
+	q >>= magic.shift;
+	return q + (int) ((unsigned) q >> 31);
+}
+
+// n % d
+inline int moduloByMagic (int n, int d, const DivMagic &magic)
+{
+    return (int) ((unsigned) n - (unsigned) divideByMagic (n, magic) * (unsigned) d);
+}
+
+#endif // not defined __DIVCONST_H
@@ -0,0 +1,88 @@
+/*  make check-divconst:  divideByMagic () and moduloByMagic () (see divconst.h) against / and %
+    for
+	    every divisor from 2 to 1000 and from -2 to -1000, and every n from -5000 to 5000
+		every divisor from 2 to 2^20 and from -2 to -2^20, the powers of 2, INT_MIN, INT_MAX and
+		the divisors near them, with the n where an error shows first:  INT_MIN, INT_MAX, 0, +-1
+		and the multiples of d (and their neighbours) near 0, INT_MIN and INT_MAX
+	(INT_MIN / -1 has no int result: -1 has no magic, so it is never computed this way)
+	The output is the number of pairs checked, or the first wrong ones.  Exit status 1 if any
+*/
+#include <limits.h>
+#include <stdio.h>
+
+#include "divconst.h"
+
+static long long checked = 0, wrong = 0;
+
+static
+void check (long long n, int d, const DivMagic &magic)
+{
+    if (n < INT_MIN || n > INT_MAX)
+	    return;
+	int q = divideByMagic ((int) n, magic), r = moduloByMagic ((int) n, d, magic);
+	checked++;
+	if (q != (int) n / d || r != (int) n % d) {
+	    if (wrong++ < 10)
+		    printf ("%lld / %d: %d remainder %d, not %d remainder %d\n", n, d, q, r, (int) n / d, (int) n % d);
+	}
+}
+
+// the edge values of n for d
+static
+void checkEdges (int d)
+{
+    DivMagic magic;
+	if (!divMagic (d, magic)) {
+	    printf ("no magic for %d\n", d);
+		wrong++;
+		return;
+	}
+	long long ld = d;
+	long long around [] = { 0, ld, -ld, 2 * ld, -2 * ld, (INT_MAX / ld) * ld, (INT_MIN / ld) * ld,
+	                        INT_MAX, INT_MIN };
+	for (size_t i = 0; i < sizeof around / sizeof around [0]; i++)
+	    for (long long n = around [i] - 2; n <= around [i] + 2; n++)
+		    check (n, d, magic);
+}
+
+int main ()
+{
+    for (int d = 2; d <= 1000; d++)
+	    for (int sign = 1; sign >= -1; sign -= 2) {
+		    DivMagic magic;
+			divMagic (sign * d, magic);
+			for (int n = -5000; n <= 5000; n++)
+			    check (n, sign * d, magic);
+		}
+
+	for (int d = 2; d <= 1 << 20; d++) {
+	    checkEdges (d);
+		checkEdges (-d);
+	}
+	for (int k = 1; k <= 31; k++) {
+	    long long p = 1LL << k;
+		for (long long d = p - 2; d <= p + 2; d++) {
+		    if (d >= 2 && d <= INT_MAX)
+			    checkEdges ((int) d);
+			if (-d >= INT_MIN && -d <= -2)
+			    checkEdges ((int) -d);
+		}
+	}
+	for (int i = 0; i < 3; i++) {
+	    checkEdges (INT_MAX - i);
+		checkEdges (INT_MIN + i);
+	}
+
+	// no magic for these (the interpreter and the JIT divide)
+	int none [] = { 0, 1, -1 };
+	for (int i = 0; i < 3; i++) {
+	    DivMagic magic;
+		if (divMagic (none [i], magic) || magic.multiplier != 0) {
+		    printf ("a magic for %d\n", none [i]);
+			wrong++;
+		}
+	}
+
+	printf ("%lld pairs checked, %lld wrong\n", checked, wrong);
+	return wrong > 0 ? 1 : 0;
+}
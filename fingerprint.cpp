@@ -0,0 +1,252 @@
+#include "ast.h"
+#include "incremental.h"
+
+/*  The description of a node is a letter for its kind followed by its fields (numbers in binary,
+    names ending with '\0') and then the descriptions of its children.  Since each kind has a
+	fixed number of children the description of a tree can be read back in only one way, so two
+	trees with the same description are the same tree.
+	Line numbers are left out: moving a statement to another line does not change its code
+	(a statement that prints a message with a line number is not cached anyway). */
+
+static
+void addInt (std::string &f, int n)
+{
+    f.append ((const char *) &n, sizeof n);
+}
+
+static
+void addName (std::string &f, const char *name)
+{
+    f.append (name, strlen (name) + 1);
+}
+
+static
+void addStmt (std::string &f, Stmt *stmt)
+{
+    if (stmt == NULL)
+	    f += '0';
+	else
+	    stmt->fingerprint (f);
+}
+
+/*  the description of the tree under node: the description of each node is followed by those of
+    its operands, in order.  The tree is walked with an explicit stack (see "expressions" in ast.h) */
+template <class Node>
+static
+void addTree (std::string &f, Node *node)
+{
+    std::vector<Node *> stack (1, node);
+	while (!stack.empty ()) {
+	    node = stack.back ();
+		stack.pop_back ();
+		node->fingerprintNode (f);
+		int n = 0;
+		while (node->operand (n) != NULL)
+		    n++;
+		while (n > 0)  // the first operand is pushed last, so it comes first
+		    stack.push_back (node->operand (--n));
+	}
+}
+
+void Exp::fingerprint (std::string &f)
+{
+    addTree (f, this);
+}
+
+void BoolExp::fingerprint (std::string &f)
+{
+    addTree (f, this);
+}
+
+Hash128 fingerprint (Stmt *stmt)
+{
+    std::string f;
+	stmt->fingerprint (f);
+	return hash128 (f.data (), f.size ());
+}
+
+void BinaryOp::fingerprintNode (std::string &f)
+{
+    f += 'B';
+	addInt (f, _op);
+	addInt (f, _type);
+}
+
+void NumNode::fingerprintNode (std::string &f)
+{
+    f += 'N';
+	addInt (f, _type);
+	if (_type == _INT)
+	    addInt (f, _u.ival);
+	else
+	    f.append ((const char *) &_u.fval, sizeof _u.fval);
+}
+
+// the type is the type the variable has in the symbol table (see IdNode::IdNode ())
+void IdNode::fingerprintNode (std::string &f)
+{
+    f += 'I';
+	addInt (f, _type);
+	addName (f, _name);
+}
+
+void SimpleBoolExp::fingerprintNode (std::string &f)
+{
+    f += 'S';
+	addInt (f, _op);
+	_left->fingerprint (f);
+	_right->fingerprint (f);
+}
+
+void Or::fingerprintNode (std::string &f)
+{
+    f += '|';
+}
+
+void And::fingerprintNode (std::string &f)
+{
+    f += '&';
+}
+
+void Not::fingerprintNode (std::string &f)
+{
+    f += '!';
+}
+
+void Fand::fingerprintNode (std::string &f)
+{
+    f += 'F';
+}
+
+void FlatExp::fingerprintNode (std::string &f)
+{
+    _tree->fingerprint (_node, f);
+}
+
+void FlatBoolExp::fingerprintNode (std::string &f)
+{
+    _tree->fingerprint (_node, f);
+}
+
+// the same description as the tree of AST objects would have (a FlatExp has the same code)
+void FlatAST::fingerprint (FlatNode node, std::string &f) const
+{
+    std::vector<FlatNode> stack (1, node);
+	while (!stack.empty ()) {
+	    node = stack.back ();
+		stack.pop_back ();
+		uint32_t n = index (node);
+		switch (kind (node)) {
+		    case FLAT_BINARY:
+			    f += 'B';
+				addInt (f, _binary.op [n]);
+				addInt (f, _binary.type [n]);
+				break;
+			case FLAT_NUM:
+			    f += 'N';
+				addInt (f, _num.type [n]);
+				if (_num.type [n] == _INT)
+				    addInt (f, (int) _num.value [n]);
+				else
+				    f.append ((const char *) &_num.value [n], sizeof _num.value [n]);
+				break;
+			case FLAT_ID:
+			    f += 'I';
+				addInt (f, _id.type [n]);
+				addName (f, _id.name [n]);
+				break;
+			case FLAT_SIMPLEBOOL:
+			    f += 'S';
+				addInt (f, _simple.op [n]);
+				break;
+			case FLAT_OR:
+			    f += '|';
+				break;
+			case FLAT_AND:
+			    f += '&';
+				break;
+			case FLAT_NOT:
+			    f += '!';
+				break;
+			case FLAT_FAND:
+			    f += 'F';
+				break;
+		}
+		int count = 0;
+		while (operand (node, count) != NO_NODE)
+		    count++;
+		while (count > 0)  // the first operand is pushed last, so it comes first
+		    stack.push_back (operand (node, --count));
+	}
+}
+
+void ReadStmt::fingerprint (std::string &f)
+{
+    f += 'r';
+	_id->fingerprint (f);
+}
+
+void WriteStmt::fingerprint (std::string &f)
+{
+    f += 'w';
+	_exp->fingerprint (f);
+}
+
+void AssignStmt::fingerprint (std::string &f)
+{
+    f += '=';
+	_lhs->fingerprint (f);
+	_rhs->fingerprint (f);
+}
+
+void IfStmt::fingerprint (std::string &f)
+{
+    f += 'i';
+	_condition->fingerprint (f);
+	addStmt (f, _thenStmt);
+	addStmt (f, _elseStmt);
+}
+
+void WhileStmt::fingerprint (std::string &f)
+{
+    f += 'l';
+	_condition->fingerprint (f);
+	addStmt (f, _body);
+}
+
+void ForStmt::fingerprint (std::string &f)
+{
+    f += 'f';
+	addStmt (f, _init);
+	_condition->fingerprint (f);
+	addStmt (f, _afterStep);
+	addStmt (f, _body);
+}
+
+// the statements of the block end with '}'
+void Block::fingerprint (std::string &f)
+{
+    f += '{';
+	for (Stmt *stmt = _stmtlist; stmt != NULL; stmt = stmt->_next)
+	    stmt->fingerprint (f);
+	f += '}';
+}
+
+void BreakStmt::fingerprint (std::string &f)
+{
+    f += 'b';
+}
+
+void SwitchStmt::fingerprint (std::string &f)
+{
+    f += 's';
+	_exp->fingerprint (f);
+	for (Case *c = _caselist; c != NULL; c = c->_next) {
+	    f += 'c';
+		addInt (f, c->_number);
+		f += c->_hasBreak ? '1' : '0';
+		addStmt (f, c->_stmt);
+	}
+	f += 'd';
+	addStmt (f, _default_stmt);
+}
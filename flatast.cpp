@@ -0,0 +1,274 @@
+#include <stdio.h>
+#include <stdlib.h> // exit ()
+
+#include "flatast.h"
+#include "ast.h"
+#include "context.h"
+
+FlatNode FlatAST::make (FlatKind kind, size_t index)
+{
+    if (index > INDEX_MASK) {
+	    fprintf (stderr, "internal compiler error: more than %u nodes of a kind in the flat AST\n", INDEX_MASK + 1);
+		exit (1);
+	}
+	return ((FlatNode) kind << KIND_SHIFT) | (FlatNode) index;
+}
+
+// a FlatExp for node: one to reuse if there is one
+FlatExp *FlatAST::newExp (FlatNode node, myType type)
+{
+    if (_freeExps.empty ())
+	    return new FlatExp (this, node, type);
+	FlatExp *exp = _freeExps.back ();
+	_freeExps.pop_back ();
+	exp->_node = node;
+	exp->_type = type;
+	return exp;
+}
+
+FlatBoolExp *FlatAST::newBoolExp (FlatNode node)
+{
+    if (_freeBoolExps.empty ())
+	    return new FlatBoolExp (this, node);
+	FlatBoolExp *exp = _freeBoolExps.back ();
+	_freeBoolExps.pop_back ();
+	exp->_node = node;
+	return exp;
+}
+
+// the node of an operand (with -flat-ast all expressions are FlatExps, see the parser)
+FlatNode FlatAST::nodeOf (Exp *exp)
+{
+	return static_cast<FlatExp *> (exp)->_node;
+}
+
+FlatNode FlatAST::nodeOf (BoolExp *exp)
+{
+	return static_cast<FlatBoolExp *> (exp)->_node;
+}
+
+FlatAST::FlatAST () : _binaryNodes (KeyOf (this)), _numNodes (KeyOf (this)), _idNodes (KeyOf (this))
+{
+}
+
+ExpKey FlatAST::keyOf (FlatNode node) const
+{
+    uint32_t n = index (node);
+	switch (kind (node)) {
+	    case FLAT_BINARY:
+		    return ExpKey::binary (op (_binary.op [n]), myType (_binary.type [n]), _binary.left [n], _binary.right [n]);
+		case FLAT_NUM:
+		    return ExpKey::num (myType (_num.type [n]), (int) _num.value [n], _num.value [n]);
+		case FLAT_ID:
+		    return ExpKey::id (_id.name [n], myType (_id.type [n]));
+		default:
+		    fprintf (stderr, "internal compiler error: flat node %x is not an expression\n", node); exit (1);
+	}
+}
+
+Exp *FlatAST::binaryOp (enum op op, Exp *left, Exp *right)
+{
+    PhaseTimer timer (CompilerContext::current ()->stats, PHASE_SEMANTIC);
+	myType type = left->_type != right->_type ? _FLOAT : left->_type;  // see BinaryOp::BinaryOp ()
+	ExpKey key = ExpKey::binary (op, type, nodeOf (left), nodeOf (right));
+	uint32_t hash = key.hash ();
+	FlatNode node;
+	if (_binaryNodes.find (key, hash, node))
+	    countShared ();
+	else {
+	    countNode (NODE_BINARYOP);
+		node = make (FLAT_BINARY, _binary.op.size ());
+		_binary.op.push_back (op);
+		_binary.type.push_back (type);
+		_binary.left.push_back (nodeOf (left));
+		_binary.right.push_back (nodeOf (right));
+		_binaryNodes.add (hash, node);
+	}
+	_freeExps.push_back (static_cast<FlatExp *> (right));
+	FlatExp *exp = static_cast<FlatExp *> (left);
+	exp->_node = node;
+	exp->_type = type;
+	return exp;
+}
+
+// a constant: ival if type is _INT, else fval
+FlatNode FlatAST::numNode (myType type, int ival, double fval)
+{
+	ExpKey key = ExpKey::num (type, ival, fval);
+	uint32_t hash = key.hash ();
+	FlatNode node;
+	if (_numNodes.find (key, hash, node)) {
+	    countShared ();
+		return node;
+	}
+    countNode (NODE_NUM);
+	node = make (FLAT_NUM, _num.type.size ());
+	_num.type.push_back (type);
+	_num.value.push_back (type == _INT ? ival : fval);
+	_numNodes.add (hash, node);
+	return node;
+}
+
+Exp *FlatAST::num (int ival)
+{
+	return newExp (numNode (_INT, ival, 0), _INT);
+}
+
+Exp *FlatAST::num (double fval)
+{
+	return newExp (numNode (_FLOAT, 0, fval), _FLOAT);
+}
+
+Exp *FlatAST::id (const char *name, int line)
+{
+    PhaseTimer timer (CompilerContext::current ()->stats, PHASE_SEMANTIC);
+	myType type = IdNode::lookup (name, line);
+	ExpKey key = ExpKey::id (name, type);
+	uint32_t hash = key.hash ();
+	FlatNode node;
+	if (_idNodes.find (key, hash, node))
+	    countShared ();
+	else {
+	    countNode (NODE_ID);
+		node = make (FLAT_ID, _id.name.size ());
+		_id.name.push_back (name);
+		_id.type.push_back (type);
+		_idNodes.add (hash, node);
+	}
+	return newExp (node, type);
+}
+
+BoolExp *FlatAST::simpleBoolExp (enum op op, Exp *left, Exp *right, int line)
+{
+    countNode (NODE_SIMPLEBOOLEXP);
+	FlatNode node = make (FLAT_SIMPLEBOOL, _simple.op.size ());
+	_simple.op.push_back (op);
+	_simple.left.push_back (nodeOf (left));
+	_simple.right.push_back (nodeOf (right));
+	_simple.line.push_back (line);
+	_freeExps.push_back (static_cast<FlatExp *> (left));
+	_freeExps.push_back (static_cast<FlatExp *> (right));
+	return newBoolExp (node);
+}
+
+// an or, and or nand node. The FlatBoolExp of left is reused for it
+FlatNode FlatAST::addPair (FlatKind kind, BoolExp *left, BoolExp *right)
+{
+    Pairs &pairs = kind == FLAT_OR ? _or : kind == FLAT_AND ? _and : _fand;
+	FlatNode node = make (kind, pairs.left.size ());
+	pairs.left.push_back (nodeOf (left));
+	pairs.right.push_back (nodeOf (right));
+	_freeBoolExps.push_back (static_cast<FlatBoolExp *> (right));
+	static_cast<FlatBoolExp *> (left)->_node = node;
+	return node;
+}
+
+BoolExp *FlatAST::orExp (BoolExp *left, BoolExp *right)
+{
+    countNode (NODE_OR);
+	addPair (FLAT_OR, left, right);
+	return left;
+}
+
+BoolExp *FlatAST::andExp (BoolExp *left, BoolExp *right)
+{
+    countNode (NODE_AND);
+	addPair (FLAT_AND, left, right);
+	return left;
+}
+
+BoolExp *FlatAST::fandExp (BoolExp *left, BoolExp *right)
+{
+    countNode (NODE_FAND);
+	addPair (FLAT_FAND, left, right);
+	return left;
+}
+
+BoolExp *FlatAST::notExp (BoolExp *operand)
+{
+    countNode (NODE_NOT);
+	FlatNode node = make (FLAT_NOT, _not.size ());
+	_not.push_back (nodeOf (operand));
+	static_cast<FlatBoolExp *> (operand)->_node = node;
+	return operand;
+}
+
+FlatNode FlatAST::operand (FlatNode node, int i) const
+{
+    uint32_t n = index (node);
+    switch (kind (node)) {
+	    case FLAT_BINARY:
+		    return i == 0 ? _binary.left [n] : i == 1 ? _binary.right [n] : NO_NODE;
+		case FLAT_SIMPLEBOOL:
+		    return i == 0 ? _simple.left [n] : i == 1 ? _simple.right [n] : NO_NODE;
+		case FLAT_OR:
+		    return i == 0 ? _or.left [n] : i == 1 ? _or.right [n] : NO_NODE;
+		case FLAT_AND:
+		    return i == 0 ? _and.left [n] : i == 1 ? _and.right [n] : NO_NODE;
+		case FLAT_FAND:
+		    return i == 0 ? _fand.left [n] : i == 1 ? _fand.right [n] : NO_NODE;
+		case FLAT_NOT:
+		    return i == 0 ? _not [n] : NO_NODE;
+		default:
+		    return NO_NODE;
+	}
+}
+
+myType FlatAST::typeOf (FlatNode node) const
+{
+    switch (kind (node)) {
+	    case FLAT_BINARY:
+		    return myType (_binary.type [index (node)]);
+		case FLAT_NUM:
+		    return myType (_num.type [index (node)]);
+		case FLAT_ID:
+		    return myType (_id.type [index (node)]);
+		default:
+		    return UNKNOWN;
+	}
+}
+
+void FlatAST::clear ()
+{
+    _binary.op.clear ();
+	_binary.type.clear ();
+	_binary.left.clear ();
+	_binary.right.clear ();
+	_num.type.clear ();
+	_num.value.clear ();
+	_id.name.clear ();
+	_id.type.clear ();
+	_simple.op.clear ();
+	_simple.left.clear ();
+	_simple.right.clear ();
+	_simple.line.clear ();
+	_or.left.clear ();
+	_or.right.clear ();
+	_and.left.clear ();
+	_and.right.clear ();
+	_fand.left.clear ();
+	_fand.right.clear ();
+	_not.clear ();
+	_freeExps.clear ();
+	_freeBoolExps.clear ();
+	_binaryNodes.clear ();
+	_numNodes.clear ();
+	_idNodes.clear ();
+}
+
+template <class T>
+static
+size_t bytesOf (const std::vector<T> &v)
+{
+    return v.capacity () * sizeof (T);
+}
+
+size_t FlatAST::bytes () const
+{
+    return bytesOf (_binary.op) + bytesOf (_binary.type) + bytesOf (_binary.left) + bytesOf (_binary.right)
+	       + bytesOf (_num.type) + bytesOf (_num.value) + bytesOf (_id.name) + bytesOf (_id.type)
+		   + bytesOf (_simple.op) + bytesOf (_simple.left) + bytesOf (_simple.right) + bytesOf (_simple.line)
+		   + bytesOf (_or.left) + bytesOf (_or.right) + bytesOf (_and.left)
+		   + bytesOf (_and.right) + bytesOf (_fand.left) + bytesOf (_fand.right) + bytesOf (_not)
+		   + _binaryNodes.bytes () + _numNodes.bytes () + _idNodes.bytes ();
+}
@@ -0,0 +1,150 @@
+#ifndef __FLATAST_H
+#define __FLATAST_H 1
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "gen.h"
+#include "hashcons.h"
+
+/*  The expressions of a program in flat form (-flat-ast).
+
+    The parser builds a tree of Exp and BoolExp objects linked by pointers (see ast.h).  With
+	-flat-ast it puts the nodes of expressions and conditions in arrays instead:  each kind of
+	node has arrays of its own, one for each field (a struct of arrays), and a node is a 32-bit
+	FlatNode, its kind in the top 4 bits and its index in the arrays of its kind in the others.
+	The op of binary node 7 is _binary.op [7], its operands are _binary.left [7] and
+	_binary.right [7].  There are no vtables:  a pass over the nodes switches on their kind.
+	A BinaryOp takes 48 bytes in the arena, a binary node 14 bytes here;  a NumNode 24 (9 here),
+	an IdNode 32 (13), a SimpleBoolExp 32 (9), an Or, And or Fand 24 (8), a Not 16 (4).
+
+	The rest of the compiler still sees Exp and BoolExp objects:  an expression is a FlatExp
+	(a condition a FlatBoolExp) that holds the FlatNode of its root (see ast.h).  The parser
+	makes one for each expression it reads, and reuses those of the operands of an operator once
+	they are in the arrays, so there are only a few of them besides the ones kept by statements.
+	Expressions are hash consed like the Exp nodes (see hashcons.h):  an expression identical
+	to one already in the arrays gets its FlatNode.
+
+	The nodes of an expression are added after those of its operands, so the code generation
+	reads the arrays in order.  Like the passes over Exp trees the passes over flat trees use
+	explicit stacks (see "expressions" in ast.h).
+*/
+
+typedef uint32_t FlatNode;
+
+enum FlatKind { FLAT_BINARY, FLAT_NUM, FLAT_ID, FLAT_SIMPLEBOOL, FLAT_OR, FLAT_AND, FLAT_NOT, FLAT_FAND };
+
+class Exp;
+class BoolExp;
+class FlatExp;
+class FlatBoolExp;
+class ConditionCounter;
+
+class FlatAST {
+public:
+    FlatAST ();
+
+    /*  make nodes (for the parser).  The operands are FlatExps (FlatBoolExps) made by this
+	    FlatAST:  they are reused, the one returned may be one of them.  The checks done by the
+		constructors of the AST classes are done here too (the types of variables ...) */
+    Exp *binaryOp (enum op op, Exp *left, Exp *right);
+	Exp *num (int ival);
+	Exp *num (double fval);
+	Exp *id (const char *name, int line);  // name is interned (see the scanner). line: for the error of an undefined variable
+	BoolExp *simpleBoolExp (enum op op, Exp *left, Exp *right, int line);
+	BoolExp *orExp (BoolExp *left, BoolExp *right);
+	BoolExp *andExp (BoolExp *left, BoolExp *right);
+	BoolExp *notExp (BoolExp *operand);
+	BoolExp *fandExp (BoolExp *left, BoolExp *right);
+
+	// generate the code of the tree under node:  the same code as Exp::genExp () and
+	// BoolExp::genBoolExp () generate for it (see gen.cpp)
+	int genExp (FlatNode node) const;
+	void genBoolExp (FlatNode node, int truelabel, int falselabel) const;
+
+	// -pgo: walk the comparisons of the condition under node (see conditionCounts () in gen.cpp)
+	void countConditions (FlatNode node, ConditionCounter &counter) const;
+
+	// append the description of the tree under node to f: the same as Exp::fingerprint () (see fingerprint.cpp)
+	void fingerprint (FlatNode node, std::string &f) const;
+
+	/*  forget all the nodes (and the FlatExps and FlatBoolExps to reuse:  they are in the arena,
+	    call it when the arena is reset).  The arrays keep their memory */
+	void clear ();
+
+	// the memory of the arrays
+	size_t bytes () const;
+
+	static FlatKind kind (FlatNode node) { return FlatKind (node >> KIND_SHIFT); }
+	static uint32_t index (FlatNode node) { return node & INDEX_MASK; }
+
+	// a job of genBoolExp () (see BoolJob in ast.h)
+	struct Job {
+	    Job (FlatNode node, int truelabel, int falselabel)
+		    { this->node = node; this->truelabel = truelabel; this->falselabel = falselabel; }
+		static Job label (int label) { return Job (NO_NODE, label, 0); }
+
+	    FlatNode node;  // NO_NODE: emit truelabel
+		int truelabel;
+		int falselabel;
+	};
+
+	static const FlatNode NO_NODE = 0xffffffff;
+
+private:
+    static const int KIND_SHIFT = 28;
+	static const uint32_t INDEX_MASK = (1u << KIND_SHIFT) - 1;
+
+	static FlatNode make (FlatKind kind, size_t index);
+	FlatExp *newExp (FlatNode node, myType type);
+	FlatBoolExp *newBoolExp (FlatNode node);
+	static FlatNode nodeOf (Exp *exp);
+	static FlatNode nodeOf (BoolExp *exp);
+	FlatNode addPair (FlatKind kind, BoolExp *left, BoolExp *right);
+	FlatNode numNode (myType type, int ival, double fval);
+
+	// the operands of the node (NO_NODE if it has no operand i)
+	FlatNode operand (FlatNode node, int i) const;
+
+	myType typeOf (FlatNode node) const;
+
+	// the key of an expression node (see hashcons.h)
+	ExpKey keyOf (FlatNode node) const;
+	struct KeyOf {
+	    KeyOf (const FlatAST *tree = NULL) { this->tree = tree; }
+		ExpKey operator() (FlatNode node) const { return tree->keyOf (node); }
+		const FlatAST *tree;
+	};
+
+	struct {
+	    std::vector<unsigned char> op;   // enum op
+		std::vector<unsigned char> type; // myType
+		std::vector<FlatNode> left, right;
+	} _binary;
+	struct {
+	    std::vector<unsigned char> type;
+		std::vector<double> value;  // an int is stored in a double exactly
+	} _num;
+	struct {
+	    std::vector<const char *> name;  // see internName () in symtab.h
+		std::vector<unsigned char> type;
+	} _id;
+	struct {
+	    std::vector<unsigned char> op;
+		std::vector<FlatNode> left, right;  // expressions
+		std::vector<int> line;  // see SimpleBoolExp::_line
+	} _simple;
+	struct Pairs {
+	    std::vector<FlatNode> left, right;
+	} _or, _and, _fand;
+	std::vector<FlatNode> _not;
+
+	std::vector<FlatExp *> _freeExps;  // FlatExps and FlatBoolExps to reuse
+	std::vector<FlatBoolExp *> _freeBoolExps;
+
+	ConsTable<FlatNode, KeyOf> _binaryNodes, _numNodes, _idNodes;  // the expression nodes by key
+};
+
+#endif // not defined __FLATAST_H
@@ -1,66 +1,296 @@
 #include <stdio.h>
 #include <stdlib.h> // exit ()
 #include <stdarg.h>
-#include <stack>
+#include <algorithm>
+#include <vector>
 
 #include "ast.h"
 #include "symtab.h"
+#include "context.h"
+#include "ir.h"
 
-
-/*    This stack is used to implement  break statements.
-      "break"  is implemented as a goto to the exit label of the most closely enclosing loop (or switch statement). 
-      This label is the top of the stack. Below it on the stack is the exit label of the enclosing loop and so on.
-      The stack is empty when we are not inside a  loop (or switch statement).
-*/
-static	  
-std::stack<int> exitlabels;
+/*   temporaries, labels and the stack of exit labels (used to implement break statements)
+     belong to the compilation running on this thread. See context.h */
 
 static
 int newTemp ()
 {
-   static int counter = 1;
-   return counter++;
+   return ++CompilerContext::current ()->tempCounter;
 } 
 
 static
 int newlabel ()
 {
-   static int counter = 1;
-   return counter++;
+   return ++CompilerContext::current ()->labelCounter;
 } 
 
 void pushlabel (int label)
 {
-	exitlabels.push(label);
+	CompilerContext::current ()->exitlabels.push(label);
 } 
 
 void poplabel ()
 {
+	std::stack<int> &exitlabels = CompilerContext::current ()->exitlabels;
 	if(!exitlabels.empty())
 		exitlabels.pop();
 	else
 		errorMsg ("Error pop of exitlabels not in loop or switch\n");
 } 
 
-// emit works just like  printf  --  we use emit 
-// to generate code and print it to the standard output.
-void emit (const char *format, ...)
+/*  the source line of the code generated from now on (see Instr::line). Set by the statements
+    and the comparisons, before the code of their expressions:  the nodes of expressions are
+	shared by all the lines that use them (see hashcons.h) and have no line.  Nodes with no line
+	(an IfStmt, an Or ...) get the line of the node generated before them */
+static
+void setLine (int line)
 {
-    // if (errors > 0) return; // do not generate code if there are errors.  This should be controlled by if !defined (DEBUG)) 
+    CompilerContext::current ()->line = line;
+}
+
+/*  -pgo (see profile.h): the profile of a line of the program. NULL if there is none
+    (no profile, or the line was never executed) */
+static
+const LineProfile *lineProfile (int line)
+{
+    const Profile *profile = CompilerContext::current ()->profile;
+	if (profile == NULL)
+	    return NULL;
+	Profile::const_iterator it = profile->find (line);
+	return it == profile->end () ? NULL : &it->second;
+}
 
-    printf ("    ");  // this is meant to add a nice indentation.
-                      // Use emitlabel() to print a label without the indentation.    
-    va_list argptr;
-	va_start (argptr, format);
-	// all the arguments following 'format' are passed on to vprintf
-	vprintf (format, argptr); 
-	va_end (argptr);
+/*  -pgo: the profile of the condition whose branch is emitted next (on the current line). The
+    conditions of a line are counted in the order their code is generated, as collectProfile ()
+	does.  An unrolled loop has more conditions than the profile: they are taken round */
+static
+const ConditionProfile *nextCondition ()
+{
+    CompilerContext *ctx = CompilerContext::current ();
+	if (ctx->profile == NULL)
+	    return NULL;
+	int n = ctx->conditionsSeen [ctx->line]++;
+	const LineProfile *p = lineProfile (ctx->line);
+	if (p == NULL || p->conditions.empty ())
+	    return NULL;
+	return &p->conditions [n % p->conditions.size ()];
 }
 
-/* use this  to emit a label without using indentation */
+/*  -pgo: the times a condition was true and false, from the counts of its comparisons.  The code
+    of a comparison is one if or ifFalse (see genCondition ()) and the profile has their counts in
+	the order of the code (see nextCondition ()).  A walk of the condition (an object tree or a flat
+	one) calls comparison () for each comparison, in the order of their code, and combine () for
+	each and, or, fand and not after its operands:  with short-circuit evaluation the right operand
+	of an and is tested only when the left one is true, so
+	    and: true as often as the right one, false as often as both        (or, fand: likewise)
+	The counts of the condition are not known when a comparison has no profile */
+class ConditionCounter {
+public:
+    ConditionCounter () { _known = true; }
+
+	// the next comparison. line: the line of its code (see SimpleBoolExp::_line)
+	void comparison (int line)
+	{
+	    CompilerContext *ctx = CompilerContext::current ();
+		const LineProfile *p = lineProfile (line);
+		int n = ctx->conditionsSeen [line] + _seen [line]++;
+		ConditionProfile c;
+		c.trueCount = c.falseCount = 0;
+		if (p == NULL || p->conditions.empty ())
+		    _known = false;
+		else
+		    c = p->conditions [n % p->conditions.size ()];
+		_stack.push_back (c);
+	}
+
+	// kind: FLAT_OR, FLAT_AND, FLAT_FAND or FLAT_NOT (its operands are the top of the stack)
+	void combine (FlatKind kind)
+	{
+	    ConditionProfile right = _stack.back (), c;
+		if (kind == FLAT_NOT) {
+		    c.trueCount = right.falseCount;
+			c.falseCount = right.trueCount;
+			_stack.back () = c;
+			return;
+		}
+		_stack.pop_back ();
+		ConditionProfile left = _stack.back ();
+		if (kind == FLAT_OR) {
+		    c.trueCount = left.trueCount + right.trueCount;
+			c.falseCount = right.falseCount;
+		} else if (kind == FLAT_AND) {
+		    c.trueCount = right.trueCount;
+			c.falseCount = left.falseCount + right.falseCount;
+		} else {  // not and
+		    c.trueCount = left.falseCount + right.falseCount;
+			c.falseCount = right.trueCount;
+		}
+		_stack.back () = c;
+	}
+
+	// the counts of the condition.  false if they are not known
+	bool result (ConditionProfile &counts) const
+	{
+	    if (!_known || _stack.size () != 1)
+		    return false;
+		counts = _stack.back ();
+		return true;
+	}
+
+private:
+    std::vector<ConditionProfile> _stack;
+	std::map<int, int> _seen;  // comparisons of each line walked (their code is not generated yet)
+	bool _known;
+};
+
+/*  -pgo: the counts of 'condition' (see ConditionCounter), computed before its code is generated.
+    false if there is no profile for it */
+static
+bool conditionCounts (BoolExp *condition, ConditionProfile &counts)
+{
+    if (CompilerContext::current ()->profile == NULL)
+	    return false;
+	ConditionCounter counter;
+	// (node, its operands were pushed): a post order walk, the left operand first
+	std::vector<std::pair<BoolExp *, bool> > stack (1, std::make_pair (condition, false));
+	while (!stack.empty ()) {
+	    BoolExp *exp = stack.back ().first;
+		if (FlatBoolExp *flat = dynamic_cast<FlatBoolExp *> (exp)) {
+		    stack.pop_back ();
+		    flat->_tree->countConditions (flat->_node, counter);
+			continue;
+		}
+		if (!stack.back ().second) {
+		    stack.back ().second = true;
+			if (exp->operand (1) != NULL)
+			    stack.push_back (std::make_pair (exp->operand (1), false));
+			if (exp->operand (0) != NULL)
+			    stack.push_back (std::make_pair (exp->operand (0), false));
+			continue;
+		}
+		stack.pop_back ();
+		if (SimpleBoolExp *e = dynamic_cast<SimpleBoolExp *> (exp))
+		    counter.comparison (e->_line);
+		else if (dynamic_cast<Or *> (exp) != NULL)
+		    counter.combine (FLAT_OR);
+		else if (dynamic_cast<And *> (exp) != NULL)
+		    counter.combine (FLAT_AND);
+		else if (dynamic_cast<Fand *> (exp) != NULL)
+		    counter.combine (FLAT_FAND);
+		else
+		    counter.combine (FLAT_NOT);
+	}
+	return counter.result (counts);
+}
+
+// -pgo: true if 'condition' was usually true (its own counts, see conditionCounts ())
+static
+bool usuallyTrue (BoolExp *condition)
+{
+    ConditionProfile c;
+	return conditionCounts (condition, c) && c.trueCount > c.falseCount;
+}
+
+/*  -pgo: the number of copies of its condition and body a loop gets (1: it is not unrolled).
+    known, counts: the counts of its condition (see conditionCounts ()).  size: the number of
+	instructions of one copy */
+static
+int unrollCount (bool known, const ConditionProfile &counts, size_t size)
+{
+	if (!known || size > UNROLL_SIZE || counts.trueCount < HOT_LOOP || counts.trueCount < UNROLL * counts.falseCount)
+	    return 1;
+	return UNROLL;
+}
+
+/*  while a Quiet lives the messages of the code generated are dropped (and the errors not
+    counted):  it is a copy of code generated before, whose messages were printed then */
+class Quiet {
+public:
+    Quiet () { _ctx = CompilerContext::current (); _ctx->quiet++; }
+	~Quiet () { _ctx->quiet--; }
+
+private:
+    CompilerContext *_ctx;
+};
+
+/*  -pgo: add copies - 1 copies of the condition, the body and the step of a loop after its code
+    (the loop goes back to its condition once every 'copies' iterations) */
+static
+void unroll (BoolExp *condition, Stmt *body, Stmt *step, int exitlabel, int copies)
+{
+    if (copies <= 1)
+	    return;
+	Quiet quiet;
+	for (int i = 1; i < copies; i++) {
+	    condition->genBoolExp (FALL_THROUGH, exitlabel);
+		body->genStmt ();
+		if (step != NULL)
+		    step->genStmt ();
+	}
+}
+
+/*  the code of a loop:  its condition, its body and its step (NULL: none) go back to the
+    condition.  With -rotate-loops the condition is tested once before the loop and then at the
+	bottom, where it jumps back to the body while it is true (one jump per iteration, not two):
+	        condition, false: goto exitlabel               condlabel:
+	    bodylabel:                                             condition, false: goto exitlabel
+	        body                          instead of           body
+	        step                                               step
+	        condition, true: goto bodylabel                    goto condlabel
+	    exitlabel:                                         exitlabel:
+	A break in the body jumps to exitlabel (the top of the stack of exit labels) */
+static
+void genLoop (BoolExp *condition, Stmt *body, Stmt *step)
+{
+    CompilerContext *ctx = CompilerContext::current ();
+    int condlabel = newlabel ();
+	int exitlabel = newlabel ();
+	
+	pushlabel(exitlabel);
+	
+	ConditionProfile counts;
+	bool known = conditionCounts (condition, counts);  // (-pgo: before its code takes its profile)
+	
+	bool rotate = ctx->options.rotateLoops;
+	if (!rotate)
+	    emitlabel(condlabel);
+	size_t start = ctx->code.size ();
+	condition->genBoolExp (FALL_THROUGH, exitlabel);
+	if (rotate)
+	    emitlabel(condlabel);  // the label of the body
+	
+	body->genStmt ();
+	if (step != NULL)
+	    step->genStmt ();
+	
+	unroll (condition, body, step, exitlabel, unrollCount (known, counts, ctx->code.size () - start));
+	
+	if (!rotate)
+	    emit (Instr (IR_GOTO, 0, 0, 0, condlabel));
+	else {
+	    Quiet quiet;  // (the messages of the condition were printed with its first copy)
+		condition->genBoolExp (condlabel, FALL_THROUGH);
+	}
+	emitlabel (exitlabel);
+	poplabel ();
+}
+
+// emit appends an instruction to the code of the current compilation. The code is printed
+// (to the standard output by default) when the compilation ends. See ir.h
+void emit (const Instr &instr)
+{
+    // if (errors > 0) return; // do not generate code if there are errors.  This should be controlled by if !defined (DEBUG)) 
+    CompilerContext *ctx = CompilerContext::current ();
+	ctx->stats.emits++;
+	ctx->code.push_back (instr);
+	if (instr.line == 0)
+	    ctx->code.back ().line = ctx->line;
+}
+
+/* labels are printed without indentation */
 void emitlabel (int label) 
 {
-    printf ("label%d:\n",  label);
+    emit (Instr (IR_LABEL, 0, 0, 0, label));
 }    
 
 /* there are two versions of each arithmetic operator in the
@@ -97,235 +327,444 @@ opName (enum op op, myType t)
 	    return opNames [op].float_name;
 }
 
-int BinaryOp::genExp ()
+const char *
+relopName (enum op op)
 {
-  
-	int left_operand_result = _left->genExp ();
-	int right_operand_result = _right->genExp ();
-	
-	if( _op == MODULO )
+    switch (op) {
+	    case LT:
+		    return "<";
+		case GT:
+		    return ">";
+		case LE:
+		    return "<=";
+		case GE:
+		    return ">=";
+		case EQ:
+		    return "==";
+		case NE:
+		    return "!=";
+		default:
+		    fprintf (stderr, "internal compiler error #3\n"); exit (1);
+	}
+}
+
+int Exp::genExp ()
+{
+    /*  a post order walk: each node on the stack with the number of its operands already visited,
+	    and the results of the operands of the nodes on the stack */
+    std::vector<std::pair<Exp *, int> > stack;
+	std::vector<int> results;
+	stack.push_back (std::make_pair (this, 0));
+	while (!stack.empty ()) {
+	    Exp *node = stack.back ().first;
+		int visited = stack.back ().second++;
+		Exp *operand = node->operand (visited);
+		if (operand != NULL)
+		    stack.push_back (std::make_pair (operand, 0));
+		else {
+		    // the results of its operands are the last ones
+			int result = node->genNode (results.data () + results.size () - visited);
+			results.resize (results.size () - visited);
+			results.push_back (result);
+			stack.pop_back ();
+		}
+	}
+	return results.back ();
+}
+
+/*  the code of a node, for both forms of the AST (the classes of ast.h and the flat form of
+    flatast.h).  Each returns the temporary of its result */
+
+// left and right: the temporaries of the operands
+static
+int genBinary (enum op op, myType type, int left_operand_result, myType leftType,
+               int right_operand_result, myType rightType)
+{
+	if( op == MODULO )
 	{
-		if(_left->_type != _INT || _right->_type != _INT)
-			errorMsg ("line %d: error - modulo op must work only on int operands\n", _line);
+		if(leftType != _INT || rightType != _INT)
+			errorMsg ("line %d: error - modulo op must work only on int operands\n", CompilerContext::current ()->line);
 	}
 	
-	const char *the_op = opName (_op, _type);
-	
-	if (_left->_type != _right->_type)
+	if (leftType != rightType)
 	{
 		int castOperand = newTemp();
-		if(_left->_type == _INT)
+		Instr cast (IR_CAST, castOperand);
+		cast.type = _FLOAT;
+		if(leftType == _INT)
 		{
-			emit ("_t%d = static_cast<float> _t%d\n", castOperand, left_operand_result);
+			cast.src1 = left_operand_result;
 			left_operand_result = castOperand;
 		}
 		else
 		{
-			emit ("_t%d = static_cast<float> _t%d\n", castOperand, right_operand_result);
+			cast.src1 = right_operand_result;
 			right_operand_result = castOperand;
 		}
+		emit (cast);
 	}
 	
-	_result = newTemp ();
+	int result = newTemp ();
 	
-  	emit ("_t%d = _t%d %s _t%d\n", _result, left_operand_result, the_op, right_operand_result);
-
-	return _result;
+	Instr instr (IR_BINARY, result, left_operand_result, right_operand_result);
+	instr.op = op;
+	instr.type = type;
+  	emit (instr);
+	return result;
 }
 
-int NumNode::genExp () 
+static
+int genNum (myType type, int ival, double fval)
 {
-    _result = newTemp ();
-	if (_type == _INT)
-  	    emit ("_t%d = %d\n", _result, _u.ival);
+    int result = newTemp ();
+	Instr instr (IR_CONST, result);
+	instr.type = type;
+	if (type == _INT)
+  	    instr.value.ival = ival;
 	else
-	    emit ("_t%d = %.2f\n", _result, _u.fval);
-	return _result;
+	    instr.value.fval = fval;
+	emit (instr);
+	return result;
 }
 
-int IdNode::genExp ()
+static
+int genId (const char *name)
 {
-    _result = newTemp ();
+    int result = newTemp ();
 		
-	emit ("_t%d = %s\n", _result, _name);
-	return _result;
+	Instr instr (IR_LOAD, result);
+	instr.name = name;
+	emit (instr);
+	return result;
 }
 
-void SimpleBoolExp::genBoolExp (int truelabel, int falselabel)
+// a simple condition: left_result op right_result (not both labels are FALL_THROUGH)
+static
+void genCondition (enum op op, int left_result, int right_result, int truelabel, int falselabel)
 {
-    if (truelabel == FALL_THROUGH && falselabel == FALL_THROUGH)
-	    return; // no need for code 
-
-    const char *the_op;
-	
-	int left_result = _left->genExp ();
-	int right_result = _right->genExp ();
-	
-    switch (_op) {
-	    case LT:
-		    the_op = "<";
-			break;
-		case GT:
-		    the_op = ">";
-			break;
-		case LE:
-		    the_op = "<=";
-			break;
-		case GE:
-		    the_op = ">=";
-			break;
-		case EQ:
-		    the_op = "==";
-			break;
-		case NE:
-		    the_op = "!=";
-			break;
-		default:
-		    fprintf (stderr, "internal compiler error #3\n"); exit (1);
-	}
-	
-	if  (truelabel == FALL_THROUGH)
-   	    emit ("ifFalse _t%d %s _t%d goto label%d\n", left_result, the_op, right_result, falselabel);
-    else if (falselabel == FALL_THROUGH)
-   	    emit ("if _t%d %s _t%d goto label%d\n", left_result, the_op, right_result, truelabel);
-	else { // no fall through
-  	    emit ("if _t%d %s _t%d goto label%d\n", left_result, the_op, right_result, truelabel);
-	    emit ("goto label%d\n", falselabel);
+	const ConditionProfile *p = nextCondition ();
+	if  (truelabel == FALL_THROUGH) {
+	    Instr instr (IR_IFFALSE, 0, left_result, right_result, falselabel);
+		instr.op = op;
+   	    emit (instr);
+    } else if (falselabel != FALL_THROUGH && p != NULL && p->falseCount > p->trueCount) {
+	    // -pgo: usually false, so the jump to falselabel is the one that needs no goto after it
+	    Instr instr (IR_IFFALSE, 0, left_result, right_result, falselabel);
+		instr.op = op;
+   	    emit (instr);
+	    emit (Instr (IR_GOTO, 0, 0, 0, truelabel));
+    } else { 
+	    Instr instr (IR_IF, 0, left_result, right_result, truelabel);
+		instr.op = op;
+   	    emit (instr);
+		if (falselabel != FALL_THROUGH) // no fall through
+	        emit (Instr (IR_GOTO, 0, 0, 0, falselabel));
 	}
 }
 
-void Or::genBoolExp (int truelabel, int falselabel)
+/*  the jobs of an or, and, nand node (see BoolExp::genNode ()).  Node is BoolExp * (Job is
+    BoolJob) or a FlatNode (Job is FlatAST::Job).  The jobs are pushed in the reverse order of
+	the code */
+template <class Node, class Job>
+static
+void orJobs (Node _left, Node _right, int truelabel, int falselabel, std::vector<Job> &jobs)
 {
     if (truelabel == FALL_THROUGH && falselabel == FALL_THROUGH)
 	    return; // no need for code 
 
     if  (truelabel == FALL_THROUGH) {
 	    int next_label = newlabel(); // FALL_THROUGH implemented by jumping to next_label
-	    _left->genBoolExp (next_label, // if left operand is true then the OR expression
+        jobs.push_back (Job::label (next_label));
+		jobs.push_back (Job (_right, FALL_THROUGH, falselabel));
+	    jobs.push_back (Job (_left, next_label, // if left operand is true then the OR expression
 		                               //is true so jump to next_label (thus falling through
 									   // to the code following the code for the OR expression)
-		                   FALL_THROUGH); // if left operand is false then 
+		                   FALL_THROUGH)); // if left operand is false then 
 						                  // fall through and evaluate right operand   
-		_right->genBoolExp (FALL_THROUGH, falselabel);
-        emitlabel (next_label);
     }  else if (falselabel == FALL_THROUGH) {
-       _left->genBoolExp (truelabel, // if left operand is true then the OR expresson is true 
+	   jobs.push_back (Job (_right, truelabel, FALL_THROUGH));
+       jobs.push_back (Job (_left, truelabel, // if left operand is true then the OR expresson is true 
 	                                 // so jump to  truelabel (without evaluating right operand)
-                          FALL_THROUGH); // if left operand is false then 
+                          FALL_THROUGH)); // if left operand is false then 
 						                  // fall through and evaluate right operand
-	   _right->genBoolExp (truelabel, FALL_THROUGH);
 	} else { // no fall through
-	   _left->genBoolExp (truelabel, // if left operand is true then the or expresson is true 
+	   jobs.push_back (Job (_right, truelabel, falselabel));
+	   jobs.push_back (Job (_left, truelabel, // if left operand is true then the or expresson is true 
 	                                 // so jump to  truelabel (without evaluating right operand)
-						  FALL_THROUGH); // if left operand is false then 
+						  FALL_THROUGH)); // if left operand is false then 
 						                  // fall through and evaluate right operand
-	   _right->genBoolExp (truelabel, falselabel);
 	}
 }
 
-void And::genBoolExp (int truelabel, int falselabel)
+template <class Node, class Job>
+static
+void andJobs (Node _left, Node _right, int truelabel, int falselabel, std::vector<Job> &jobs)
 {
     if (truelabel == FALL_THROUGH && falselabel == FALL_THROUGH)
 	    return; // no need for code 
 		
 	if  (truelabel == FALL_THROUGH) {
-	    _left->genBoolExp (FALL_THROUGH, // if left operand is true then fall through and evaluate
+        jobs.push_back (Job (_right, FALL_THROUGH, falselabel));
+	    jobs.push_back (Job (_left, FALL_THROUGH, // if left operand is true then fall through and evaluate
 		                                 // right operand.
-                           falselabel); // if left operand is false then the AND expression is
+                           falselabel)); // if left operand is false then the AND expression is
                                         // false so jump to falselabel);
-        _right->genBoolExp (FALL_THROUGH, falselabel);
     } else if (falselabel == FALL_THROUGH) {
 	    int next_label = newlabel(); // FALL_THROUGH implemented by jumping to next_label
-        _left->genBoolExp (FALL_THROUGH, // if left operand is true then fall through and
+		jobs.push_back (Job::label (next_label));
+        jobs.push_back (Job (_right, truelabel, FALL_THROUGH));
+        jobs.push_back (Job (_left, FALL_THROUGH, // if left operand is true then fall through and
                                          // evaluate right operand
-                           next_label); // if left operand is false then the AND expression 
+                           next_label)); // if left operand is false then the AND expression 
                                         //  is false so jump to next_label (thus falling through to
                                         // the code following the code for the AND expression)
-        _right->genBoolExp (truelabel, FALL_THROUGH);
-		emitlabel(next_label);
     } else { // no fall through
-        _left->genBoolExp (FALL_THROUGH, 	// if left operand is true then fall through and
+		jobs.push_back (Job (_right, truelabel, falselabel));
+        jobs.push_back (Job (_left, FALL_THROUGH, 	// if left operand is true then fall through and
                                          // evaluate right operand
-						   falselabel); // if left operand is false then the AND expression is false
+						   falselabel)); // if left operand is false then the AND expression is false
 						                // so jump to falselabel (without evaluating the right operand)
-		_right->genBoolExp (truelabel, falselabel);
 	}
 }
 
-void Not::genBoolExp (int truelabel, int falselabel)
-{
-    _operand->genBoolExp (falselabel, truelabel); 
-}
-
-void Fand::genBoolExp (int truelabel, int falselabel)
+template <class Node, class Job>
+static
+void fandJobs (Node _left, Node _right, int truelabel, int falselabel, std::vector<Job> &jobs)
 {
     if (truelabel == FALL_THROUGH && falselabel == FALL_THROUGH)
 	    return; // no need for code 
 	
 	if  (truelabel == FALL_THROUGH) {
-	    _left->genBoolExp (falselabel, // if left operand is true then the FAND expression is
+        jobs.push_back (Job (_right, falselabel, FALL_THROUGH));
+	    jobs.push_back (Job (_left, falselabel, // if left operand is true then the FAND expression is
                                         // false so jump to falselabel);
-                           FALL_THROUGH); // if left operand is false then fall through and evaluate
+                           FALL_THROUGH)); // if left operand is false then fall through and evaluate
 		                                 // right operand.
-        _right->genBoolExp (falselabel, FALL_THROUGH);
     } else if (falselabel == FALL_THROUGH) {
 	    int next_label = newlabel(); // FALL_THROUGH implemented by jumping to next_label
-        _left->genBoolExp (next_label, // if left operand is true then the FAND expression 
+		jobs.push_back (Job::label (next_label));
+        jobs.push_back (Job (_right, FALL_THROUGH, truelabel));
+        jobs.push_back (Job (_left, next_label, // if left operand is true then the FAND expression 
                                         //  is false so jump to next_label (thus falling through to
                                         // the code following the code for the FAND expression)
-                           FALL_THROUGH); // if left operand is false then fall through and
+                           FALL_THROUGH)); // if left operand is false then fall through and
                                          // evaluate right operand
-        _right->genBoolExp (FALL_THROUGH, truelabel);
-		emitlabel(next_label);
     } else { // no fall through
-        _left->genBoolExp (falselabel,  // if left operand is true then the FAND expression is true
+		jobs.push_back (Job (_right, falselabel, truelabel));
+        jobs.push_back (Job (_left, falselabel,  // if left operand is true then the FAND expression is true
 						                // so jump to false label (without evaluating the right operand)
-						   FALL_THROUGH);// if left operand is false then fall through and
+						   FALL_THROUGH));// if left operand is false then fall through and
                                          // evaluate right operand
-		_right->genBoolExp (falselabel, truelabel);
+	}
+}
+
+int BinaryOp::genNode (const int *operands)
+{
+    return genBinary (_op, _type, operands [0], _left->_type, operands [1], _right->_type);
+}
+
+int NumNode::genNode (const int *operands) 
+{
+    return genNum (_type, _u.ival, _u.fval);
+}
+
+int IdNode::genNode (const int *operands)
+{
+    return genId (_name);
+}
+
+int FlatExp::genNode (const int *operands)
+{
+    return _tree->genExp (_node);
+}
+
+void BoolExp::genBoolExp (int truelabel, int falselabel)
+{
+    std::vector<BoolJob> jobs (1, BoolJob (this, truelabel, falselabel));
+	while (!jobs.empty ()) {
+	    BoolJob job = jobs.back ();
+		jobs.pop_back ();
+		if (job.exp == NULL)
+		    emitlabel (job.truelabel);
+		else
+		    job.exp->genNode (job.truelabel, job.falselabel, jobs);
+	}
+}
+
+void SimpleBoolExp::genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs)
+{
+    if (truelabel == FALL_THROUGH && falselabel == FALL_THROUGH)
+	    return; // no need for code 
+
+	setLine (_line);
+	int left_result = _left->genExp ();
+	int right_result = _right->genExp ();
+	genCondition (_op, left_result, right_result, truelabel, falselabel);
+}
+
+void Or::genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs)
+{
+    orJobs (_left, _right, truelabel, falselabel, jobs);
+}
+
+void And::genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs)
+{
+    andJobs (_left, _right, truelabel, falselabel, jobs);
+}
+
+void Not::genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs)
+{
+    jobs.push_back (BoolJob (_operand, falselabel, truelabel)); 
+}
+
+void Fand::genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs)
+{
+    fandJobs (_left, _right, truelabel, falselabel, jobs);
+}
+
+void FlatBoolExp::genNode (int truelabel, int falselabel, std::vector<BoolJob> &jobs)
+{
+    _tree->genBoolExp (_node, truelabel, falselabel);
+}
+
+// the code of a flat tree: a switch on the kind of each node (see Exp::genExp ())
+int FlatAST::genExp (FlatNode root) const
+{
+    // the nodes with the number of their operands visited, and the results of the operands
+    std::vector<std::pair<FlatNode, int> > stack;
+	std::vector<int> results;
+	stack.push_back (std::make_pair (root, 0));
+	while (!stack.empty ()) {
+	    FlatNode node = stack.back ().first;
+		uint32_t n = index (node);
+		if (kind (node) == FLAT_BINARY && stack.back ().second < 2) {
+		    FlatNode operand = stack.back ().second++ == 0 ? _binary.left [n] : _binary.right [n];
+		    stack.push_back (std::make_pair (operand, 0));
+			continue;
+		}
+		stack.pop_back ();
+		switch (kind (node)) {
+		    case FLAT_BINARY: {
+			    int right = results.back ();
+				results.pop_back ();
+				int left = results.back ();
+				results.back () = genBinary (op (_binary.op [n]), myType (_binary.type [n]), left,
+				                             typeOf (_binary.left [n]), right, typeOf (_binary.right [n]));
+				break;
+			}
+			case FLAT_NUM:
+			    results.push_back (genNum (myType (_num.type [n]), (int) _num.value [n], _num.value [n]));
+				break;
+			case FLAT_ID:
+			    results.push_back (genId (_id.name [n]));
+				break;
+			default:
+			    fprintf (stderr, "internal compiler error: flat node %x is not an expression\n", node); exit (1);
+		}
+	}
+	return results.back ();
+}
+
+// see BoolExp::genBoolExp ()
+void FlatAST::genBoolExp (FlatNode root, int truelabel, int falselabel) const
+{
+    std::vector<Job> jobs (1, Job (root, truelabel, falselabel));
+	while (!jobs.empty ()) {
+	    Job job = jobs.back ();
+		jobs.pop_back ();
+		if (job.node == NO_NODE) {
+		    emitlabel (job.truelabel);
+			continue;
+		}
+		uint32_t n = index (job.node);
+		switch (kind (job.node)) {
+		    case FLAT_SIMPLEBOOL:
+			    if (job.truelabel != FALL_THROUGH || job.falselabel != FALL_THROUGH) {
+				    setLine (_simple.line [n]);
+				    int left_result = genExp (_simple.left [n]);
+					int right_result = genExp (_simple.right [n]);
+					genCondition (op (_simple.op [n]), left_result, right_result, job.truelabel, job.falselabel);
+				}
+				break;
+			case FLAT_OR:
+			    orJobs (_or.left [n], _or.right [n], job.truelabel, job.falselabel, jobs);
+				break;
+			case FLAT_AND:
+			    andJobs (_and.left [n], _and.right [n], job.truelabel, job.falselabel, jobs);
+				break;
+			case FLAT_FAND:
+			    fandJobs (_fand.left [n], _fand.right [n], job.truelabel, job.falselabel, jobs);
+				break;
+			case FLAT_NOT:
+			    jobs.push_back (Job (_not [n], job.falselabel, job.truelabel));
+				break;
+			default:
+			    fprintf (stderr, "internal compiler error: flat node %x is not a condition\n", job.node); exit (1);
+		}
+	}
+}
+
+// see conditionCounts ():  the same walk over a flat tree
+void FlatAST::countConditions (FlatNode root, ConditionCounter &counter) const
+{
+    std::vector<std::pair<FlatNode, bool> > stack (1, std::make_pair (root, false));
+	while (!stack.empty ()) {
+	    FlatNode node = stack.back ().first;
+		uint32_t n = index (node);
+		if (kind (node) != FLAT_SIMPLEBOOL && !stack.back ().second) {
+		    stack.back ().second = true;
+			if (operand (node, 1) != NO_NODE)
+			    stack.push_back (std::make_pair (operand (node, 1), false));
+			stack.push_back (std::make_pair (operand (node, 0), false));
+			continue;
+		}
+		stack.pop_back ();
+		if (kind (node) == FLAT_SIMPLEBOOL)
+		    counter.comparison (_simple.line [n]);
+		else
+		    counter.combine (kind (node));
 	}
 }
 
 void ReadStmt::genStmt()
 {
-	myType idtype = _id->_type; 
-	
-	if (idtype == _INT)
- 	  emit ("iread %s\n", _id->_name);
-    else
-      emit ("fread %s\n", _id->_name);
+    setLine (_line);
+	Instr instr (IR_READ);
+	instr.type = _id->_type; 
+	instr.name = _id->_name;
+	emit (instr);
 }
 
 void WriteStmt::genStmt()
 {
 	if(_exp->_type != _INT && _exp->_type != _FLOAT)
         errorMsg("line %d: error: var type undefined.\n",_line);
-	_exp-> genExp();
-	myType exptype = _exp->_type; 
-	
-	if (exptype == _INT)
- 	  emit ("iwrite _t%d\n", _exp->_result);
-    else
-      emit ("fwrite _t%d\n", _exp->_result);
+	setLine (_line);
+	int result = _exp-> genExp();
+	Instr instr (IR_WRITE, 0, result);
+	instr.type = _exp->_type; 
+	emit (instr);
 }
 
 void AssignStmt::genStmt()
 {
-    int result = _rhs->genExp();
+    setLine (_line);
+	int result = _rhs->genExp();
 
 	myType idtype = _lhs->_type; 
 	
-	if (idtype == _rhs->_type)
-		emit ("%s = _t%d\n", _lhs->_name, result);
-	else
+	if (idtype == _rhs->_type) {
+		Instr instr (IR_STORE, 0, result);
+		instr.name = _lhs->_name;
+		emit (instr);
+	} else
 	{
-		if(idtype == _INT){
-			emit ("%s = static_cast<int> _t%d", _lhs->_name, result);
-			fprintf (stderr, " \tline:%d warning: data may lost\n",_line);
-		}
-		else
-			emit ("%s = static_cast<float> _t%d\n", _lhs->_name, result);
-		
+		Instr instr (IR_CAST_STORE, 0, result);
+		instr.name = _lhs->_name;
+		instr.type = idtype;
+		emit (instr);
+		if(idtype == _INT && CompilerContext::current ()->quiet == 0)
+			fprintf (CompilerContext::current ()->err, " \tline:%d warning: data may lost\n",_line);
 	}
 }
 
@@ -335,10 +774,23 @@ void IfStmt::genStmt()
     int elseStmtlabel = newlabel ();
 	int exitlabel = newlabel ();
 	
+	/*  the part that comes second falls through to the exit, the first one needs a goto.
+	    The else part is second by default; with -pgo it is the part usually executed */
+	if (usuallyTrue (_condition)) {
+		int thenStmtlabel = elseStmtlabel;
+		_condition->genBoolExp (thenStmtlabel, FALL_THROUGH);
+		_elseStmt->genStmt ();
+		emit (Instr (IR_GOTO, 0, 0, 0, exitlabel));
+		emitlabel (thenStmtlabel);
+		_thenStmt->genStmt ();
+		emitlabel (exitlabel);
+		return;
+	}
+	
 	_condition->genBoolExp (FALL_THROUGH, elseStmtlabel);
 	
     _thenStmt->genStmt ();
-	emit ("goto label%d\n", exitlabel);
+	emit (Instr (IR_GOTO, 0, 0, 0, exitlabel));
 	emitlabel(elseStmtlabel);
     _elseStmt->genStmt();
 	emitlabel(exitlabel);
@@ -346,22 +798,7 @@ void IfStmt::genStmt()
 
 void WhileStmt::genStmt()
 {
-    int condlabel = newlabel ();
-	int exitlabel = newlabel ();
-	
-	pushlabel(exitlabel);
-	
-	emitlabel(condlabel);
-	_condition->genBoolExp (FALL_THROUGH, exitlabel);
-	
-	
-	
-	_body->genStmt ();
-	
-	
-	emit ("goto label%d\n", condlabel);
-	emitlabel (exitlabel);
-	poplabel ();
+    genLoop (_condition, _body, NULL);
 }
 
 void Block::genStmt()
@@ -370,8 +807,22 @@ void Block::genStmt()
 	    stmt->genStmt();
 }
 
+// orders cases by the times they were chosen (the largest first)
+struct MoreFrequent {
+    MoreFrequent (const std::map<int, long> &counts) : counts (counts) {}
+	long count (const Case *c) const
+	{
+	    std::map<int, long>::const_iterator it = counts.find (c->_number);
+		return it == counts.end () ? 0 : it->second;
+	}
+	bool operator() (const Case *a, const Case *b) const { return count (a) > count (b); }
+	
+	const std::map<int, long> &counts;
+};
+
 void SwitchStmt::genStmt()
 { 
+	setLine (_line);
 	int result = _exp->genExp ();
 	
 	if( _exp->_type != _INT )
@@ -383,7 +834,7 @@ void SwitchStmt::genStmt()
 	
 	pushlabel(exitlabel);
 
-	emit ("goto label%d\n", condlabel);
+	emit (Instr (IR_GOTO, 0, 0, 0, condlabel));
 	
 	Case *currentCase = _caselist;
 	
@@ -393,7 +844,7 @@ void SwitchStmt::genStmt()
 		emitlabel(currentCase->_label);
 		currentCase->_stmt->genStmt();
 		if(currentCase->_hasBreak)
-			emit ("goto label%d\n", exitlabel);
+			emit (Instr (IR_GOTO, 0, 0, 0, exitlabel));
 		currentCase = currentCase->_next;
 	}
 	
@@ -401,19 +852,26 @@ void SwitchStmt::genStmt()
 	
 	_default_stmt->genStmt();
 	
-	emit ("goto label%d\n", exitlabel);
+	emit (Instr (IR_GOTO, 0, 0, 0, exitlabel));
 	
 	emitlabel(condlabel);
+	setLine (_line);  // the tests of the cases belong to the switch
 	
-	currentCase = _caselist;
+	std::vector<Case *> tests;
+	for (currentCase = _caselist; currentCase != NULL; currentCase = currentCase->_next)
+	    tests.push_back (currentCase);
+	const LineProfile *p = lineProfile (_line);
+	if (p != NULL)  // -pgo: the most frequent cases first (equal ones stay in order)
+	    std::stable_sort (tests.begin (), tests.end (), MoreFrequent (p->cases));
 	
-	while(currentCase != NULL)
+	for (size_t i = 0; i < tests.size (); i++)
 	{
-		emit ("case _t%d %d label%d\n", result, currentCase->_number, currentCase->_label);
-		currentCase = currentCase->_next;
+		Instr instr (IR_CASE, 0, result, 0, tests [i]->_label);
+		instr.value.ival = tests [i]->_number;
+		emit (instr);
 	}
 	
-	emit ("case _t%d _t%d label%d\n", result, result, defaultlabel);
+	emit (Instr (IR_CASE, 0, result, result, defaultlabel));
 	
 	emitlabel(exitlabel);
 	
@@ -422,8 +880,10 @@ void SwitchStmt::genStmt()
 
 void BreakStmt::genStmt()
 {
+    setLine (_line);
+	std::stack<int> &exitlabels = CompilerContext::current ()->exitlabels;
 	if(!exitlabels.empty())
-		emit ("goto label%d\n", exitlabels.top ());
+		emit (Instr (IR_GOTO, 0, 0, 0, exitlabels.top ()));
 	else
 	    errorMsg ("line %d. Break not in loop or switch case\n", _line);
 }
@@ -431,22 +891,6 @@ void BreakStmt::genStmt()
 void ForStmt::genStmt()
 {
 	_init->genStmt ();
-	
-    int condlabel = newlabel ();
-	int exitlabel = newlabel ();
-	
-	pushlabel(exitlabel);
-	
-	emitlabel(condlabel);
-	_condition->genBoolExp (FALL_THROUGH, exitlabel);
-		
-	_body->genStmt ();
-	
-	_afterStep->genStmt ();
-		
-	emit ("goto label%d\n", condlabel);
-	emitlabel(exitlabel);
-
-	poplabel ();
+	genLoop (_condition, _body, _afterStep);
 }
 
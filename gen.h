@@ -1,9 +1,11 @@
 #ifndef __GEN_H
 #define __GEN_H 1
 
-void emit (const char *format, ...); 
+struct Instr;
+
+// append an instruction to the code of the current compilation (see ir.h)
+void emit (const Instr &instr);
 void emitlabel (int label);
-extern int errors;
 
 void errorMsg (const char *format, ...);
 
@@ -16,4 +18,7 @@ enum op { PLUS = 0, MINUS, MUL, DIV, POW, MODULO, LT, GT, LE, GE, EQ, NE };
 */
 const char *opName (enum op, myType t);
 
+// e.g. relopName (LE) returns "<="
+const char *relopName (enum op);
+
 #endif // not defined __GEN_H
@@ -0,0 +1,100 @@
+#include <string.h>
+
+#include "hash.h"
+
+// 64 bit xxHash (https://github.com/Cyan4973/xxHash), written out here
+
+static const unsigned long long PRIME1 = 11400714785074694791ULL;
+static const unsigned long long PRIME2 = 14029467366897019727ULL;
+static const unsigned long long PRIME3 =  1609587929392839161ULL;
+static const unsigned long long PRIME4 =  9650029242287828579ULL;
+static const unsigned long long PRIME5 =  2870177450012600261ULL;
+
+static inline
+unsigned long long rotl (unsigned long long x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline
+unsigned long long read64 (const unsigned char *p)
+{
+    unsigned long long v;
+	memcpy (&v, p, 8);  // assumes a little endian machine
+	return v;
+}
+
+static inline
+unsigned long long read32 (const unsigned char *p)
+{
+    unsigned int v;
+	memcpy (&v, p, 4);
+	return v;
+}
+
+static inline
+unsigned long long xxround (unsigned long long acc, unsigned long long input)
+{
+    acc += input * PRIME2;
+	acc = rotl (acc, 31);
+	return acc * PRIME1;
+}
+
+static inline
+unsigned long long mergeRound (unsigned long long acc, unsigned long long val)
+{
+    acc ^= xxround (0, val);
+	return acc * PRIME1 + PRIME4;
+}
+
+unsigned long long xxhash64 (const void *data, size_t len, unsigned long long seed)
+{
+    const unsigned char *p = (const unsigned char *) data;
+	const unsigned char *end = p + len;
+	unsigned long long h;
+	
+	if (len >= 32) {
+	    unsigned long long v1 = seed + PRIME1 + PRIME2;
+		unsigned long long v2 = seed + PRIME2;
+		unsigned long long v3 = seed;
+		unsigned long long v4 = seed - PRIME1;
+		do {
+		    v1 = xxround (v1, read64 (p)); 
+			v2 = xxround (v2, read64 (p + 8)); 
+			v3 = xxround (v3, read64 (p + 16)); 
+			v4 = xxround (v4, read64 (p + 24));
+			p += 32;
+		} while (p + 32 <= end);
+		h = rotl (v1, 1) + rotl (v2, 7) + rotl (v3, 12) + rotl (v4, 18);
+		h = mergeRound (h, v1);
+		h = mergeRound (h, v2);
+		h = mergeRound (h, v3);
+		h = mergeRound (h, v4);
+	} else
+	    h = seed + PRIME5;
+		
+	h += len;
+	for (; p + 8 <= end; p += 8)
+	    h = rotl (h ^ xxround (0, read64 (p)), 27) * PRIME1 + PRIME4;
+	if (p + 4 <= end) {
+	    h = rotl (h ^ (read32 (p) * PRIME1), 23) * PRIME2 + PRIME3;
+		p += 4;
+	}
+	for (; p < end; p++)
+	    h = rotl (h ^ (*p * PRIME5), 11) * PRIME1;
+		
+	h ^= h >> 33;
+	h *= PRIME2;
+	h ^= h >> 29;
+	h *= PRIME3;
+	h ^= h >> 32;
+	return h;
+}
+
+Hash128 hash128 (const void *data, size_t len)
+{
+    Hash128 h;
+	h.lo = xxhash64 (data, len, 0);
+	h.hi = xxhash64 (data, len, PRIME5);
+	return h;
+}
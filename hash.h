@@ -0,0 +1,20 @@
+#ifndef __HASH_H
+#define __HASH_H 1
+
+#include <stddef.h>
+
+// 64 bit xxHash of data[0] ... data[len-1]
+unsigned long long xxhash64 (const void *data, size_t len, unsigned long long seed);
+
+/*  a 128 bit hash (two xxHash64 with different seeds). Used as the name of some data (see the
+    compilation cache and the statement cache) so collisions are ignored */
+struct Hash128 {
+    unsigned long long lo, hi;
+
+	bool operator< (const Hash128 &other) const { return lo != other.lo ? lo < other.lo : hi < other.hi; }
+	bool operator== (const Hash128 &other) const { return lo == other.lo && hi == other.hi; }
+};
+
+Hash128 hash128 (const void *data, size_t len);
+
+#endif // not defined __HASH_H
@@ -0,0 +1,129 @@
+#include "hashcons.h"
+#include "ast.h"
+#include "context.h"
+
+void countShared ()
+{
+    CompilerContext::current ()->stats.sharedNodes++;
+}
+
+ExpKey ExpKey::binary (enum op op, myType type, uint64_t left, uint64_t right)
+{
+    ExpKey key;
+	key.kind = NODE_BINARYOP;
+	key.op = op;
+	key.type = type;
+	key.a = left;
+	key.b = right;
+	return key;
+}
+
+ExpKey ExpKey::num (myType type, int ival, double fval)
+{
+    ExpKey key;
+	key.kind = NODE_NUM;
+	key.type = type;
+	if (type == _INT)
+	    key.a = (uint64_t) (int64_t) ival;
+	else
+	    memcpy (&key.a, &fval, sizeof fval);  // the bits: -0.0 is not 0.0
+	return key;
+}
+
+ExpKey ExpKey::id (const char *name, myType type)
+{
+    ExpKey key;
+	key.kind = NODE_ID;
+	key.type = type;
+	key.a = (uint64_t) (uintptr_t) name;  // interned: one address for a name
+	return key;
+}
+
+ExpKey NodeKey::operator() (BinaryOp *node) const
+{
+    return ExpKey::binary (node->_op, node->_type, (uintptr_t) node->_left, (uintptr_t) node->_right);
+}
+
+ExpKey NodeKey::operator() (NumNode *node) const
+{
+    return ExpKey::num (node->_type, node->_u.ival, node->_u.fval);
+}
+
+ExpKey NodeKey::operator() (IdNode *node) const
+{
+    return ExpKey::id (node->_name, node->_type);
+}
+
+Exp *ExpFactory::binaryOp (enum op op, Exp *left, Exp *right)
+{
+	myType type = left->_type != right->_type ? _FLOAT : left->_type;  // see BinaryOp::BinaryOp ()
+	ExpKey key = ExpKey::binary (op, type, (uintptr_t) left, (uintptr_t) right);
+	uint32_t hash = key.hash ();
+	BinaryOp *node;
+	if (_binary.find (key, hash, node)) {
+	    countShared ();
+		return node;
+	}
+	node = new BinaryOp (op, left, right);
+	_binary.add (hash, node);
+	return node;
+}
+
+Exp *ExpFactory::num (int ival)
+{
+	ExpKey key = ExpKey::num (_INT, ival, 0);
+	uint32_t hash = key.hash ();
+	NumNode *node;
+	if (_num.find (key, hash, node)) {
+	    countShared ();
+		return node;
+	}
+	node = new NumNode (ival);
+	_num.add (hash, node);
+	return node;
+}
+
+Exp *ExpFactory::num (double fval)
+{
+	ExpKey key = ExpKey::num (_FLOAT, 0, fval);
+	uint32_t hash = key.hash ();
+	NumNode *node;
+	if (_num.find (key, hash, node)) {
+	    countShared ();
+		return node;
+	}
+	node = new NumNode (fval);
+	_num.add (hash, node);
+	return node;
+}
+
+Exp *ExpFactory::id (const char *name, int line)
+{
+    myType type;
+	{
+	    PhaseTimer timer (CompilerContext::current ()->stats, PHASE_SEMANTIC);
+		type = IdNode::lookup (name, line);  // an undefined variable is an error at each use
+	}
+	ExpKey key = ExpKey::id (name, type);
+	uint32_t hash = key.hash ();
+	IdNode *node;
+	if (_id.find (key, hash, node)) {
+	    countShared ();
+		return node;
+	}
+	node = new IdNode (name, type);
+	_id.add (hash, node);
+	return node;
+}
+
+void ExpFactory::clear ()
+{
+    _binary.clear ();
+	_num.clear ();
+	_id.clear ();
+}
+
+size_t ExpFactory::bytes () const
+{
+    return _binary.bytes () + _num.bytes () + _id.bytes ();
+}
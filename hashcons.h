@@ -0,0 +1,178 @@
+#ifndef __HASHCONS_H
+#define __HASHCONS_H 1
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include "gen.h"
+
+/*  Hash consing of expressions.
+
+    The parser makes the nodes of expressions (BinaryOp, NumNode, IdNode, and the nodes of the
+	flat form with -flat-ast) through a factory that looks each one up first:  an expression
+	identical to one made before gets the node of that one, so an expression tree is a DAG.
+	Two nodes are identical when their kind, operator, type and operands are the same: the
+	operands of an operator are the (shared) nodes themselves, a constant its value, a variable
+	its name.  a * i is one node in the whole program (or statement with -stream).
+
+	A node has no line:  the code of an expression belongs to the line of the statement or the
+	comparison that uses it (see Instr::line: -profile counts by line and run time errors tell
+	it), which keeps the line of each use (see setLine () in gen.cpp).
+
+	Expressions have no side effects, so a shared node has the same value wherever it is used.
+	The passes over expressions do not keep anything in the nodes (see Exp::genExp ()):  a shared
+	node gets its code each time it is used, and the code is the same as with a tree.
+
+	The nodes are in the arena (or the arrays of the flat form) and the tables hold no more than
+	their pointers (indexes).  They are emptied when the arena is.
+*/
+
+// the key of a node (see above). Keys are hashed and compared as bytes
+struct ExpKey {
+    ExpKey () { memset (this, 0, sizeof *this); }  // the padding too
+
+	bool operator== (const ExpKey &other) const { return memcmp (this, &other, sizeof *this) == 0; }
+
+	// never 0 (see ConsTable).  The multiplications move the bits of the operands (pointers, with
+	// their low bits 0) to the top, and the top is taken
+	uint32_t hash () const
+	{
+	    uint64_t h = a * 0x9e3779b97f4a7c15ull ^ b * 0xc2b2ae3d27d4eb4full
+		             ^ ((uint64_t) kind << 16 | op << 8 | type) * 0x165667b19e3779f9ull;
+		return (uint32_t) (h >> 32) | 1;
+	}
+
+	// the keys of the kinds of nodes.  left, right: the ids of the operands.  name: interned
+	static ExpKey binary (enum op op, myType type, uint64_t left, uint64_t right);
+	static ExpKey num (myType type, int ival, double fval);
+	static ExpKey id (const char *name, myType type);
+
+	uint64_t a, b;  // the ids of the operands, the bits of a constant or the address of a name (see internName ())
+	unsigned char kind;  // a NodeKind (see stats.h)
+	unsigned char op;
+	unsigned char type;
+};
+
+/*  a hash table of nodes: open addressing, linear probing.  Node is a pointer to a node or a
+    FlatNode (see flatast.h).  KeyOf gives the key of a node:  the table keeps only the node
+	and the hash of its key (8 or 16 bytes a slot).  It is never more than half full */
+template <class Node, class KeyOf>
+class ConsTable {
+public:
+    ConsTable (KeyOf keyOf = KeyOf ()) : _keyOf (keyOf) { _count = 0; }
+
+	// true with node set to the node of key (hash: key.hash ()) if there is one
+	bool find (const ExpKey &key, uint32_t hash, Node &node) const
+	{
+	    if (_slots.empty ())
+		    return false;
+		size_t mask = _slots.size () - 1;
+	    for (size_t i = hash & mask; _slots [i].hash != 0; i = (i + 1) & mask)
+		    if (_slots [i].hash == hash && _keyOf (_slots [i].node) == key) {
+			    node = _slots [i].node;
+				return true;
+			}
+		return false;
+	}
+
+	// add node (the key with hash 'hash' is not there)
+	void add (uint32_t hash, Node node)
+	{
+	    if (2 * (_count + 1) > _slots.size ())
+		    grow ();
+		put (hash, node);
+		_count++;
+	}
+
+	/*  remove all the nodes.  The table keeps its memory, unless it had few nodes for its size
+	    (it is cleared for each statement with -stream: the time is that of the nodes, not of the
+		biggest statement) */
+	void clear ()
+	{
+	    if (_count == 0)
+		    return;
+	    if (_slots.size () > MIN_SLOTS && 8 * _count < _slots.size ())
+		    std::vector<Slot> ().swap (_slots);
+		else
+	        for (size_t i = 0; i < _slots.size (); i++)
+		        _slots [i].hash = 0;
+		_count = 0;
+	}
+
+	size_t bytes () const { return _slots.capacity () * sizeof (Slot); }
+
+	KeyOf _keyOf;
+
+private:
+    static const size_t MIN_SLOTS = 64;
+
+    struct Slot {
+	    uint32_t hash;  // 0: a free slot
+		Node node;
+	};
+
+	void put (uint32_t hash, Node node)
+	{
+		size_t mask = _slots.size () - 1;
+		size_t i = hash & mask;
+		while (_slots [i].hash != 0)
+		    i = (i + 1) & mask;
+		_slots [i].hash = hash;
+		_slots [i].node = node;
+	}
+
+	void grow ()
+	{
+	    std::vector<Slot> old;
+		old.swap (_slots);
+		Slot free;
+		free.hash = 0;
+		_slots.assign (old.empty () ? MIN_SLOTS : 2 * old.size (), free);
+		for (size_t i = 0; i < old.size (); i++)
+		    if (old [i].hash != 0)
+			    put (old [i].hash, old [i].node);
+	}
+
+	std::vector<Slot> _slots;  // a power of 2 of them
+	size_t _count;
+};
+
+class Exp;
+class BinaryOp;
+class NumNode;
+class IdNode;
+
+// the keys of the nodes of ast.h
+struct NodeKey {
+    ExpKey operator() (BinaryOp *node) const;
+	ExpKey operator() (NumNode *node) const;
+	ExpKey operator() (IdNode *node) const;
+};
+
+/*  the factory of the nodes of expressions (for the parser).  The checks of the constructors of
+    the nodes are done for each expression, shared or not (an undefined variable is an error
+	each time it is used) */
+class ExpFactory {
+public:
+    Exp *binaryOp (enum op op, Exp *left, Exp *right);
+	Exp *num (int ival);
+	Exp *num (double fval);
+	Exp *id (const char *name, int line);  // name is interned (see the scanner). line: for the error of an undefined variable
+
+	// forget the nodes (call it when the arena is reset)
+	void clear ();
+
+	// the memory of the tables
+	size_t bytes () const;
+
+private:
+    ConsTable<BinaryOp *, NodeKey> _binary;
+	ConsTable<NumNode *, NodeKey> _num;
+	ConsTable<IdNode *, NodeKey> _id;
+};
+
+// count an expression that got the node of an identical one (see stats.h)
+void countShared ();
+
+#endif // not defined __HASHCONS_H
@@ -0,0 +1,153 @@
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ifconvert.h"
+
+// an if with two parts (see ifconvert.h):
+//   test:  if/ifFalse _tS1 op _tS2 goto L1     the first part ... store1   goto L2
+//   L1:    the second part ... store2          L2: (at exit)
+struct Diamond {
+    size_t test, store1, store2, exit;
+};
+
+// the type of each temporary (as the interpreter sees it)
+static
+std::vector<myType> tempTypes (const std::vector<Instr> &code, const std::map<std::string, myType> &variables, int tempCounter)
+{
+    std::vector<myType> types (tempCounter + 1, _INT);
+	for (size_t i = 0; i < code.size (); i++) {
+	    const Instr &instr = code [i];
+		if (instr.opcode == IR_LOAD) {
+		    std::map<std::string, myType>::const_iterator it = variables.find (instr.name);
+			types [instr.dest] = it != variables.end () && it->second == _FLOAT ? _FLOAT : _INT;
+		} else if (instr.opcode == IR_CONST || instr.opcode == IR_CAST || instr.opcode == IR_BINARY
+		           || instr.opcode == IR_SELECT)
+		    types [instr.dest] = instr.type;
+	}
+	return types;
+}
+
+// true if the instruction computes a value, cheaply and with no way to fail
+static
+bool cheap (const Instr &instr)
+{
+    switch (instr.opcode) {
+	    case IR_CONST:
+		case IR_LOAD:
+		case IR_CAST:
+		case IR_SELECT:
+		    return true;
+		case IR_BINARY:
+		    return instr.op == PLUS || instr.op == MINUS || instr.op == MUL;
+		default:
+		    return false;
+	}
+}
+
+// the end of a part starting at i: the index of its store (code.size () if it is not a cheap part)
+static
+size_t partEnd (const std::vector<Instr> &code, size_t i)
+{
+    size_t end = i;
+	while (end < code.size () && end - i <= IF_CONVERT_MAX && cheap (code [end]))
+	    end++;
+	if (end - i > IF_CONVERT_MAX || end == code.size ()
+	    || (code [end].opcode != IR_STORE && code [end].opcode != IR_CAST_STORE))
+	    return code.size ();
+	return end;
+}
+
+// true if the code at i is an if with two parts that can be converted (d is set to it)
+static
+bool diamond (const std::vector<Instr> &code, size_t i, const std::vector<int> &jumpsTo,
+              const std::vector<myType> &types, Diamond &d)
+{
+    const Instr &test = code [i];
+	if ((test.opcode != IR_IF && test.opcode != IR_IFFALSE) || jumpsTo [test.label] != 1)
+	    return false;
+	d.test = i;
+	d.store1 = partEnd (code, i + 1);
+	if (d.store1 + 2 >= code.size () || code [d.store1 + 1].opcode != IR_GOTO
+	    || code [d.store1 + 2].opcode != IR_LABEL || code [d.store1 + 2].label != test.label)
+		return false;
+	int exit = code [d.store1 + 1].label;
+	d.store2 = partEnd (code, d.store1 + 3);
+	d.exit = d.store2 + 1;
+	if (d.exit >= code.size () || code [d.exit].opcode != IR_LABEL || code [d.exit].label != exit)
+	    return false;
+	const Instr &store1 = code [d.store1], &store2 = code [d.store2];
+	return store1.opcode == store2.opcode && strcmp (store1.name, store2.name) == 0
+	       && (store1.opcode == IR_STORE || store1.type == store2.type)
+		   && types [store1.src1] == types [store2.src1];
+}
+
+// the number of jumps to each label
+static
+std::vector<int> countJumps (const std::vector<Instr> &code)
+{
+    std::vector<int> jumpsTo;
+	for (size_t i = 0; i < code.size (); i++) {
+	    Opcode opcode = code [i].opcode;
+	    if (opcode == IR_GOTO || opcode == IR_IF || opcode == IR_IFFALSE || opcode == IR_CASE) {
+		    if ((size_t) code [i].label >= jumpsTo.size ())
+			    jumpsTo.resize (code [i].label + 1, 0);
+			jumpsTo [code [i].label]++;
+		}
+	}
+	return jumpsTo;
+}
+
+// one pass over the code.  Returns the number of ifs converted
+static
+int convertPass (std::vector<Instr> &code, const std::map<std::string, myType> &variables, int &tempCounter)
+{
+    std::vector<int> jumpsTo = countJumps (code);
+	std::vector<myType> types = tempTypes (code, variables, tempCounter);
+	std::vector<Instr> out;
+	int converted = 0;
+	size_t copied = 0;  // code [0, copied) is in out
+	for (size_t i = 0; i < code.size (); i++) {
+	    Diamond d;
+		if (!diamond (code, i, jumpsTo, types, d))
+		    continue;
+		if (converted == 0)
+		    out.reserve (code.size ());
+		out.insert (out.end (), code.begin () + copied, code.begin () + i);
+		out.insert (out.end (), code.begin () + i + 1, code.begin () + d.store1);
+		out.insert (out.end (), code.begin () + d.store1 + 3, code.begin () + d.store2);
+
+		// the test jumps to the second part: when it jumps (if: the condition holds) that part is chosen
+		const Instr &test = code [i];
+		Instr select (IR_SELECT, ++tempCounter, test.src1, test.src2);
+		select.op = test.op;
+		select.type = types [code [d.store1].src1];
+		select.src3 = test.opcode == IR_IF ? code [d.store2].src1 : code [d.store1].src1;
+		select.src4 = test.opcode == IR_IF ? code [d.store1].src1 : code [d.store2].src1;
+		select.line = test.line;
+		out.push_back (select);
+		Instr store = code [d.store1];
+		store.src1 = select.dest;
+		out.push_back (store);
+		if (jumpsTo [code [d.exit].label] > 1)  // (not only by the goto of the first part)
+		    out.push_back (code [d.exit]);
+
+		converted++;
+		copied = d.exit + 1;
+		i = d.exit;
+	}
+	if (converted > 0) {
+	    out.insert (out.end (), code.begin () + copied, code.end ());
+		code.swap (out);
+	}
+	return converted;
+}
+
+int convertIfs (std::vector<Instr> &code, const std::map<std::string, myType> &variables, int &tempCounter)
+{
+    int total = 0;
+	for (int n = convertPass (code, variables, tempCounter); n > 0; n = convertPass (code, variables, tempCounter))
+	    total += n;
+	return total;
+}
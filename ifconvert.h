@@ -0,0 +1,36 @@
+#ifndef __IFCONVERT_H
+#define __IFCONVERT_H 1
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ir.h"
+
+/*  If conversion over the code of a whole program (-if-convert).
+
+    An if statement whose two parts assign one variable a cheap value
+	    if (a < b) x = y + 1; else x = z;
+	is a jump the machine guesses wrong half of the time when a < b does not follow a pattern.
+	Its code
+	    ifFalse _t1 < _t2 goto label1   _t3 = y  _t4 = 1  _t5 = _t3 + _t4  x = _t5  goto label2
+		label1:  _t6 = z  x = _t6
+		label2:
+	becomes code with no jump:  both values are computed and a select picks one
+	    _t3 = y  _t4 = 1  _t5 = _t3 + _t4  _t6 = z  _t7 = _t1 < _t2 ? _t5 : _t6  x = _t7
+	(the interpreter runs it with no branch, the JIT with a cmov, see jit.h).
+
+	A part is cheap when it is at most IF_CONVERT_MAX instructions before the assignment, each one
+	a constant, a load, a cast, a +, - or * or a select:  a / or % may fail (by zero) and must
+	not be done when its part is not chosen, ** is slow.  The two assignments are to the same
+	variable, with the same cast if there is one and values of the same type.  The label of the
+	second part must be jumped to only by the test.  The pass repeats until the code does not
+	change (a converted if in a part of an if may make that one cheap).
+	variables: the types of the variables (a variable not there is an int).  New temporaries are
+	numbered after tempCounter.  Returns the number of ifs converted
+*/
+#define IF_CONVERT_MAX 6
+
+int convertIfs (std::vector<Instr> &code, const std::map<std::string, myType> &variables, int &tempCounter);
+
+#endif // not defined __IFCONVERT_H
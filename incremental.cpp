@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "incremental.h"
+#include "irfile.h"
+#include "context.h"
+#include "symtab.h"
+
+static
+size_t align8 (size_t n)
+{
+    return (n + 7) & ~(size_t) 7;
+}
+
+void printReuse (FILE *f, long reused, long total)
+{
+    fprintf (f, "incremental: %ld of %ld statements reused (%.2f%%)\n", reused, total,
+	         total > 0 ? 100.0 * reused / total : 0.0);
+}
+
+StatementCache::StatementCache ()
+{
+    _kept = 0;
+	_codeOptions = 0;
+}
+
+bool StatementCache::load (const char *path, uint32_t codeOptions)
+{
+    _codeOptions = codeOptions;
+    _file.clear ();
+	_entries.clear ();
+	FILE *f = fopen (path, "rb");
+	if (f == NULL)
+	    return false;
+	char buf [64 * 1024];
+	size_t n;
+	while ((n = fread (buf, 1, sizeof buf, f)) > 0)
+	    _file.insert (_file.end (), buf, buf + n);
+	bool ok = !ferror (f);
+	fclose (f);
+
+	StatementCacheHeader h;
+	if (!ok || _file.size () < sizeof h) {
+	    _file.clear ();
+		return false;
+	}
+	memcpy (&h, &_file [0], sizeof h);
+	char compiler [sizeof h.compiler];
+	strncpy (compiler, COMPILER_VERSION, sizeof compiler);
+	if (memcmp (h.magic, STATEMENT_CACHE_MAGIC, 4) != 0 || h.version != STATEMENT_CACHE_VERSION
+	    || memcmp (h.compiler, compiler, sizeof compiler) != 0 || h.codeOptions != codeOptions) {
+	    _file.clear ();
+		return false;
+	}
+
+	size_t offset = sizeof h;
+	for (uint32_t i = 0; i < h.entryCount; i++) {
+	    StatementEntry e;
+		if (offset + sizeof e > _file.size ())
+		    break;
+		memcpy (&e, &_file [offset], sizeof e);
+		size_t size = sizeof e + (size_t) e.instrCount * sizeof (IRRecord) + e.nameBytes;
+		if (offset + size > _file.size () || e.nameBytes % 8 != 0
+		    || (e.nameBytes > 0 && _file [offset + size - 1] != '\0'))
+		    break;
+		_entries [e.key] = offset;
+		offset += size;
+	}
+	if (offset != _file.size ()) {  // broken: forget all of it
+	    _file.clear ();
+		_entries.clear ();
+		return false;
+	}
+	return true;
+}
+
+bool StatementCache::splice (const Hash128 &key, std::vector<Instr> &code, int &tempCounter, int &labelCounter)
+{
+    std::map<Hash128, size_t>::const_iterator it = _entries.find (key);
+	if (it == _entries.end ())
+	    return false;
+	const char *p = &_file [it->second];
+	StatementEntry e;
+	memcpy (&e, p, sizeof e);
+	const IRRecord *records = (const IRRecord *) (p + sizeof e);  // entries start at multiples of 8
+	const char *names = (const char *) (records + e.instrCount);
+
+	for (uint32_t i = 0; i < e.instrCount; i++) {
+	    int32_t name = recordName (records [i]);
+		Instr instr = decodeRecord (records [i], NULL);
+		if (name >= 0)
+		    instr.name = internName ((uint32_t) name < e.nameBytes ? names + name : "");
+		// as in appendRenumbered ()
+		if (instr.dest != 0) instr.dest += tempCounter;
+		if (instr.src1 != 0) instr.src1 += tempCounter;
+		if (instr.src2 != 0) instr.src2 += tempCounter;
+		if (instr.label != 0) instr.label += labelCounter;
+		code.push_back (instr);
+	}
+	tempCounter += e.tempCount;
+	labelCounter += e.labelCount;
+
+	if (_used.insert (key).second)
+	    _kept++;
+	return true;
+}
+
+void StatementCache::add (const Hash128 &key, const std::vector<Instr> &code, int tempCount, int labelCount)
+{
+    if (!_used.insert (key).second)
+	    return;  // the same statement twice in the program
+
+	std::map<std::string, uint32_t> index;
+	std::string names;
+	std::vector<IRRecord> records (code.size ());
+	for (size_t i = 0; i < code.size (); i++) {
+	    uint32_t name = 0;
+		if (code [i].name != NULL) {
+		    std::map<std::string, uint32_t>::iterator it = index.find (code [i].name);
+			if (it == index.end ()) {
+			    it = index.insert (std::make_pair (std::string (code [i].name), (uint32_t) names.size ())).first;
+				names.append (code [i].name, strlen (code [i].name) + 1);
+			}
+			name = it->second;
+		}
+		records [i] = encodeRecord (code [i], name);
+	}
+	names.resize (align8 (names.size ()), '\0');
+
+	StatementEntry e;
+	memset (&e, 0, sizeof e);
+	e.key = key;
+	e.tempCount = tempCount;
+	e.labelCount = labelCount;
+	e.instrCount = records.size ();
+	e.nameBytes = names.size ();
+	_added.append ((const char *) &e, sizeof e);
+	if (!records.empty ())
+	    _added.append ((const char *) &records [0], records.size () * sizeof (IRRecord));
+	_added += names;
+}
+
+bool StatementCache::save (const char *path)
+{
+    if (_added.empty () && _kept == _entries.size ())
+	    return true;  // the same entries as the file
+
+	StatementCacheHeader h;
+	memset (&h, 0, sizeof h);
+	memcpy (h.magic, STATEMENT_CACHE_MAGIC, 4);
+	h.version = STATEMENT_CACHE_VERSION;
+	strncpy (h.compiler, COMPILER_VERSION, sizeof h.compiler);
+	h.entryCount = _used.size ();
+	h.codeOptions = _codeOptions;
+
+	std::string tmppath = std::string (path) + ".tmp";
+	FILE *f = fopen (tmppath.c_str (), "wb");
+	if (f == NULL)
+	    return false;
+	bool ok = fwrite (&h, sizeof h, 1, f) == 1;
+	for (std::map<Hash128, size_t>::const_iterator it = _entries.begin (); ok && it != _entries.end (); ++it)
+	    if (_used.count (it->first) > 0) {
+		    StatementEntry e;
+			memcpy (&e, &_file [it->second], sizeof e);
+			size_t size = sizeof e + (size_t) e.instrCount * sizeof (IRRecord) + e.nameBytes;
+			ok = fwrite (&_file [it->second], 1, size, f) == size;
+		}
+	if (ok && !_added.empty ())
+	    ok = fwrite (_added.data (), 1, _added.size (), f) == _added.size ();
+	ok = fclose (f) == 0 && ok;
+	if (!ok || rename (tmppath.c_str (), path) != 0) {
+	    remove (tmppath.c_str ());
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,98 @@
+#ifndef __INCREMENTAL_H
+#define __INCREMENTAL_H 1
+
+#include <stdio.h>
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "hash.h"
+#include "ir.h"
+
+class Stmt;
+
+/*  Incremental recompilation (-incremental).
+    Each statement of the outermost block of a program gets a fingerprint: a hash of its AST
+	(see fingerprint.cpp). A StatementCache keeps, next to the source file, the code generated for
+	each statement the last time the program was compiled.  The code of a statement does not depend
+	on the statements around it except for the numbers of its temporaries and labels, so they are
+	kept numbered from 1 and renumbered when the code is put in the program.  When the program is
+	compiled again only the statements whose fingerprint is not in the cache get new code.
+
+	The code of a statement depends on the options that change how statements are compiled too
+	(-rotate-loops): the header has the ones the cache was made with, and a cache made with others
+	is not used.
+
+	The cache file starts with a StatementCacheHeader followed by the entries. An entry is a
+	StatementEntry, its IRRecords (see irfile.h: a variable is an offset in the names of the entry)
+	and its names (each one ending with '\0', padded to a multiple of 8 bytes).
+*/
+
+#define STATEMENT_CACHE_MAGIC "TACI"
+#define STATEMENT_CACHE_VERSION 3
+
+// the code options of a cache (StatementCacheHeader::codeOptions)
+#define STATEMENT_CODE_ROTATE_LOOPS 1  // -rotate-loops
+
+struct StatementCacheHeader {
+    char magic [4];         // STATEMENT_CACHE_MAGIC
+	uint32_t version;       // STATEMENT_CACHE_VERSION
+	char compiler [16];     // COMPILER_VERSION (a cache made by another version is not used)
+	uint32_t entryCount;
+	uint32_t codeOptions;   // STATEMENT_CODE_* of the compilations that made it
+};
+
+struct StatementEntry {
+    Hash128 key;            // fingerprint of the statement
+	uint32_t tempCount;     // its temporaries are _t1 ... _t<tempCount>
+	uint32_t labelCount;    // its labels are label1 ... label<labelCount>
+	uint32_t instrCount;
+	uint32_t nameBytes;     // size of the names (with the padding)
+};
+
+// the fingerprint of a statement
+Hash128 fingerprint (Stmt *stmt);
+
+// print "incremental: <reused> of <total> statements reused (<percent>%)"
+void printReuse (FILE *f, long reused, long total);
+
+class StatementCache {
+public:
+    StatementCache ();
+
+	/*  read the cache file 'path' for a compilation with codeOptions (STATEMENT_CODE_*).
+	    A missing file, a broken one, one made by another version of the compiler or with other
+		code options gives an empty cache (save () then replaces it). Returns false in that case */
+	bool load (const char *path, uint32_t codeOptions);
+
+	bool contains (const Hash128 &key) const { return _entries.find (key) != _entries.end (); }
+
+	/*  append the code of statement 'key' to code. Its temporaries and labels are renumbered
+	    after tempCounter and labelCounter, which are then advanced past them.
+		Names are interned in the current compilation (see internName ()).
+		Returns false if the statement is not in the cache */
+	bool splice (const Hash128 &key, std::vector<Instr> &code, int &tempCounter, int &labelCounter);
+
+	// add the code of a statement: its temporaries and labels are numbered from 1
+	void add (const Hash128 &key, const std::vector<Instr> &code, int tempCount, int labelCount);
+
+	/*  write the statements spliced or added since load () to 'path' (the others are dropped).
+	    The file is replaced at once (written to a temporary file, then renamed).  Nothing is
+		written when the file would not change */
+	bool save (const char *path);
+
+private:
+    StatementCache (const StatementCache &);  // not copyable
+	StatementCache &operator= (const StatementCache &);
+
+    std::vector<char> _file;  // the file read by load ()
+	std::map<Hash128, size_t> _entries;  // offset in _file of each entry
+	std::set<Hash128> _used;             // entries to write by save ()
+	std::string _added;  // entries added by add ()
+	size_t _kept;        // number of entries of _file in _used
+	uint32_t _codeOptions;  // of the compilation (see load ())
+};
+
+#endif // not defined __INCREMENTAL_H
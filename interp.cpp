@@ -0,0 +1,364 @@
+#include <stdio.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+
+#include "interp.h"
+#include "context.h"
+#include "profile.h"
+#include "jit.h"
+
+Interpreter::Interpreter (const std::vector<Instr> &code, const std::map<std::string, myType> &variables,
+                          int tempCount, int labelCount)
+    : code (code)
+{
+    profiling = false;
+	jit = Jit::available ();
+	loopsCompiled = 0;
+	nativeBytes = 0;
+	_jit = NULL;
+
+	std::vector<int> labels (labelCount + 1, 0);
+	for (size_t i = 0; i < code.size (); i++)
+	    if (code [i].opcode == IR_LABEL && code [i].label <= labelCount)
+		    labels [code [i].label] = i;
+
+	// the number of instructions assigning each temporary (a divisor assigned once by a constant
+	// earlier in its block is that constant wherever it is used, see divconst.h)
+	std::vector<int> assigned (tempCount + 1, 0), constAt (tempCount + 1, -1);
+	for (size_t i = 0; i < code.size (); i++) {
+	    Opcode opcode = code [i].opcode;
+		if (opcode == IR_CONST || opcode == IR_LOAD || opcode == IR_CAST || opcode == IR_BINARY || opcode == IR_SELECT)
+		    assigned [code [i].dest]++;
+	}
+	int block = -1;  // the index of the last label
+
+	std::map<std::string, int> slots;
+	_temps.resize (tempCount + 1);
+	_tempTypes.resize (tempCount + 1, _INT);
+	_ops.resize (code.size ());
+	for (size_t i = 0; i < code.size (); i++) {
+	    const Instr &instr = code [i];
+		Op &o = _ops [i];
+		o.opcode = instr.opcode;
+		o.op = instr.op;
+		o.type = instr.type;
+		o.dest = instr.dest;
+		o.src1 = instr.src1;
+		o.src2 = instr.src2;
+		o.src3 = instr.src3;
+		o.src4 = instr.src4;
+		o.target = instr.label <= labelCount ? labels [instr.label] : 0;
+		o.value.f = 0;
+		if (instr.type == _INT)
+		    o.value.i = instr.value.ival;
+		else
+		    o.value.f = instr.value.fval;
+		o.slot = 0;
+		if (instr.name != NULL) {
+		    std::map<std::string, int>::iterator it = slots.find (instr.name);
+			if (it == slots.end ()) {
+			    std::map<std::string, myType>::const_iterator v = variables.find (instr.name);
+			    it = slots.insert (std::make_pair (std::string (instr.name), (int) _variableTypes.size ())).first;
+				_variableTypes.push_back (v != variables.end () && v->second == _FLOAT ? _FLOAT : _INT);
+			}
+			o.slot = it->second;
+		}
+		switch (instr.opcode) {
+		    case IR_LABEL:
+			    block = i;
+				break;
+		    case IR_CONST:
+			    constAt [instr.dest] = i;
+			    _tempTypes [instr.dest] = instr.type;
+				break;
+			case IR_BINARY:
+			    o.magic = DivMagic ();  // (a multiplier 0: no magic)
+			    if (instr.type == _INT && (instr.op == DIV || instr.op == MODULO) && assigned [instr.src2] == 1
+				    && constAt [instr.src2] > block && code [constAt [instr.src2]].type == _INT)
+				    divMagic (code [constAt [instr.src2]].value.ival, o.magic);
+			    _tempTypes [instr.dest] = instr.type;
+				break;
+			case IR_CAST:
+			case IR_SELECT:
+			    _tempTypes [instr.dest] = instr.type;
+				break;
+			case IR_LOAD:
+			    _tempTypes [instr.dest] = _variableTypes [o.slot];
+				break;
+			default:
+			    break;
+		}
+	}
+	_variables.resize (_variableTypes.size ());
+}
+
+Interpreter::~Interpreter ()
+{
+    delete _jit;
+}
+
+void Interpreter::backEdge (size_t target, size_t pc)
+{
+    if (_backEdges [target] < 0 || _native [target] != NULL || ++_backEdges [target] < JIT_THRESHOLD)
+	    return;
+	if (_jit == NULL)
+	    _jit = new Jit;
+	size_t size;
+	_native [target] = _jit->compile (_ops, target, pc, _tempTypes, _variableTypes, size);
+	if (_native [target] == NULL) {
+	    _backEdges [target] = -1;  // do not try again
+		return;
+	}
+	loopsCompiled++;
+	nativeBytes += size;
+}
+
+// value v of type 'from' as a value of type 'to'
+static inline
+Value convert (Value v, myType from, myType to)
+{
+    Value r;
+	if (from == to)
+	    return v;
+	if (to == _INT)
+	    r.i = (int) v.f;
+	else
+	    r.f = v.i;
+	return r;
+}
+
+/*  integer operators wrap around (as the machine does) instead of being undefined on overflow.
+    magic: of b when it is a constant (see divconst.h) */
+static
+bool intOp (enum op op, int a, int b, const DivMagic &magic, int &result)
+{
+    unsigned x = a, y = b;
+	switch (op) {
+	    case PLUS:  result = (int) (x + y); return true;
+		case MINUS: result = (int) (x - y); return true;
+		case MUL:   result = (int) (x * y); return true;
+		case DIV:
+		case MODULO:
+		    if (magic.multiplier != 0) {
+			    result = op == DIV ? divideByMagic (a, magic) : moduloByMagic (a, b, magic);
+				return true;
+			}
+		    if (b == 0)
+			    return false;
+			if (a == INT_MIN && b == -1)
+			    result = op == DIV ? INT_MIN : 0;
+			else
+			    result = op == DIV ? a / b : a % b;
+			return true;
+		case POW: {
+		    if (b < 0) {  // 1 / a^-b
+			    result = a == 1 ? 1 : a == -1 ? (b % 2 == 0 ? 1 : -1) : 0;
+				if (a == 0)
+				    return false;
+				return true;
+			}
+			unsigned r = 1;
+			for (; y != 0; y >>= 1) {
+			    if (y & 1)
+				    r *= x;
+				x *= x;
+			}
+			result = (int) r;
+			return true;
+		}
+		default:
+		    return true;
+	}
+}
+
+static
+double floatOp (enum op op, double a, double b)
+{
+    switch (op) {
+	    case PLUS:  return a + b;
+		case MINUS: return a - b;
+		case MUL:   return a * b;
+		case DIV:   return a / b;
+		case POW:   return pow (a, b);
+		case MODULO: return fmod (a, b);
+		default:    return 0;
+	}
+}
+
+template <class T>
+static inline
+bool compare (enum op op, T a, T b)
+{
+    switch (op) {
+	    case LT: return a < b;
+		case GT: return a > b;
+		case LE: return a <= b;
+		case GE: return a >= b;
+		case EQ: return a == b;
+		case NE: return a != b;
+		default: return false;
+	}
+}
+
+// the condition  _tS1 op _tS2  of an if, ifFalse or select
+static inline
+bool holds (const Interpreter::Op &o, const std::vector<Value> &temps, const std::vector<myType> &types)
+{
+    const Value &a = temps [o.src1], &b = temps [o.src2];
+	myType ta = types [o.src1], tb = types [o.src2];
+	if (ta == _INT && tb == _INT)
+	    return compare (o.op, a.i, b.i);
+	return compare (o.op, ta == _INT ? (double) a.i : a.f, tb == _INT ? (double) b.i : b.f);
+}
+
+bool Interpreter::run (FILE *in, FILE *out, std::string &error)
+{
+    if (profiling) {
+	    counts.assign (_ops.size (), 0);
+		jumps.assign (_ops.size (), 0);
+	}
+	bool jitting = jit && !profiling && Jit::available ();
+	if (jitting) {
+	    _backEdges.assign (_ops.size (), 0);
+		_native.assign (_ops.size (), NULL);
+	}
+	char message [100];
+	size_t pc = 0;
+	while (pc < _ops.size ()) {
+	    const Op &o = _ops [pc];
+		if (profiling)
+		    counts [pc]++;
+		switch (o.opcode) {
+		    case IR_CONST:
+			    _temps [o.dest] = o.value;
+				break;
+			case IR_LOAD:
+			    _temps [o.dest] = _variables [o.slot];
+				break;
+			case IR_CAST:
+			    _temps [o.dest] = convert (_temps [o.src1], _tempTypes [o.src1], o.type);
+				break;
+			case IR_BINARY:
+			    // (the operands have the type of the result: see BinaryOp::genExp ())
+			    if (o.type == _INT) {
+				    if (!intOp (o.op, _temps [o.src1].i, _temps [o.src2].i, o.magic, _temps [o.dest].i)) {
+					    snprintf (message, sizeof message, "line %d: division by zero", code [pc].line);
+						error = message;
+						return false;
+					}
+				} else
+				    _temps [o.dest].f = floatOp (o.op, _temps [o.src1].f, _temps [o.src2].f);
+				break;
+			case IR_STORE:
+			case IR_CAST_STORE:
+			    _variables [o.slot] = convert (_temps [o.src1], _tempTypes [o.src1], _variableTypes [o.slot]);
+				break;
+			case IR_READ: {
+			    int n;
+				if (_variableTypes [o.slot] == _INT)
+				    n = fscanf (in, "%d", &_variables [o.slot].i);
+				else
+				    n = fscanf (in, "%lf", &_variables [o.slot].f);
+				if (n != 1) {
+				    snprintf (message, sizeof message, "line %d: no number to read", code [pc].line);
+					error = message;
+					return false;
+				}
+				break;
+			}
+			case IR_WRITE:
+			    if (_tempTypes [o.src1] == _INT)
+				    fprintf (out, "%d\n", _temps [o.src1].i);
+				else
+				    fprintf (out, "%g\n", _temps [o.src1].f);
+				break;
+			case IR_LABEL:
+			    if (jitting && _native [pc] != NULL) {
+				    pc = _native [pc] (&_temps [0], _variables.data ());
+					continue;
+				}
+			    break;
+			case IR_GOTO:
+			    if (jitting && (size_t) o.target < pc)
+				    backEdge (o.target, pc);
+			    pc = o.target;
+				continue;
+			case IR_SELECT:
+			    // the index is chosen, not the code run: no jump (a cmov)
+			    _temps [o.dest] = _temps [holds (o, _temps, _tempTypes) ? o.src3 : o.src4];
+				break;
+			case IR_IF:
+			case IR_IFFALSE:
+			    if (holds (o, _temps, _tempTypes) == (o.opcode == IR_IF)) {
+				    if (profiling)
+					    jumps [pc]++;
+					if (jitting && (size_t) o.target < pc)
+					    backEdge (o.target, pc);
+				    pc = o.target;
+					continue;
+				}
+				break;
+			case IR_CASE:
+			    if (o.src2 != 0 || _temps [o.src1].i == o.value.i) {
+				    if (profiling)
+					    jumps [pc]++;
+					if (jitting && (size_t) o.target < pc)
+					    backEdge (o.target, pc);
+				    pc = o.target;
+					continue;
+				}
+				break;
+			case IR_HALT:
+			    return true;
+		}
+		pc++;
+	}
+	return true;
+}
+
+int runProgram (const char *path, const CompileOptions &options, bool profile, bool jit)
+{
+    FILE *in = fopen (path, "r");
+	if (in == NULL) {
+	    fprintf (stderr, "failed to open %s\n", path);
+		return 2;
+	}
+	CompilerContext ctx;
+	ctx.options = options;
+	ctx.options.binaryIR = false;
+	ctx.keepCode = true;
+	std::string profileFile = std::string (path) + ".prof";
+	ctx.profileFile = profileFile;
+	int errors = ctx.compile (in);
+	fclose (in);
+	if (errors > 0) {
+	    fprintf (stderr, "compilation failed\n");
+		return 3;
+	}
+
+	Interpreter interp (ctx.code, ctx.symbolTable, ctx.tempCounter, ctx.labelCounter);
+	interp.profiling = profile;
+	interp.jit = interp.jit && jit;
+	std::string error;
+	struct timespec start, stop;
+	clock_gettime (CLOCK_MONOTONIC, &start);
+	bool ok = interp.run (stdin, stdout, error);
+	clock_gettime (CLOCK_MONOTONIC, &stop);
+	fflush (stdout);
+	if (options.timeReport != TIME_REPORT_NONE)
+	    fprintf (stderr, "run: %.3f s, %d loops compiled to machine code (%ld bytes)\n",
+		         (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9,
+				 interp.loopsCompiled, interp.nativeBytes);
+	if (!ok)
+	    fprintf (stderr, "runtime error: %s\n", error.c_str ());
+	if (profile) {
+	    printProfile (stderr, path, interp);
+		// (the profile of code compiled with -pgo does not replace the one it was compiled with)
+		Profile lines;
+		collectProfile (interp, lines);
+		if (!options.pgo && !writeProfile (profileFile.c_str (), lines))
+		    fprintf (stderr, "cannot write %s\n", profileFile.c_str ());
+	}
+	return ok ? 0 : 4;
+}
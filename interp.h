@@ -0,0 +1,100 @@
+#ifndef __INTERP_H
+#define __INTERP_H 1
+
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ir.h"
+#include "divconst.h"
+
+struct CompileOptions;
+class Jit;
+
+/*  An interpreter of the intermediate code (-run).
+    Variables start at 0.  iread and fread read a number from the input, iwrite and fwrite
+	print one on a line of the output.  The program stops at halt (or at a runtime error:
+	an integer division by zero, a read with no number to read).
+	An int / or % whose divisor is a constant (a temporary assigned only by a constant earlier in
+	the same block) is a multiplication by its magic number (see divconst.h), not a division.
+
+	With profiling on, the interpreter counts how many times each instruction is executed and
+	how many times each if, ifFalse and case jumped (see profile.h for the report).
+	Otherwise hot loops are compiled to machine code (see jit.h) unless jit is false.
+*/
+
+union Value {
+    int i;
+	double f;
+};
+
+/*  machine code of a loop (see jit.h): it runs from the label of the loop and returns the index
+    of the instruction where the interpreter goes on */
+typedef int (*NativeCode) (Value *temps, Value *variables);
+
+class Interpreter {
+public:
+    // variables: the variables of the program and their types (a variable not there is an int)
+    Interpreter (const std::vector<Instr> &code, const std::map<std::string, myType> &variables,
+	             int tempCount, int labelCount);
+	~Interpreter ();
+
+	/*  run the program.  Returns false (and a message like "line 7: division by zero" in error)
+	    if it stopped on a runtime error */
+	bool run (FILE *in, FILE *out, std::string &error);
+
+	bool profiling;  // set before run ()
+	bool jit;        // compile hot loops (default: true where there is a JIT, see jit.h)
+
+	// profile: for each instruction the number of times it was executed and (for if, ifFalse
+	// and case) the number of times it jumped to its label
+	std::vector<long> counts;
+	std::vector<long> jumps;
+
+	int loopsCompiled;  // loops compiled to machine code by run ()
+	long nativeBytes;   // the size of their code
+
+	const std::vector<Instr> &code;
+
+	// an instruction ready to run: the label and the variable it uses are resolved
+	struct Op {
+	    Opcode opcode;
+		enum op op;
+		myType type;
+		int dest, src1, src2;
+		int src3, src4;  // a select
+		int target;  // index of the instruction of the label
+		int slot;    // index of the variable in _variables
+		union {
+		    Value value;
+			DivMagic magic;  // an int / or % by a constant (multiplier 0: not one, see divconst.h)
+		};
+	};
+
+private:
+    Interpreter (const Interpreter &);  // not copyable
+	Interpreter &operator= (const Interpreter &);
+
+	// a jump from pc back to the label at target was taken: count it and compile the loop
+	// when it is hot
+	void backEdge (size_t target, size_t pc);
+
+	std::vector<Op> _ops;
+	std::vector<Value> _temps;
+	std::vector<myType> _tempTypes;  // the type of each temporary (it does not change)
+	std::vector<Value> _variables;
+	std::vector<myType> _variableTypes;
+
+	Jit *_jit;  // created when the first loop is compiled
+	std::vector<int> _backEdges;      // for each label: jumps back to it (-1: no code for its loop)
+	std::vector<NativeCode> _native;  // for each label: the machine code of the loop it starts
+};
+
+/*  -run: compile the program in 'path' and run it (reading the standard input, writing the
+    standard output).  With profile the profile is printed to stderr (see printProfile ()) and
+	written to <path>.prof (see profile.h).  With jit hot loops are compiled to machine code.
+	Returns the exit status of the compiler: 0, 3 if the program has errors, 4 on a runtime error */
+int runProgram (const char *path, const CompileOptions &options, bool profile, bool jit);
+
+#endif // not defined __INTERP_H
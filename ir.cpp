@@ -0,0 +1,227 @@
+#include <stdio.h>
+#include <string.h>
+#include <charconv>
+
+#include "ir.h"
+
+static
+const char *typeName (myType t)
+{
+    return t == _INT ? "int" : "float";
+}
+
+int formatFloat (char *buf, double value)
+{
+    char *end = std::to_chars (buf, buf + FLOAT_TEXT_SIZE - 3, value).ptr;  // (room for ".0")
+	*end = '\0';
+	if (strchr (buf, '.') != NULL || strpbrk (buf, "0123456789") == NULL)  // (inf and nan stay as they are)
+	    return end - buf;
+	// with no '.' it would be read as an int:  2 is written 2.0, 1e+20 is 1.0e+20
+	char *e = strchr (buf, 'e');
+	char *at = e != NULL ? e : end;
+	memmove (at + 2, at, end - at + 1);
+	at [0] = '.';
+	at [1] = '0';
+	return end - buf + 2;
+}
+
+/*  a line of output:  its text is put together in a buffer and written with one fwrite ().
+    fprintf would parse its format and lock the file for each field.  A name too long for the
+	buffer is written by itself */
+class Line {
+public:
+    Line (FILE *f) { _f = f; _end = _buf; _bytes = 0; }
+
+	void text (const char *s) { text (s, strlen (s)); }
+	void text (const char *s, size_t n)
+	{
+	    if (_end + n > _buf + sizeof _buf) {
+		    flush ();
+			if (n > sizeof _buf) {
+			    _bytes += fwrite (s, 1, n, _f);
+				return;
+			}
+		}
+		memcpy (_end, s, n);
+		_end += n;
+	}
+	void number (int n)
+	{
+	    room (12);
+		_end = std::to_chars (_end, _end + 12, n).ptr;
+	}
+	void real (double value)
+	{
+	    room (FLOAT_TEXT_SIZE);
+		_end += formatFloat (_end, value);
+	}
+	void temp (int t) { text ("_t", 2); number (t); }
+	void label (int l) { text ("label", 5); number (l); }
+
+	// write the rest of the line. Returns the number of bytes of the line
+	int end ()
+	{
+	    flush ();
+		return _bytes;
+	}
+
+private:
+    void room (size_t n)
+	{
+	    if (_end + n > _buf + sizeof _buf)
+		    flush ();
+	}
+	void flush ()
+	{
+	    _bytes += fwrite (_buf, 1, _end - _buf, _f);
+		_end = _buf;
+	}
+
+	FILE *_f;
+	char _buf [128];
+	char *_end;
+	int _bytes;
+};
+
+int printInstr (FILE *f, const Instr &instr)
+{
+    Line line (f);
+    if (instr.opcode == IR_LABEL) {
+	    line.label (instr.label);  // labels are not indented
+		line.text (":\n");
+		return line.end ();
+	}
+
+	line.text ("    ");  // a nice indentation
+
+	switch (instr.opcode) {
+	    case IR_CONST:
+		    line.temp (instr.dest);
+			line.text (" = ");
+		    if (instr.type == _INT)
+			    line.number (instr.value.ival);
+			else
+			    line.real (instr.value.fval);
+			line.text ("\n");
+			break;
+		case IR_LOAD:
+		    line.temp (instr.dest);
+			line.text (" = ");
+			line.text (instr.name);
+			line.text ("\n");
+			break;
+		case IR_CAST:
+		    line.temp (instr.dest);
+			line.text (" = static_cast<");
+			line.text (typeName (instr.type));
+			line.text ("> ");
+			line.temp (instr.src1);
+			line.text ("\n");
+			break;
+		case IR_BINARY:
+		    line.temp (instr.dest);
+			line.text (" = ");
+			line.temp (instr.src1);
+			line.text (" ");
+			line.text (opName (instr.op, instr.type));
+			line.text (" ");
+			line.temp (instr.src2);
+			line.text ("\n");
+			break;
+		case IR_SELECT:
+		    line.temp (instr.dest);
+			line.text (" = ");
+			line.temp (instr.src1);
+			line.text (" ");
+			line.text (relopName (instr.op));
+			line.text (" ");
+			line.temp (instr.src2);
+			line.text (" ? ");
+			line.temp (instr.src3);
+			line.text (" : ");
+			line.temp (instr.src4);
+			line.text ("\n");
+			break;
+		case IR_STORE:
+		    line.text (instr.name);
+			line.text (" = ");
+			line.temp (instr.src1);
+			line.text ("\n");
+			break;
+		case IR_CAST_STORE:
+		    line.text (instr.name);
+			line.text (" = static_cast<");
+			line.text (typeName (instr.type));
+			line.text ("> ");
+			line.temp (instr.src1);
+			line.text ("\n");
+			break;
+		case IR_READ:
+		    line.text (instr.type == _INT ? "iread " : "fread ");
+			line.text (instr.name);
+			line.text ("\n");
+			break;
+		case IR_WRITE:
+		    line.text (instr.type == _INT ? "iwrite " : "fwrite ");
+			line.temp (instr.src1);
+			line.text ("\n");
+			break;
+		case IR_GOTO:
+		    line.text ("goto ");
+			line.label (instr.label);
+			line.text ("\n");
+			break;
+		case IR_IF:
+		case IR_IFFALSE:
+		    line.text (instr.opcode == IR_IF ? "if " : "ifFalse ");
+			line.temp (instr.src1);
+			line.text (" ");
+			line.text (relopName (instr.op));
+			line.text (" ");
+			line.temp (instr.src2);
+			line.text (" goto ");
+			line.label (instr.label);
+			line.text ("\n");
+			break;
+		case IR_CASE:
+		    line.text ("case ");
+			line.temp (instr.src1);
+			line.text (" ");
+		    if (instr.src2 != 0)
+			    line.temp (instr.src2);
+			else
+			    line.number (instr.value.ival);
+			line.text (" ");
+			line.label (instr.label);
+			line.text ("\n");
+			break;
+		case IR_HALT:
+		    line.text ("halt");  // the last line of the output has no newline
+			break;
+		default:
+		    fprintf (stderr, "internal compiler error #4\n");
+	}
+	return line.end ();
+}
+
+long printCode (FILE *f, const std::vector<Instr> &code)
+{
+    long n = 0;
+    for (size_t i = 0; i < code.size (); i++)
+	    n += printInstr (f, code [i]);
+	return n;
+}
+
+void appendRenumbered (std::vector<Instr> &code, const std::vector<Instr> &part, int tempBase, int labelBase)
+{
+    for (size_t i = 0; i < part.size (); i++) {
+	    Instr instr = part [i];
+		if (instr.dest != 0) instr.dest += tempBase;
+		if (instr.src1 != 0) instr.src1 += tempBase;
+		if (instr.src2 != 0) instr.src2 += tempBase;
+		if (instr.src3 != 0) instr.src3 += tempBase;
+		if (instr.src4 != 0) instr.src4 += tempBase;
+		if (instr.label != 0) instr.label += labelBase;
+		code.push_back (instr);
+	}
+}
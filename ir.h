@@ -0,0 +1,78 @@
+#ifndef __IR_H
+#define __IR_H 1
+
+#include <stdio.h>
+#include <vector>
+
+#include "gen.h"  // myType, enum op
+
+/*  The intermediate code (three address code) is kept in memory as a vector of instructions
+    before it is printed.  Each instruction is printed as one line of the output.
+
+    Temporaries and labels are positive numbers (_t17 is 17, label5 is 5).  A field that
+    an instruction does not use is 0.   In the comments below  T is a type (int or float),
+	op is an arithmetic operator or a relational operator and "a" is a variable.
+*/
+enum Opcode {
+    IR_CONST,       // _tD = 17                          (value, type)
+	IR_LOAD,        // _tD = a                           (name)
+	IR_CAST,        // _tD = static_cast<T> _tS1         (type)
+	IR_BINARY,      // _tD = _tS1 op _tS2                (op, type)
+	IR_SELECT,      // _tD = _tS1 op _tS2 ? _tS3 : _tS4  (op: relational, type: of S3 and S4)
+	IR_STORE,       // a = _tS1                          (name)
+	IR_CAST_STORE,  // a = static_cast<T> _tS1           (name, type)
+	IR_READ,        // iread a   or  fread a             (name, type)
+	IR_WRITE,       // iwrite _tS1  or  fwrite _tS1      (type)
+	IR_LABEL,       // labelL:
+	IR_GOTO,        // goto labelL
+	IR_IF,          // if _tS1 op _tS2 goto labelL       (op)
+	IR_IFFALSE,     // ifFalse _tS1 op _tS2 goto labelL  (op)
+	IR_CASE,        // case _tS1 17 labelL               (value)   or
+	                // case _tS1 _tS2 labelL  when S2 is not 0  (used for the default case)
+	IR_HALT         // halt
+};
+
+struct Instr {
+    Instr (Opcode opcode, int dest = 0, int src1 = 0, int src2 = 0, int label = 0)
+	{
+	    this->opcode = opcode; this->dest = dest; this->src1 = src1; this->src2 = src2;
+		this->label = label; op = PLUS; type = _INT; name = NULL; value.ival = 0; line = 0;
+		src3 = src4 = 0;
+	}
+
+    Opcode opcode;
+	int dest;          // the temporary assigned
+	int src1, src2;    // the temporaries used
+	int src3, src4;    // the temporaries a select chooses from (see ifconvert.h)
+	int label;
+	enum op op;
+	myType type;
+	const char *name;  // a variable. Interned in CompilerContext::names (see internName ()): it
+	                   // lives until the end of the compilation, after the AST is freed.  Code
+	                   // read by -read-tac points to the names of its TACProgram
+	union {
+	    int ival;
+		double fval;
+	} value;
+	int line;  // source line the instruction was generated for (0: not known). Not printed
+	           // and not kept in binary IR files.  Used by the profiler (see interp.h)
+};
+
+// print one instruction (a line of output). Returns the number of bytes printed
+int printInstr (FILE *f, const Instr &instr);
+
+/*  the text of a float constant:  the shortest one that reads back (strtod) as exactly value
+    (3.14159 is 3.14159, 0.1 is 0.1), with a '.' so that it reads as a float (see tacreader.cpp):
+	2 is 2.0 and 1e+20 is 1.0e+20.  buf has room for FLOAT_TEXT_SIZE chars.  Returns the length
+	of the text (it ends with a '\0') */
+const int FLOAT_TEXT_SIZE = 32;
+int formatFloat (char *buf, double value);
+
+long printCode (FILE *f, const std::vector<Instr> &code);
+
+/*  append 'part' to 'code', adding tempBase to every temporary and labelBase to every label
+    of part.  Used to put together code generated with numbers starting from 1 (see
+    CompilerContext::generate ()) */
+void appendRenumbered (std::vector<Instr> &code, const std::vector<Instr> &part, int tempBase, int labelBase);
+
+#endif // not defined __IR_H
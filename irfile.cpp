@@ -0,0 +1,324 @@
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "irfile.h"
+
+static
+uint64_t align8 (uint64_t n)
+{
+    return (n + 7) & ~(uint64_t) 7;
+}
+
+// the index of the variable 'name' in the variables section
+static
+uint32_t variableIndex (std::map<std::string, uint32_t> &index, std::vector<IRVariable> &variables,
+                        std::string &strings, const char *name, myType type)
+{
+    std::map<std::string, uint32_t>::iterator it = index.find (name);
+	if (it != index.end ())
+	    return it->second;
+	IRVariable v;
+	v.name = strings.size ();
+	v.type = type;
+	strings.append (name, strlen (name) + 1);
+	variables.push_back (v);
+	index [name] = variables.size () - 1;
+	return variables.size () - 1;
+}
+
+IRRecord encodeRecord (const Instr &instr, uint32_t name)
+{
+    IRRecord r;
+	r.opcode = instr.opcode;
+	r.op = instr.op;
+	r.type = instr.type;
+	r.flags = 0;
+	r.a = r.b = r.c = r.d = r.e = 0;
+	switch (instr.opcode) {
+	    case IR_CONST:
+		    r.a = instr.dest;
+			if (instr.type == _INT)
+			    r.b = instr.value.ival;
+			else
+			    memcpy (&r.b, &instr.value.fval, sizeof (double));  // b and c
+			break;
+		case IR_LOAD:
+		    r.a = instr.dest;
+			r.b = name;
+			break;
+		case IR_CAST:
+		    r.a = instr.dest;
+			r.b = instr.src1;
+			break;
+		case IR_BINARY:
+		    r.a = instr.dest;
+			r.b = instr.src1;
+			r.c = instr.src2;
+			break;
+		case IR_SELECT:
+		    r.a = instr.dest;
+			r.b = instr.src1;
+			r.c = instr.src2;
+			r.d = instr.src3;
+			r.e = instr.src4;
+			break;
+		case IR_STORE:
+		case IR_CAST_STORE:
+		    r.a = name;
+			r.b = instr.src1;
+			break;
+		case IR_READ:
+		    r.a = name;
+			break;
+		case IR_WRITE:
+		    r.a = instr.src1;
+			break;
+		case IR_LABEL:
+		case IR_GOTO:
+		    r.a = instr.label;
+			break;
+		case IR_IF:
+		case IR_IFFALSE:
+		    r.a = instr.src1;
+			r.b = instr.src2;
+			r.c = instr.label;
+			break;
+		case IR_CASE:
+		    r.a = instr.src1;
+			if (instr.src2 != 0) {
+			    r.b = instr.src2;
+				r.flags = 1;
+			} else
+			    r.b = instr.value.ival;
+			r.c = instr.label;
+			break;
+		case IR_HALT:
+		    break;
+	}
+	return r;
+}
+
+int32_t recordName (const IRRecord &r)
+{
+    switch (r.opcode) {
+	    case IR_LOAD:
+		    return r.b;
+		case IR_STORE:
+		case IR_CAST_STORE:
+		case IR_READ:
+		    return r.a;
+		default:
+		    return -1;
+	}
+}
+
+Instr decodeRecord (const IRRecord &r, const char *name)
+{
+	Instr instr ((Opcode) r.opcode);
+	instr.op = (enum op) r.op;
+	instr.type = (myType) r.type;
+	switch (instr.opcode) {
+	    case IR_CONST:
+		    instr.dest = r.a;
+			if (instr.type == _INT)
+			    instr.value.ival = r.b;
+			else
+			    memcpy (&instr.value.fval, &r.b, sizeof (double));
+			break;
+		case IR_LOAD:
+		    instr.dest = r.a;
+			instr.name = name;
+			break;
+		case IR_CAST:
+		    instr.dest = r.a;
+			instr.src1 = r.b;
+			break;
+		case IR_BINARY:
+		    instr.dest = r.a;
+			instr.src1 = r.b;
+			instr.src2 = r.c;
+			break;
+		case IR_SELECT:
+		    instr.dest = r.a;
+			instr.src1 = r.b;
+			instr.src2 = r.c;
+			instr.src3 = r.d;
+			instr.src4 = r.e;
+			break;
+		case IR_STORE:
+		case IR_CAST_STORE:
+		    instr.name = name;
+			instr.src1 = r.b;
+			break;
+		case IR_READ:
+		    instr.name = name;
+			break;
+		case IR_WRITE:
+		    instr.src1 = r.a;
+			break;
+		case IR_LABEL:
+		case IR_GOTO:
+		    instr.label = r.a;
+			break;
+		case IR_IF:
+		case IR_IFFALSE:
+		    instr.src1 = r.a;
+			instr.src2 = r.b;
+			instr.label = r.c;
+			break;
+		case IR_CASE:
+		    instr.src1 = r.a;
+			if (r.flags == 1)
+			    instr.src2 = r.b;
+			else
+			    instr.value.ival = r.b;
+			instr.label = r.c;
+			break;
+		default:
+		    break;
+	}
+	return instr;
+}
+
+long writeBinaryIR (FILE *f, const std::vector<Instr> &code, const std::map<std::string, myType> &symbols,
+                    int tempCount, int labelCount)
+{
+    std::map<std::string, uint32_t> index;
+	std::vector<IRVariable> variables;
+	std::string strings;
+	for (std::map<std::string, myType>::const_iterator it = symbols.begin (); it != symbols.end (); ++it)
+	    variableIndex (index, variables, strings, it->first.c_str (), it->second);
+
+	std::vector<IRRecord> records (code.size ());
+	std::vector<uint32_t> labels (labelCount + 1, NO_LABEL);
+	for (size_t i = 0; i < code.size (); i++) {
+	    const Instr &instr = code [i];
+		uint32_t name = 0;
+		if (instr.name != NULL)
+		    // (a variable that is not declared is an error. Its code is still written)
+		    name = variableIndex (index, variables, strings, instr.name, UNKNOWN);
+		records [i] = encodeRecord (instr, name);
+		if (instr.opcode == IR_LABEL)
+		    labels [instr.label] = i;
+	}
+
+	IRHeader h;
+	memset (&h, 0, sizeof h);
+	memcpy (h.magic, IR_MAGIC, 4);
+	h.version = IR_FORMAT_VERSION;
+	h.variableCount = variables.size ();
+	h.instrCount = records.size ();
+	h.labelCount = labels.size ();
+	h.tempCount = tempCount;
+	h.stringBytes = strings.size ();
+	h.variablesOffset = align8 (sizeof h);
+	h.codeOffset = align8 (h.variablesOffset + variables.size () * sizeof (IRVariable));
+	h.labelsOffset = align8 (h.codeOffset + records.size () * sizeof (IRRecord));
+	h.stringsOffset = align8 (h.labelsOffset + labels.size () * sizeof (uint32_t));
+	h.fileSize = align8 (h.stringsOffset + strings.size ());
+
+	// put everything in one buffer so the file is written with one write
+	std::vector<char> buf (h.fileSize, 0);
+	memcpy (&buf [0], &h, sizeof h);
+	if (!variables.empty ())
+	    memcpy (&buf [h.variablesOffset], &variables [0], variables.size () * sizeof (IRVariable));
+	if (!records.empty ())
+	    memcpy (&buf [h.codeOffset], &records [0], records.size () * sizeof (IRRecord));
+	memcpy (&buf [h.labelsOffset], &labels [0], labels.size () * sizeof (uint32_t));
+	if (!strings.empty ())
+	    memcpy (&buf [h.stringsOffset], strings.data (), strings.size ());
+	return fwrite (&buf [0], 1, buf.size (), f) == buf.size () ? (long) buf.size () : -1;
+}
+
+IRFile::IRFile ()
+{
+    header = NULL; variables = NULL; code = NULL; labels = NULL; strings = NULL;
+	_map = NULL;
+	_size = 0;
+}
+
+IRFile::~IRFile ()
+{
+    if (_map != NULL)
+	    munmap (_map, _size);
+}
+
+// only the header is checked: the file is used as it is
+bool IRFile::open (const char *path, std::string &error)
+{
+    int fd = ::open (path, O_RDONLY);
+	if (fd < 0) {
+	    error = std::string ("cannot open ") + path;
+		return false;
+	}
+	struct stat st;
+	if (fstat (fd, &st) != 0 || (size_t) st.st_size < sizeof (IRHeader)) {
+	    close (fd);
+		error = std::string (path) + " is not a binary IR file";
+		return false;
+	}
+	_size = st.st_size;
+	_map = mmap (NULL, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close (fd);
+	if (_map == MAP_FAILED) {
+	    _map = NULL;
+		error = std::string ("cannot map ") + path;
+		return false;
+	}
+
+	const char *base = (const char *) _map;
+	const IRHeader *h = (const IRHeader *) base;
+	if (memcmp (h->magic, IR_MAGIC, 4) != 0) {
+	    error = std::string (path) + " is not a binary IR file";
+		return false;
+	}
+	if (h->version != IR_FORMAT_VERSION) {
+	    error = std::string (path) + ": unsupported binary IR version";
+		return false;
+	}
+	if (h->fileSize != _size
+	    || h->variablesOffset + (uint64_t) h->variableCount * sizeof (IRVariable) > h->codeOffset
+		|| h->codeOffset + (uint64_t) h->instrCount * sizeof (IRRecord) > h->labelsOffset
+		|| h->labelsOffset + (uint64_t) h->labelCount * sizeof (uint32_t) > h->stringsOffset
+		|| h->stringsOffset + h->stringBytes > h->fileSize
+		|| (h->stringBytes > 0 && base [h->stringsOffset + h->stringBytes - 1] != '\0')) {
+	    error = std::string (path) + ": broken binary IR file";
+		return false;
+	}
+
+	header = h;
+	variables = (const IRVariable *) (base + h->variablesOffset);
+	code = (const IRRecord *) (base + h->codeOffset);
+	labels = (const uint32_t *) (base + h->labelsOffset);
+	strings = base + h->stringsOffset;
+	return true;
+}
+
+Instr IRFile::instr (uint32_t i) const
+{
+    const IRRecord &r = code [i];
+	int32_t name = recordName (r);
+	if (name < 0)
+	    return decodeRecord (r, NULL);
+	// a variable index out of range (a broken file) gets an empty name
+	if ((uint32_t) name < header->variableCount && variables [name].name < header->stringBytes)
+	    return decodeRecord (r, variableName (name));
+	return decodeRecord (r, "");
+}
+
+int dumpBinaryIR (const char *path)
+{
+    IRFile file;
+	std::string error;
+	if (!file.open (path, error)) {
+	    fprintf (stderr, "%s\n", error.c_str ());
+		return 2;
+	}
+	for (uint32_t i = 0; i < file.header->instrCount; i++)
+	    printInstr (stdout, file.instr (i));
+	return 0;
+}
@@ -0,0 +1,121 @@
+#ifndef __IRFILE_H
+#define __IRFILE_H 1
+
+#include <stdio.h>
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ir.h"
+
+/*  A binary file holding the intermediate code of one program (the output of -binary-ir).
+    A program reading it does not parse anything: the file is mapped into memory (see IRFile)
+	and used as it is.
+
+	The file starts with an IRHeader. The sections it points to are (in this order):
+	    variables  an IRVariable for each variable: its name and its type
+		code       an IRRecord for each instruction (all records have the same size)
+		labels     for each label L (0 ... labelCount-1):  the index of the record of  "labelL:"
+		           (NO_LABEL if there is no such label)
+		strings    the names of the variables, each one ending with '\0'
+	Every section starts at a multiple of 8 bytes.  Numbers are little endian (the byte order
+	of the machines we run on).
+*/
+
+#define IR_MAGIC "TACB"
+#define IR_FORMAT_VERSION 2   // change it whenever the format changes
+
+const uint32_t NO_LABEL = 0xffffffff;
+
+struct IRHeader {
+    char magic [4];           // IR_MAGIC
+	uint32_t version;         // IR_FORMAT_VERSION
+	uint32_t variableCount;
+	uint32_t instrCount;
+	uint32_t labelCount;      // 1 + the largest label
+	uint32_t tempCount;       // temporaries are _t1 ... _t<tempCount>
+	uint32_t stringBytes;
+	uint32_t pad;
+	uint64_t variablesOffset; // where the sections start (from the start of the file)
+	uint64_t codeOffset;
+	uint64_t labelsOffset;
+	uint64_t stringsOffset;
+	uint64_t fileSize;
+};
+
+struct IRVariable {
+    uint32_t name;  // offset of the name in the strings section
+	uint32_t type;  // a myType
+};
+
+/*  One instruction.  What a, b, c, d and e hold depends on the opcode (d and e are 0 but for a
+    select):
+        IR_CONST                _tA = B  (an int)  or  _tA = the double in B and C
+		IR_LOAD                 _tA = variable B
+		IR_CAST                 _tA = static_cast<type> _tB
+		IR_BINARY               _tA = _tB op _tC
+		IR_SELECT               _tA = _tB op _tC ? _tD : _tE
+		IR_STORE, IR_CAST_STORE variable A = _tB
+		IR_READ                 read variable A
+		IR_WRITE                write _tA
+		IR_LABEL, IR_GOTO       label A
+		IR_IF, IR_IFFALSE       if _tA op _tB goto label C
+		IR_CASE                 case _tA B label C   (or case _tA _tB label C when flags is 1)
+*/
+struct IRRecord {
+    uint8_t opcode;
+	uint8_t op;
+	uint8_t type;
+	uint8_t flags;
+	int32_t a, b, c, d, e;
+};
+
+/*  the record of an instruction.  name is the index of its variable (if it has one). 
+    Records are also used by the statement cache (see incremental.h) */
+IRRecord encodeRecord (const Instr &instr, uint32_t name);
+
+// the variable index in a record (-1 if the instruction has no variable)
+int32_t recordName (const IRRecord &r);
+
+// the instruction in a record. name is its variable
+Instr decodeRecord (const IRRecord &r, const char *name);
+
+/*  write the code (and the variables it uses) to f as one block. symbols are the
+    variables of the program, tempCount and labelCount the counters of the compilation.
+	Returns the number of bytes written (-1 if the write failed) */
+long writeBinaryIR (FILE *f, const std::vector<Instr> &code, const std::map<std::string, myType> &symbols,
+                    int tempCount, int labelCount);
+
+//  An IRFile gives access to a binary IR file mapped into memory (read only)
+class IRFile {
+public:
+    IRFile ();
+	~IRFile ();
+
+	// map the file. Returns false (and a message in error) if it is not a valid binary IR file
+	bool open (const char *path, std::string &error);
+
+	// the instruction in record i (its name points into the mapped file)
+	Instr instr (uint32_t i) const;
+
+	const char *variableName (uint32_t i) const { return strings + variables [i].name; }
+
+	const IRHeader *header;
+	const IRVariable *variables;
+	const IRRecord *code;
+	const uint32_t *labels;
+	const char *strings;
+
+private:
+    IRFile (const IRFile &);  // not copyable
+	IRFile &operator= (const IRFile &);
+
+    void *_map;
+	size_t _size;
+};
+
+// print the code in a binary IR file as text (the output of the compiler without -binary-ir)
+int dumpBinaryIR (const char *path);
+
+#endif // not defined __IRFILE_H
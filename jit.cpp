@@ -0,0 +1,435 @@
+#include <string.h>
+#include <map>
+
+#include "jit.h"
+
+#if defined (__x86_64__) && defined (__linux__)
+#define JIT_X86_64 1
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef JIT_X86_64
+
+/*  The machine code of a loop is a function  int f (Value *temps, Value *variables):
+    rdi points to the temporaries and rsi to the variables (as the System V ABI passes them).
+	It uses only rax, rcx, rdx, xmm0 and xmm1 (which a function may change) and no stack.
+	Each instruction works on memory:  _t5 is [rdi + 5*8], the variable in slot 2 is [rsi + 2*8] */
+
+enum { EAX = 0, ECX = 1, EDX = 2, ESI = 6, EDI = 7 };  // register numbers (xmm0, xmm1: 0, 1)
+
+// condition codes (of jcc and setcc).  cc ^ 1 is the opposite condition
+enum { CC_P = 0xA, CC_NP = 0xB, CC_AE = 0x3, CC_E = 0x4, CC_NE = 0x5, CC_A = 0x7,
+       CC_L = 0xC, CC_GE = 0xD, CC_LE = 0xE, CC_G = 0xF, CC_ALWAYS = -1 };
+
+class Assembler {
+public:
+    void byte (int b) { code.push_back ((unsigned char) b); }
+	void bytes (const char *b, int n) { code.insert (code.end (), b, b + n); }
+	void int32 (int v) { for (int i = 0; i < 4; i++) byte ((unsigned) v >> (8 * i)); }
+	void int64 (long long v) { for (int i = 0; i < 8; i++) byte ((unsigned long long) v >> (8 * i)); }
+
+	// the opcode (its n bytes) followed by a ModRM byte for  reg, [base + disp32]
+	void rm (const char *opcode, int n, int reg, int base, int disp)
+	{
+	    bytes (opcode, n);
+		byte (0x80 | (reg & 7) << 3 | base);
+		int32 (disp);
+	}
+
+	// jmp (CC_ALWAYS) or jcc with a 32 bit displacement to be patched. Returns its offset
+	size_t jump (int cc)
+	{
+	    if (cc == CC_ALWAYS)
+		    byte (0xE9);
+		else {
+		    byte (0x0F);
+			byte (0x80 | cc);
+		}
+		int32 (0);
+		return code.size () - 4;
+	}
+
+	// make the jump whose displacement is at 'at' go to 'to'
+	void patch (size_t at, size_t to)
+	{
+	    int rel = (int) to - (int) (at + 4);
+		memcpy (&code [at], &rel, 4);
+	}
+
+	std::vector<unsigned char> code;
+};
+
+// the instructions used (their opcode bytes)
+#define MOV_LOAD      "\x8B", 1      // mov r32, m32
+#define MOV_STORE     "\x89", 1      // mov m32, r32
+#define MOV_LOAD64    "\x48\x8B", 2  // mov r64, m64
+#define MOV_STORE64   "\x48\x89", 2  // mov m64, r64
+#define MOV_IMM       "\xC7", 1      // mov m32, imm32 (reg 0)
+#define ADD           "\x03", 1      // add r32, m32
+#define SUB           "\x2B", 1
+#define IMUL          "\x0F\xAF", 2
+#define CMP           "\x3B", 1      // cmp r32, m32
+#define CMP_IMM       "\x81", 1      // cmp m32, imm32 (reg 7)
+#define MOVSD_LOAD    "\xF2\x0F\x10", 3
+#define MOVSD_STORE   "\xF2\x0F\x11", 3
+#define ADDSD         "\xF2\x0F\x58", 3
+#define MULSD         "\xF2\x0F\x59", 3
+#define SUBSD         "\xF2\x0F\x5C", 3
+#define DIVSD         "\xF2\x0F\x5E", 3
+#define CVTSI2SD      "\xF2\x0F\x2A", 3  // xmm, m32
+#define CVTTSD2SI     "\xF2\x0F\x2C", 3  // r32, m64
+
+// the code of one loop
+class LoopCompiler {
+public:
+    LoopCompiler (const std::vector<Interpreter::Op> &ops, size_t begin, size_t end,
+	              const std::vector<myType> &tempTypes, const std::vector<myType> &variableTypes)
+	    : _ops (ops), _begin (begin), _end (end), _tempTypes (tempTypes), _variableTypes (variableTypes) {}
+
+	bool compile ();
+
+	Assembler a;
+
+private:
+    void compileOp (size_t i);
+
+	// a value of type 'from' at [base + disp] stored as type 'to' at [toBase + toDisp]
+	void convert (int base, int disp, myType from, int toBase, int toDisp, myType to);
+	// xmm = the operand (as a double)
+	void loadDouble (int xmm, int temp);
+	// compare the operands of an if, ifFalse or select.  Returns the condition code of "the
+	// condition holds" (the flags are set for it)
+	int compare (const Interpreter::Op &o);
+
+	// an int / or % by a constant: a multiplication by its magic number, no idiv (see divconst.h)
+	void divideByConstant (const Interpreter::Op &o);
+
+	// jump (with cc) to instruction 'target': to its code if it is in the loop, otherwise
+	// back to the interpreter
+	void jumpTo (int cc, size_t target);
+	// back to the interpreter, which goes on with instruction 'target'
+	void exitTo (int cc, size_t target);
+
+	const std::vector<Interpreter::Op> &_ops;
+	size_t _begin, _end;
+	const std::vector<myType> &_tempTypes, &_variableTypes;
+
+	std::vector<size_t> _offsets;  // of the code of each instruction of the loop
+	std::vector<std::pair<size_t, size_t> > _jumps;  // (jump, instruction of the loop)
+	std::map<size_t, std::vector<size_t> > _exits;   // instruction -> jumps returning it
+};
+
+static inline int T (int temp) { return temp * 8; }  // [rdi + T (temp)]
+static inline int V (int slot) { return slot * 8; }  // [rsi + V (slot)]
+
+void LoopCompiler::jumpTo (int cc, size_t target)
+{
+    if (target < _begin || target > _end)
+	    exitTo (cc, target);
+	else
+	    _jumps.push_back (std::make_pair (a.jump (cc), target));
+}
+
+void LoopCompiler::exitTo (int cc, size_t target)
+{
+    _exits [target].push_back (a.jump (cc));
+}
+
+void LoopCompiler::convert (int base, int disp, myType from, int toBase, int toDisp, myType to)
+{
+    if (from == to && to == _INT) {  // (32 bits: a 64-bit load of an int stored with 32 waits for the store)
+	    a.rm (MOV_LOAD, EAX, base, disp);
+		a.rm (MOV_STORE, EAX, toBase, toDisp);
+	} else if (from == to) {
+	    a.rm (MOV_LOAD64, EAX, base, disp);
+		a.rm (MOV_STORE64, EAX, toBase, toDisp);
+	} else if (to == _FLOAT) {
+	    a.rm (CVTSI2SD, 0, base, disp);
+		a.rm (MOVSD_STORE, 0, toBase, toDisp);
+	} else {
+	    a.rm (CVTTSD2SI, EAX, base, disp);  // (int) d, as the interpreter does
+		a.rm (MOV_STORE, EAX, toBase, toDisp);
+	}
+}
+
+void LoopCompiler::loadDouble (int xmm, int temp)
+{
+    if (_tempTypes [temp] == _FLOAT)
+	    a.rm (MOVSD_LOAD, xmm, EDI, T (temp));
+	else
+	    a.rm (CVTSI2SD, xmm, EDI, T (temp));
+}
+
+int LoopCompiler::compare (const Interpreter::Op &o)
+{
+    if (_tempTypes [o.src1] == _INT && _tempTypes [o.src2] == _INT) {
+	    a.rm (MOV_LOAD, EAX, EDI, T (o.src1));
+		a.rm (CMP, EAX, EDI, T (o.src2));
+		switch (o.op) {
+		    case LT: return CC_L;
+			case GT: return CC_G;
+			case LE: return CC_LE;
+			case GE: return CC_GE;
+			case EQ: return CC_E;
+			default: return CC_NE;
+		}
+	}
+	/*  as doubles. ucomisd sets ZF, PF and CF when one of them is a NaN: then only != is true.
+	    a < b is computed as b > a (seta is false for a NaN) */
+	loadDouble (0, o.src1);
+	loadDouble (1, o.src2);
+	if (o.op == LT || o.op == LE)
+	    a.bytes ("\x66\x0F\x2E\xC8", 4);  // ucomisd xmm1, xmm0
+	else
+	    a.bytes ("\x66\x0F\x2E\xC1", 4);  // ucomisd xmm0, xmm1
+	switch (o.op) {
+	    case LT:
+		case GT: a.bytes ("\x0F\x97\xC0", 3); break;  // seta al
+		case LE:
+		case GE: a.bytes ("\x0F\x93\xC0", 3); break;  // setae al
+		case EQ: a.bytes ("\x0F\x94\xC0\x0F\x9B\xC1\x20\xC8", 8); break;  // sete al; setnp cl; and al, cl
+		default: a.bytes ("\x0F\x95\xC0\x0F\x9A\xC1\x08\xC8", 8); break;  // setne al; setp cl; or al, cl
+	}
+	a.bytes ("\x84\xC0", 2);  // test al, al
+	return CC_NE;
+}
+
+// (the steps of divideByMagic () in divconst.h, with a 64-bit product)
+void LoopCompiler::divideByConstant (const Interpreter::Op &o)
+{
+    a.rm ("\x48\x63", 2, EAX, EDI, T (o.src1));  // movsxd rax, n
+	a.bytes ("\x48\x69\xD0", 3);                 // imul rdx, rax, M
+	a.int32 (o.magic.multiplier);
+	if (o.magic.add == 0) {
+	    a.bytes ("\x48\xC1\xFA", 3);  // sar rdx, 32 + s
+		a.byte (32 + o.magic.shift);
+	} else {
+	    a.bytes ("\x48\xC1\xFA\x20", 4);  // sar rdx, 32: the high half
+		a.bytes (o.magic.add > 0 ? "\x01\xC2" : "\x29\xC2", 2);  // add/sub edx, eax
+		if (o.magic.shift != 0) {
+		    a.bytes ("\xC1\xFA", 2);  // sar edx, s
+			a.byte (o.magic.shift);
+		}
+	}
+	a.bytes ("\x89\xD0\xC1\xE8\x1F\x01\xC2", 7);  // mov eax, edx; shr eax, 31; add edx, eax
+	if (o.op == DIV)
+	    a.rm (MOV_STORE, EDX, EDI, T (o.dest));
+	else {
+	    a.rm (IMUL, EDX, EDI, T (o.src2));  // n - q * d
+		a.rm (MOV_LOAD, EAX, EDI, T (o.src1));
+		a.bytes ("\x29\xD0", 2);          // sub eax, edx
+		a.rm (MOV_STORE, EAX, EDI, T (o.dest));
+	}
+}
+
+void LoopCompiler::compileOp (size_t i)
+{
+    const Interpreter::Op &o = _ops [i];
+	switch (o.opcode) {
+	    case IR_LABEL:
+		    break;
+		case IR_CONST:
+		    if (o.type == _INT) {
+			    a.rm (MOV_IMM, 0, EDI, T (o.dest));
+				a.int32 (o.value.i);
+			} else {
+			    long long bits;
+				memcpy (&bits, &o.value.f, 8);
+			    a.byte (0x48);  // mov rax, imm64
+				a.byte (0xB8);
+				a.int64 (bits);
+				a.rm (MOV_STORE64, EAX, EDI, T (o.dest));
+			}
+			break;
+		case IR_LOAD:
+		    convert (ESI, V (o.slot), _variableTypes [o.slot], EDI, T (o.dest), _variableTypes [o.slot]);
+			break;
+		case IR_CAST:
+		    convert (EDI, T (o.src1), _tempTypes [o.src1], EDI, T (o.dest), o.type);
+			break;
+		case IR_STORE:
+		case IR_CAST_STORE:
+		    convert (EDI, T (o.src1), _tempTypes [o.src1], ESI, V (o.slot), _variableTypes [o.slot]);
+			break;
+		case IR_BINARY:
+		    if (o.type == _FLOAT) {
+			    if (o.op == POW || o.op == MODULO) {
+				    exitTo (CC_ALWAYS, i);
+					break;
+				}
+				a.rm (MOVSD_LOAD, 0, EDI, T (o.src1));
+				switch (o.op) {
+				    case PLUS:  a.rm (ADDSD, 0, EDI, T (o.src2)); break;
+					case MINUS: a.rm (SUBSD, 0, EDI, T (o.src2)); break;
+					case MUL:   a.rm (MULSD, 0, EDI, T (o.src2)); break;
+					default:    a.rm (DIVSD, 0, EDI, T (o.src2)); break;
+				}
+				a.rm (MOVSD_STORE, 0, EDI, T (o.dest));
+				break;
+			}
+			switch (o.op) {
+			    case PLUS:
+				case MINUS:
+				case MUL:
+				    a.rm (MOV_LOAD, EAX, EDI, T (o.src1));
+					if (o.op == PLUS)
+					    a.rm (ADD, EAX, EDI, T (o.src2));
+					else if (o.op == MINUS)
+					    a.rm (SUB, EAX, EDI, T (o.src2));
+					else
+					    a.rm (IMUL, EAX, EDI, T (o.src2));
+					a.rm (MOV_STORE, EAX, EDI, T (o.dest));
+					break;
+				case DIV:
+				case MODULO:
+				    if (o.magic.multiplier != 0) {
+					    divideByConstant (o);
+						break;
+					}
+				    // x / 0: the interpreter reports it.  x / -1 is -x (INT_MIN / -1 would trap)
+				    a.rm (MOV_LOAD, ECX, EDI, T (o.src2));
+					a.bytes ("\x85\xC9", 2);          // test ecx, ecx
+					exitTo (CC_E, i);
+					a.rm (MOV_LOAD, EAX, EDI, T (o.src1));
+					a.bytes ("\x83\xF9\xFF", 3);      // cmp ecx, -1
+					a.bytes ("\x75\x04", 2);          // jne 1f
+					if (o.op == DIV) {
+					    a.bytes ("\xF7\xD8", 2);      // neg eax
+						a.bytes ("\xEB\x03", 2);      // jmp 2f
+						a.bytes ("\x99\xF7\xF9", 3);  // 1: cdq; idiv ecx
+					} else {
+					    a.bytes ("\x31\xC0", 2);      // xor eax, eax
+						a.bytes ("\xEB\x05", 2);      // jmp 2f
+						a.bytes ("\x99\xF7\xF9\x89\xD0", 5);  // 1: cdq; idiv ecx; mov eax, edx
+					}
+					a.rm (MOV_STORE, EAX, EDI, T (o.dest));  // 2:
+					break;
+				default:  // POW
+				    exitTo (CC_ALWAYS, i);
+					break;
+			}
+			break;
+		case IR_IF:
+		case IR_IFFALSE: {
+		    int cc = compare (o);
+			jumpTo (o.opcode == IR_IF ? cc : cc ^ 1, o.target);
+			break;
+		}
+		case IR_SELECT: {
+		    // (the values are moved as 64 bits for the bits of a double, as 32 for an int)
+		    int cc = compare (o);
+			char cmov [3] = { '\x48', '\x0F', (char) (0x40 | cc) };  // cmovcc r64, m64
+			if (o.type == _INT) {
+			    a.rm (MOV_LOAD, EDX, EDI, T (o.src4));
+				a.rm (cmov + 1, 2, EDX, EDI, T (o.src3));  // cmovcc r32, m32
+				a.rm (MOV_STORE, EDX, EDI, T (o.dest));
+			} else {
+			    a.rm (MOV_LOAD64, EDX, EDI, T (o.src4));
+				a.rm (cmov, 3, EDX, EDI, T (o.src3));
+				a.rm (MOV_STORE64, EDX, EDI, T (o.dest));
+			}
+			break;
+		}
+		case IR_CASE:
+		    if (o.src2 != 0)
+			    jumpTo (CC_ALWAYS, o.target);
+			else {
+			    a.rm (CMP_IMM, 7, EDI, T (o.src1));
+				a.int32 (o.value.i);
+				jumpTo (CC_E, o.target);
+			}
+			break;
+		case IR_GOTO:
+		    jumpTo (CC_ALWAYS, o.target);
+			break;
+		default:  // read, write, halt: done by the interpreter
+		    exitTo (CC_ALWAYS, i);
+			break;
+	}
+}
+
+bool LoopCompiler::compile ()
+{
+    for (size_t i = _begin; i <= _end; i++) {
+	    const Interpreter::Op &o = _ops [i];
+		// the displacements are 32 bits
+		if (o.dest >= (1 << 28) || o.src1 >= (1 << 28) || o.src2 >= (1 << 28) || o.src3 >= (1 << 28)
+		    || o.src4 >= (1 << 28) || o.slot >= (1 << 28))
+		    return false;
+	}
+	_offsets.resize (_end - _begin + 1);
+	for (size_t i = _begin; i <= _end; i++) {
+	    _offsets [i - _begin] = a.code.size ();
+		compileOp (i);
+	}
+	exitTo (CC_ALWAYS, _end + 1);  // the end of the loop (after its last instruction)
+
+	for (size_t j = 0; j < _jumps.size (); j++)
+	    a.patch (_jumps [j].first, _offsets [_jumps [j].second - _begin]);
+	for (std::map<size_t, std::vector<size_t> >::iterator it = _exits.begin (); it != _exits.end (); ++it) {
+	    for (size_t j = 0; j < it->second.size (); j++)
+		    a.patch (it->second [j], a.code.size ());
+		a.byte (0xB8);  // mov eax, instruction
+		a.int32 (it->first);
+		a.byte (0xC3);  // ret
+	}
+	return true;
+}
+
+bool Jit::available ()
+{
+    return true;
+}
+
+NativeCode Jit::compile (const std::vector<Interpreter::Op> &ops, size_t begin, size_t end,
+                         const std::vector<myType> &tempTypes, const std::vector<myType> &variableTypes,
+						 size_t &size)
+{
+    if (end < begin || end - begin + 1 > JIT_MAX_LOOP || end >= ops.size ())
+	    return NULL;
+	LoopCompiler loop (ops, begin, end, tempTypes, variableTypes);
+	if (!loop.compile ())
+	    return NULL;
+
+	// written while the memory is not executable, then executable and not writable
+	size = loop.a.code.size ();
+	size_t page = sysconf (_SC_PAGESIZE);
+	size_t length = (size + page - 1) / page * page;
+	void *p = mmap (NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (p == MAP_FAILED)
+	    return NULL;
+	memcpy (p, &loop.a.code [0], size);
+	if (mprotect (p, length, PROT_READ | PROT_EXEC) != 0) {
+	    munmap (p, length);
+		return NULL;
+	}
+	_pages.push_back (std::make_pair (p, length));
+	return (NativeCode) p;
+}
+
+Jit::~Jit ()
+{
+    for (size_t i = 0; i < _pages.size (); i++)
+	    munmap (_pages [i].first, _pages [i].second);
+}
+
+#else  // no JIT here
+
+bool Jit::available ()
+{
+    return false;
+}
+
+NativeCode Jit::compile (const std::vector<Interpreter::Op> &ops, size_t begin, size_t end,
+                         const std::vector<myType> &tempTypes, const std::vector<myType> &variableTypes,
+						 size_t &size)
+{
+    return NULL;
+}
+
+Jit::~Jit ()
+{
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef __JIT_H
+#define __JIT_H 1
+
+#include <stddef.h>
+#include <utility>
+#include <vector>
+
+#include "interp.h"
+
+/*  A JIT compiler of hot loops for the interpreter (x86-64 Linux only: elsewhere Jit::available ()
+    is false and everything is interpreted).
+
+    The interpreter counts the jumps back to each label. When a label got JIT_THRESHOLD of them,
+	the code from the label to the jump back is compiled to machine code (one instruction after
+	the other, with the temporaries and the variables kept in the arrays of the interpreter), put
+	in memory mapped with mmap () and made executable (PROT_READ | PROT_EXEC, never writable at the
+	same time).  From then on the interpreter calls it each time it gets to the label.
+	The machine code returns to the interpreter (the index of the instruction to go on with) when
+	the loop jumps out of the code compiled, and before the instructions it does not compile:
+	iread, iwrite, fread, fwrite, halt, ** (pow), float % and an int / or % by zero (so the
+	interpreter reports the error).  So a loop with a write in it goes back to the interpreter
+	for the write, and then into the machine code again at its next iteration.
+	A select (see ifconvert.h) is a compare and a cmov, with no jump.  An int / or % by a constant
+	is a multiplication by its magic number (see divconst.h), with no idiv and no test for 0.
+*/
+
+#define JIT_THRESHOLD 100     // jumps back to a label before its loop is compiled
+#define JIT_MAX_LOOP 10000    // instructions of the largest loop compiled
+
+class Jit {
+public:
+    Jit () {}
+	~Jit ();  // frees the code
+
+	// false where there is no JIT (not x86-64 Linux)
+	static bool available ();
+
+	/*  compile the loop ops [begin, end]: begin is its label, end the jump back to it.
+	    Returns NULL if it could not be compiled (size: the size of the code) */
+	NativeCode compile (const std::vector<Interpreter::Op> &ops, size_t begin, size_t end,
+	                    const std::vector<myType> &tempTypes, const std::vector<myType> &variableTypes,
+						size_t &size);
+
+private:
+    Jit (const Jit &);  // not copyable
+	Jit &operator= (const Jit &);
+
+	std::vector<std::pair<void *, size_t> > _pages;  // the memory mapped for the code
+};
+
+#endif // not defined __JIT_H
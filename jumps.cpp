@@ -0,0 +1,347 @@
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "jumps.h"
+
+#define MAX_ROUNDS 10   // each round of the passes usually finds nothing new after 2 or 3
+#define MAX_CHAIN 100   // gotos and tests a jump is threaded through
+
+// the outcomes of a comparison (unordered: a float that is not a number)
+enum { LESS = 1, EQUAL = 2, GREATER = 4, UNORDERED = 8 };
+
+// the outcomes for which a comparison is true
+static
+int outcomes (enum op op)
+{
+    switch (op) {
+	    case LT: return LESS;
+		case LE: return LESS | EQUAL;
+		case GT: return GREATER;
+		case GE: return GREATER | EQUAL;
+		case EQ: return EQUAL;
+		case NE: return LESS | GREATER | UNORDERED;
+		default: return 0;
+	}
+}
+
+// a op b  is  b mirror (op) a
+static
+enum op mirror (enum op op)
+{
+    switch (op) {
+	    case LT: return GT;
+		case LE: return GE;
+		case GT: return LT;
+		case GE: return LE;
+		default: return op;
+	}
+}
+
+// what a temporary compared by a test holds: a variable or a constant
+struct Operand {
+    enum { NONE, VARIABLE, CONSTANT } kind;  // NONE: not known
+	const char *name;
+	Instr constant;
+
+	Operand () : constant (IR_CONST) { kind = NONE; name = NULL; }
+	bool operator== (const Operand &other) const
+	{
+	    if (kind == NONE || kind != other.kind)
+		    return false;
+		if (kind == VARIABLE)
+		    return strcmp (name, other.name) == 0;
+		if (constant.type != other.constant.type)
+		    return false;
+		return constant.type == _INT ? constant.value.ival == other.constant.value.ival
+		                             : constant.value.fval == other.constant.value.fval;
+	}
+};
+
+/*  the jumps of the code and where their labels are.  Rebuilt after each change of the order
+    of the instructions */
+struct JumpCode {
+    JumpCode (std::vector<Instr> &code, const std::map<std::string, myType> &variables);
+
+	// the first instruction from i on that is not a label (code.size () if there is none)
+	size_t next (size_t i) const
+	{
+	    while (i < code.size () && code [i].opcode == IR_LABEL)
+		    i++;
+		return i;
+	}
+	// the index of a label (code.size () if it is not in the code)
+	size_t labelAt (int label) const
+	{
+	    return label > 0 && (size_t) label < labels.size () && labels [label] >= 0 ? labels [label] : code.size ();
+	}
+	// what temp holds at the instruction at (set in the block of the instruction)
+	Operand operand (size_t at, int temp) const;
+	myType type (const Operand &o) const;
+
+	/*  if the test of the block starting at t is decided when the test 'jump' went the way
+	    'taken' (and nothing was assigned since), the label where that block goes.  Else 0.
+		A label needed after the test block is added to newLabels */
+	int decide (size_t jump, bool taken, size_t t, std::map<size_t, int> &newLabels, int &labelCounter) const;
+
+	// put the code back together without the instructions marked dead and with the ones to insert
+	// (before the instruction at their index)
+	void rebuild (const std::vector<bool> &dead, const std::multimap<size_t, Instr> &inserts);
+
+	std::vector<Instr> &code;
+	const std::map<std::string, myType> &variables;
+	std::vector<int> labels;  // the index of each label (-1: none)
+	std::vector<int> uses;    // the uses of each temporary
+};
+
+JumpCode::JumpCode (std::vector<Instr> &code, const std::map<std::string, myType> &variables)
+    : code (code), variables (variables)
+{
+    rebuild (std::vector<bool> (code.size (), false), std::multimap<size_t, Instr> ());
+}
+
+void JumpCode::rebuild (const std::vector<bool> &dead, const std::multimap<size_t, Instr> &inserts)
+{
+    if (!inserts.empty () || std::find (dead.begin (), dead.end (), true) != dead.end ()) {
+	    std::vector<Instr> out;
+		out.reserve (code.size () + inserts.size ());
+		std::multimap<size_t, Instr>::const_iterator it = inserts.begin ();
+		for (size_t i = 0; i <= code.size (); i++) {
+		    for (; it != inserts.end () && it->first == i; ++it)
+			    out.push_back (it->second);
+			if (i < code.size () && !dead [i])
+			    out.push_back (code [i]);
+		}
+		code.swap (out);
+	}
+
+	labels.clear ();
+	uses.clear ();
+	for (size_t i = 0; i < code.size (); i++) {
+	    const Instr &instr = code [i];
+		if (instr.opcode == IR_LABEL) {
+		    if ((size_t) instr.label >= labels.size ())
+			    labels.resize (instr.label + 1, -1);
+			labels [instr.label] = i;
+		}
+		int temps [2] = { instr.src1, instr.src2 };
+		for (int t = 0; t < 2; t++)
+		    if (temps [t] > 0) {
+			    if ((size_t) temps [t] >= uses.size ())
+				    uses.resize (temps [t] + 1, 0);
+				uses [temps [t]]++;
+			}
+	}
+}
+
+Operand JumpCode::operand (size_t at, int temp) const
+{
+    Operand o;
+	std::vector<const char *> assigned;  // variables assigned between the definition and 'at'
+	for (size_t i = at; i-- > 0; ) {
+	    const Instr &instr = code [i];
+		if (instr.opcode == IR_LABEL || instr.opcode == IR_GOTO || instr.opcode == IR_IF
+		    || instr.opcode == IR_IFFALSE || instr.opcode == IR_CASE || instr.opcode == IR_HALT)
+			break;  // the start of the block
+		if (instr.opcode == IR_STORE || instr.opcode == IR_CAST_STORE || instr.opcode == IR_READ)
+		    assigned.push_back (instr.name);
+		if (instr.dest != temp)
+		    continue;
+		if (instr.opcode == IR_CONST) {
+		    o.kind = Operand::CONSTANT;
+			o.constant = instr;
+		} else if (instr.opcode == IR_LOAD) {
+		    for (size_t v = 0; v < assigned.size (); v++)
+			    if (strcmp (assigned [v], instr.name) == 0)
+				    return o;
+			o.kind = Operand::VARIABLE;
+			o.name = instr.name;
+		}
+		break;
+	}
+	return o;
+}
+
+myType JumpCode::type (const Operand &o) const
+{
+    if (o.kind == Operand::CONSTANT)
+	    return o.constant.type;
+	std::map<std::string, myType>::const_iterator it = variables.find (o.name);
+	return it == variables.end () ? _INT : it->second;
+}
+
+int JumpCode::decide (size_t jump, bool taken, size_t t, std::map<size_t, int> &newLabels, int &labelCounter) const
+{
+    const Instr &j = code [jump];
+	Operand x = operand (jump, j.src1), y = operand (jump, j.src2);
+	if (x.kind == Operand::NONE || y.kind == Operand::NONE)
+	    return 0;
+	int all = LESS | EQUAL | GREATER;
+	if (type (x) == _FLOAT || type (y) == _FLOAT)
+	    all |= UNORDERED;
+	// the outcomes possible where the jump went
+	int known = taken == (j.opcode == IR_IF) ? outcomes (j.op) : all & ~outcomes (j.op);
+
+	// the test block: loads and constants used only by its test
+	size_t k = t;
+	while (k < code.size () && (code [k].opcode == IR_LOAD || code [k].opcode == IR_CONST))
+	    k++;
+	if (k + 1 >= code.size () || (code [k].opcode != IR_IF && code [k].opcode != IR_IFFALSE))
+	    return 0;
+	const Instr &test = code [k];
+	for (size_t i = t; i < k; i++)
+	    if (code [i].dest >= (int) uses.size () || uses [code [i].dest] != 1
+		    || (test.src1 != code [i].dest && test.src2 != code [i].dest))
+			return 0;
+	Operand u = operand (k, test.src1), v = operand (k, test.src2);
+	enum op op = test.op;
+	if (u == y && v == x)
+	    op = mirror (op);
+	else if (!(u == x && v == y))
+	    return 0;
+
+	bool result;
+	if ((known & ~outcomes (op)) == 0)
+	    result = true;
+	else if ((known & outcomes (op)) == 0)
+	    result = false;
+	else
+	    return 0;
+	if (result == (test.opcode == IR_IF))
+	    return test.label;
+	if (code [k + 1].opcode == IR_LABEL)
+	    return code [k + 1].label;
+	int &label = newLabels [k + 1];
+	if (label == 0)
+	    label = ++labelCounter;
+	return label;
+}
+
+static
+bool isJump (const Instr &instr)
+{
+    return instr.opcode == IR_GOTO || instr.opcode == IR_IF || instr.opcode == IR_IFFALSE || instr.opcode == IR_CASE;
+}
+
+// the jump goes to its label whatever happens
+static
+bool unconditional (const Instr &instr)
+{
+    return instr.opcode == IR_GOTO || (instr.opcode == IR_CASE && instr.src2 != 0);
+}
+
+// jumps to gotos and to tests they decide go where those go
+static
+int thread (JumpCode &c, int &labelCounter)
+{
+    std::vector<Instr> &code = c.code;
+    int changes = 0;
+	std::map<size_t, int> newLabels;
+	std::multimap<size_t, Instr> inserts;
+	for (size_t j = 0; j < code.size (); j++) {
+	    if (!isJump (code [j]))
+		    continue;
+		bool test = code [j].opcode == IR_IF || code [j].opcode == IR_IFFALSE;
+		int label = code [j].label;
+		for (int hops = 0; hops < MAX_CHAIN; hops++) {
+		    size_t at = c.labelAt (label);
+			if (at == code.size ())  // a label added by this pass
+			    break;
+			size_t t = c.next (at);
+			if (t < code.size () && code [t].opcode == IR_GOTO && code [t].label != label) {
+			    label = code [t].label;
+				continue;
+			}
+			int decided = test ? c.decide (j, true, t, newLabels, labelCounter) : 0;
+			if (decided == 0)
+			    break;
+			label = decided;
+		}
+		if (label != code [j].label) {
+		    code [j].label = label;
+			changes++;
+		}
+		if (test) {
+		    // the test it falls through to
+		    int decided = c.decide (j, false, c.next (j + 1), newLabels, labelCounter);
+			if (decided != 0) {
+			    Instr jump (IR_GOTO, 0, 0, 0, decided);
+				jump.line = code [j].line;
+			    inserts.insert (std::make_pair (j + 1, jump));
+				changes++;
+			}
+		}
+	}
+	for (std::map<size_t, int>::const_iterator it = newLabels.begin (); it != newLabels.end (); ++it)
+	    inserts.insert (std::make_pair (it->first, Instr (IR_LABEL, 0, 0, 0, it->second)));
+	c.rebuild (std::vector<bool> (code.size (), false), inserts);
+	return changes;
+}
+
+// remove jumps to the next instruction, code no label leads to and labels no jump goes to
+static
+int clean (JumpCode &c)
+{
+    std::vector<Instr> &code = c.code;
+    int changes = 0;
+	std::vector<bool> dead (code.size (), false);
+	for (size_t i = 0; i < code.size (); i++) {
+	    Instr &instr = code [i];
+		if (dead [i] || !isJump (instr))
+		    continue;
+		size_t at = c.labelAt (instr.label);
+		// if c goto L1  goto L2  L1:   is   ifFalse c goto L2  L1:
+		if ((instr.opcode == IR_IF || instr.opcode == IR_IFFALSE) && i + 1 < code.size ()
+		    && code [i + 1].opcode == IR_GOTO && at > i + 1 && at < code.size () && c.next (i + 2) == c.next (at)) {
+			instr.opcode = instr.opcode == IR_IF ? IR_IFFALSE : IR_IF;
+			instr.label = code [i + 1].label;
+			dead [i + 1] = true;
+			changes++;
+			continue;
+		}
+		// a jump to the next instruction
+		if (at > i && at < code.size () && c.next (i + 1) == c.next (at)) {
+		    dead [i] = true;
+			changes++;
+		}
+	}
+	// the code after a goto (or a halt) up to the next label is not executed
+	for (size_t i = 0; i < code.size (); i++)
+	    if (!dead [i] && (unconditional (code [i]) || code [i].opcode == IR_HALT))
+		    for (size_t j = i + 1; j < code.size () && code [j].opcode != IR_LABEL; j++)
+			    if (!dead [j]) {
+				    dead [j] = true;
+					changes++;
+				}
+	std::vector<bool> used;
+	for (size_t i = 0; i < code.size (); i++)
+	    if (!dead [i] && isJump (code [i])) {
+		    if ((size_t) code [i].label >= used.size ())
+			    used.resize (code [i].label + 1, false);
+			used [code [i].label] = true;
+		}
+	for (size_t i = 0; i < code.size (); i++)
+	    if (code [i].opcode == IR_LABEL && ((size_t) code [i].label >= used.size () || !used [code [i].label])) {
+		    dead [i] = true;
+			changes++;
+		}
+	c.rebuild (dead, std::multimap<size_t, Instr> ());
+	return changes;
+}
+
+int threadJumps (std::vector<Instr> &code, const std::map<std::string, myType> &variables, int &labelCounter)
+{
+    JumpCode c (code, variables);
+	int total = 0;
+	for (int round = 0; round < MAX_ROUNDS; round++) {
+	    int changes = thread (c, labelCounter);
+		changes += clean (c);
+		if (changes == 0)
+		    break;
+		total += changes;
+	}
+	return total;
+}
@@ -0,0 +1,29 @@
+#ifndef __JUMPS_H
+#define __JUMPS_H 1
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ir.h"
+
+/*  Jump threading and label cleanup over the code of a whole program (-thread-jumps).
+
+    The code of and, or and $$ conditions and of nested statements has jumps to gotos, gotos to
+	the next instruction, "if ... goto L1  goto L2  L1:" and labels nothing jumps to.  The pass
+	repeats these until the code does not change:
+	  - a jump to a goto (or a chain of them) jumps where the last goto goes
+	  - a jump to a test decided by the jump (the same comparison of the same variables or
+	    constants, with no assignment between them) jumps where the test would go:  after
+		"if a < b goto L1", at L1 "_t7 = a  _t8 = b  if _t7 <= _t8 goto L2" the jump goes to L2.
+		(the test block must compute nothing used elsewhere)
+	  - "if c goto L1  goto L2  L1:" becomes "ifFalse c goto L2  L1:" (and ifFalse becomes if)
+	  - a jump to the next instruction is removed, and so is the code after a goto that no
+	    label leads to
+	  - a label no jump goes to is removed
+	variables: the types of the variables (a variable not there is an int).  New labels are numbered
+	after labelCounter.  Returns the number of changes made
+*/
+int threadJumps (std::vector<Instr> &code, const std::map<std::string, myType> &variables, int &labelCounter);
+
+#endif // not defined __JUMPS_H
@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "context.h"
+#include "batch.h"
+#include "server.h"
+#include "cache.h"
+#include "irfile.h"
+#include "tacreader.h"
+#include "incremental.h"
+#include "trace.h"
+#include "interp.h"
+
+static
+void usage (const char *prog)
+{
+    fprintf (stderr, "Usage: %s [options] <input-file-name>\n", prog);
+	fprintf (stderr, "       %s [options] [-j threads] [-o output-dir] [-v] -batch <file | directory | @listfile> ...\n", prog);
+	fprintf (stderr, "       %s [options] [-j threads] -server <socket>\n", prog);
+	fprintf (stderr, "       %s -connect <socket> <input-file-name>\n", prog);
+	fprintf (stderr, "       %s -dump-ir <binary-ir-file>\n", prog);
+	fprintf (stderr, "       %s [-binary-ir] -read-tac <code-file>\n", prog);
+	fprintf (stderr, "       %s -run [-profile] [-no-jit] <input-file-name>\n", prog);
+	fprintf (stderr, "options:\n");
+	fprintf (stderr, "  -cache <dir>      keep compilations in a cache in directory <dir>\n");
+	fprintf (stderr, "  -cache-size <MB>  size limit of the cache (default 256)\n");
+	fprintf (stderr, "  -cache-stats      print the number of cache hits and misses\n");
+	fprintf (stderr, "  -gen-threads=N    generate the code of each program with N threads (0: one per core)\n");
+	fprintf (stderr, "  -binary-ir        write the code as a binary IR file (see irfile.h), not as text\n");
+	fprintf (stderr, "  -stream           compile each statement of the outermost block as soon as it is read\n");
+	fprintf (stderr, "  -trace <file>     write trace events (Chrome trace format) to <file>\n");
+	fprintf (stderr, "  -time-report[=json] print the time of each phase of the compilation and some counters\n");
+	fprintf (stderr, "  -incremental      keep the code of each statement in <input-file-name>.inc and reuse it\n");
+	fprintf (stderr, "                    for the statements that did not change (-v: print how many)\n");
+	fprintf (stderr, "  -run              compile the program and run it (input: stdin, output: stdout)\n");
+	fprintf (stderr, "  -profile          with -run: print to stderr how many times each line was executed\n");
+	fprintf (stderr, "                    and keep the profile in <input-file-name>.prof\n");
+	fprintf (stderr, "  -no-jit           with -run: interpret everything (no machine code for hot loops)\n");
+	fprintf (stderr, "  -pgo              use the profile in <input-file-name>.prof to optimize the code\n");
+	fprintf (stderr, "  -ssa              put the code in SSA form, remove its dead code and put it back\n");
+	fprintf (stderr, "  -print-ssa        write the SSA form of the code instead of the code (not with\n");
+	fprintf (stderr, "                    -binary-ir or -run)\n");
+	fprintf (stderr, "  -rotate-loops     test the condition of a loop before it and at its bottom (one jump\n");
+	fprintf (stderr, "                    per iteration instead of two)\n");
+	fprintf (stderr, "  -thread-jumps     make jumps to jumps (and to tests they decide) go where those go and\n");
+	fprintf (stderr, "                    remove the jumps and labels that are not needed\n");
+	fprintf (stderr, "  -if-convert       compute both values of an if that assigns one variable and select one\n");
+	fprintf (stderr, "                    (no jump)\n");
+	fprintf (stderr, "  -flat-ast         keep expressions in flat arrays, not as objects (same code)\n");
+}
+
+int main (int argc, char **argv)
+{
+  BatchOptions batch;
+  bool batchMode = false;
+  const char *serverSocket = NULL;  // -server
+  const char *clientSocket = NULL;  // -connect
+  const char *dumpFile = NULL;      // -dump-ir
+  const char *tacFile = NULL;       // -read-tac
+  std::vector<std::string> inputs;
+  const char *traceFile = NULL;     // -trace
+  const char *cacheDir = NULL;
+  unsigned long long cacheSize = 256;  // MB
+  bool cacheStats = false;
+  bool run = false;                 // -run
+  bool profile = false;             // -profile
+  bool jit = true;                  // not -no-jit
+  
+  for (int i = 1; i < argc; i++) {
+      const char *arg = argv [i];
+	  if (strcmp (arg, "-batch") == 0)
+	      batchMode = true;
+	  else if (strcmp (arg, "-j") == 0 && i + 1 < argc)
+	      batch.threads = atoi (argv [++i]);
+	  else if (strcmp (arg, "-o") == 0 && i + 1 < argc)
+	      batch.outdir = argv [++i];
+	  else if (strcmp (arg, "-server") == 0 && i + 1 < argc)
+	      serverSocket = argv [++i];
+	  else if (strcmp (arg, "-connect") == 0 && i + 1 < argc)
+	      clientSocket = argv [++i];
+	  else if (strcmp (arg, "-dump-ir") == 0 && i + 1 < argc)
+	      dumpFile = argv [++i];
+	  else if (strcmp (arg, "-read-tac") == 0 && i + 1 < argc)
+	      tacFile = argv [++i];
+	  else if (strcmp (arg, "-v") == 0)
+	      batch.verbose = true;
+	  else if (strcmp (arg, "-cache") == 0 && i + 1 < argc)
+	      cacheDir = argv [++i];
+	  else if (strcmp (arg, "-cache-size") == 0 && i + 1 < argc)
+	      cacheSize = strtoull (argv [++i], NULL, 10);
+	  else if (strcmp (arg, "-trace") == 0 && i + 1 < argc)
+	      traceFile = argv [++i];
+	  else if (strcmp (arg, "-run") == 0)
+	      run = true;
+	  else if (strcmp (arg, "-profile") == 0)
+	      profile = true;
+	  else if (strcmp (arg, "-no-jit") == 0)
+	      jit = false;
+	  else if (strcmp (arg, "-cache-stats") == 0)
+	      cacheStats = true;
+	  else if (parseCompileOption (batch.compile, arg))
+	      ;
+	  else if (arg [0] == '-' && arg [1] != '\0') {
+	      usage (argv [0]);
+		  return 1;
+	  } else
+	      inputs.push_back (arg);
+  }
+  
+  // the SSA form is only written as text (see CompilerContext::finishCode ())
+  if (batch.compile.printSSA && (batch.compile.binaryIR || run)) {
+      fprintf (stderr, "-print-ssa cannot be used with -binary-ir or -run\n");
+	  usage (argv [0]);
+	  return 1;
+  }
+  
+  if (dumpFile != NULL)
+      return dumpBinaryIR (dumpFile);
+  if (tacFile != NULL)
+      return convertTAC (tacFile, batch.compile.binaryIR);
+	  
+  if (traceFile != NULL) {
+      if (!traceOpen (traceFile))
+	      return 2;
+	  atexit (traceClose);
+  }
+	  
+  CompileCache *cache = NULL;
+  if (cacheDir != NULL) {
+      cache = new CompileCache (cacheDir, cacheSize * 1024 * 1024);
+	  if (!cache->ok ())
+	      return 2;
+	  batch.cache = cache;
+  }
+  
+  if (serverSocket != NULL)
+      return runServer (serverSocket, batch.threads, cache);
+  
+  if (batchMode) {
+      if (inputs.empty ()) {
+	      usage (argv [0]);
+		  return 1;
+	  }
+      int status = compileBatch (inputs, batch);
+	  if (cacheStats && cache != NULL)
+	      cache->printStats (stderr);
+	  return status;
+  }
+  
+  if (inputs.size () != 1) {
+     usage (argv [0]);
+	 return 1;
+  }
+  if (clientSocket != NULL)
+      return runClient (clientSocket, inputs [0].c_str ());
+  if (run)
+      return runProgram (inputs [0].c_str (), batch.compile, profile, jit);
+	  
+  FILE *in = fopen (inputs [0].c_str (), "r");
+  if (in == NULL) {
+       fprintf (stderr, "failed to open %s\n", inputs [0].c_str ());
+	   return 2;
+  }
+  
+  CompilerContext ctx;
+  ctx.options = batch.compile;
+  ctx.incrementalFile = inputs [0] + ".inc";
+  ctx.profileFile = inputs [0] + ".prof";
+  {
+      TraceSpan span ("compile", inputs [0].c_str ());
+      compileCached (ctx, in, cache);
+  }
+  if (batch.verbose && ctx.options.incremental)
+      printReuse (stderr, ctx.statementsReused, ctx.statementsTotal);
+  if (ctx.options.timeReport != TIME_REPORT_NONE)
+      ctx.stats.print (stderr, ctx.options.timeReport);
+  if (cacheStats && cache != NULL)
+      cache->printStats (stderr);
+   
+  if (ctx.errors > 0) {
+      fprintf(stderr, "compilation failed\n");
+	  return 3;
+  }
+  
+  fclose (in);
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include "pool.h"
+
+ThreadPool::ThreadPool (int nthreads)
+{
+    if (nthreads < 1)
+	    nthreads = 1;
+    _generation = 0;
+	_remaining = 0;
+	_active = 0;
+	_shutdown = false;
+    for (int i = 0; i < nthreads; i++)
+	    _queues.push_back (new Queue);
+    for (int i = 0; i < nthreads; i++)
+	    _threads.push_back (std::thread (&ThreadPool::workerLoop, this, i));
+}
+
+ThreadPool::~ThreadPool ()
+{
+    {
+	    std::lock_guard<std::mutex> guard (_lock);
+	    _shutdown = true;
+	}
+	_wakeup.notify_all ();
+	for (size_t i = 0; i < _threads.size (); i++)
+	    _threads [i].join ();
+	for (size_t i = 0; i < _queues.size (); i++)
+	    delete _queues [i];
+}
+
+int ThreadPool::hardwareThreads ()
+{
+    int n = (int) std::thread::hardware_concurrency ();
+	return n > 0 ? n : 1;
+}
+
+void ThreadPool::run (int count, std::function<void (int item, int worker)> job)
+{
+    if (count <= 0)
+	    return;
+	
+	std::unique_lock<std::mutex> guard (_lock);
+	
+	// a worker that woke up late may still be looking at the (empty) queues of the previous run
+	_done.wait (guard, [this] { return _active == 0; });
+	
+	// deal the items round robin
+	for (int i = 0; i < count; i++) {
+	    Queue *q = _queues [i % _queues.size ()];
+		std::lock_guard<std::mutex> qguard (q->lock);
+	    q->items.push_back (i);
+	}
+	
+	_job = job;
+	_remaining = count;
+	_generation++;
+	_wakeup.notify_all ();
+	
+	// wait until all items are done and no worker still looks at the queues
+	_done.wait (guard, [this] { return _remaining == 0 && _active == 0; });
+	_job = NULL;
+}
+
+// take the next item from our own queue, or steal one from another worker
+bool ThreadPool::takeItem (int worker, int &item)
+{
+    int n = (int) _queues.size ();
+	for (int i = 0; i < n; i++) {
+	    Queue *q = _queues [(worker + i) % n];
+		std::lock_guard<std::mutex> guard (q->lock);
+		if (q->items.empty ())
+		    continue;
+		if (i == 0) {  // our own queue: take from the front
+		    item = q->items.front ();
+			q->items.pop_front ();
+		} else {  // steal from the back
+		    item = q->items.back ();
+			q->items.pop_back ();
+		}
+		return true;
+	}
+	return false;
+}
+
+void ThreadPool::workerLoop (int worker)
+{
+    int seen = 0;  // the last generation this worker worked on
+	
+	for (;;) {
+	    std::function<void (int, int)> job;
+		{
+		    std::unique_lock<std::mutex> guard (_lock);
+			_wakeup.wait (guard, [this, seen] { return _shutdown || _generation != seen; });
+			if (_shutdown)
+			    return;
+			seen = _generation;
+			job = _job;
+			_active++;
+		}
+		
+		int item, finished = 0;
+		while (takeItem (worker, item)) {
+		    job (item, worker);
+			finished++;
+		}
+		
+		{
+		    std::lock_guard<std::mutex> guard (_lock);
+			_remaining -= finished;
+			_active--;
+			if (_active == 0)
+			    _done.notify_all ();
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#ifndef __POOL_H
+#define __POOL_H 1
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*  A pool of worker threads with work stealing.
+    run (count, job) calls job (item, worker) for every item in 0..count-1 and returns when all
+    of them are done.  Items are dealt round robin to the workers' queues.  A worker takes items
+    from the front of its own queue and, when that is empty, steals from the back of the queue of
+    another worker.  'worker' (0..size()-1) tells the job which thread runs it, so a job can use
+    per-worker state (for example one CompilerContext per worker) without locking.
+    The threads stay alive between calls to run().
+*/
+class ThreadPool {
+public:
+    ThreadPool (int nthreads);
+	~ThreadPool ();
+
+	void run (int count, std::function<void (int item, int worker)> job);
+
+	int size () { return (int) _threads.size (); }
+
+	// number of hardware threads (at least 1)
+	static int hardwareThreads ();
+
+private:
+    struct Queue {
+	    std::mutex lock;
+	    std::deque<int> items;
+	};
+
+    void workerLoop (int worker);
+	bool takeItem (int worker, int &item);
+
+    std::vector<std::thread> _threads;
+	std::vector<Queue *> _queues;
+
+	std::mutex _lock;  // protects the members below
+	std::condition_variable _wakeup;  // a new run() started or the pool is shutting down
+	std::condition_variable _done;    // all items of the current run() are done
+	std::function<void (int, int)> _job;
+	int _generation;  // incremented by every run()
+	int _remaining;   // items of the current run() not done yet
+	int _active;      // workers working on the current run()
+	bool _shutdown;
+};
+
+#endif // not defined __POOL_H
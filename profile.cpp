@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "profile.h"
+#include "interp.h"
+
+#define HOT_COUNT 10  // lines and labels in the hot lists
+
+void collectProfile (const Interpreter &interp, Profile &profile)
+{
+    const std::vector<Instr> &code = interp.code;
+	for (size_t i = 0; i < code.size () && i < interp.counts.size (); i++) {
+	    if (code [i].line <= 0 || code [i].opcode == IR_LABEL)  // a label is not executed
+		    continue;
+		long count = interp.counts [i], jumps = interp.jumps [i];
+		LineProfile &p = profile [code [i].line];
+		p.instructions += count;
+		if (count > p.hits)
+		    p.hits = count;
+		ConditionProfile c;
+		switch (code [i].opcode) {
+		    case IR_IF:
+			case IR_IFFALSE:
+			    c.trueCount = code [i].opcode == IR_IF ? jumps : count - jumps;
+				c.falseCount = count - c.trueCount;
+				p.conditions.push_back (c);
+			    p.trueCount += c.trueCount;
+				p.falseCount += c.falseCount;
+				break;
+			case IR_CASE:
+			    if (code [i].src2 != 0)
+				    p.defaultCount += jumps;
+				else
+				    p.cases [code [i].value.ival] += jumps;
+				break;
+			default:
+			    break;
+		}
+	}
+}
+
+bool writeProfile (const char *path, const Profile &profile)
+{
+    FILE *f = fopen (path, "w");
+	if (f == NULL)
+	    return false;
+	fprintf (f, "tac-profile 1\n");
+	for (Profile::const_iterator it = profile.begin (); it != profile.end (); ++it) {
+	    const LineProfile &p = it->second;
+		fprintf (f, "%d %ld %ld %d", it->first, p.hits, p.instructions, (int) p.conditions.size ());
+		for (size_t i = 0; i < p.conditions.size (); i++)
+		    fprintf (f, " %ld %ld", p.conditions [i].trueCount, p.conditions [i].falseCount);
+		fprintf (f, " %d", (int) p.cases.size ());
+		for (std::map<int, long>::const_iterator c = p.cases.begin (); c != p.cases.end (); ++c)
+		    fprintf (f, " %d %ld", c->first, c->second);
+		fprintf (f, " %ld\n", p.defaultCount);
+	}
+	return fclose (f) == 0;
+}
+
+bool readProfile (const char *path, Profile &profile)
+{
+    profile.clear ();
+    FILE *f = fopen (path, "r");
+	if (f == NULL)
+	    return false;
+	int version;
+	bool ok = fscanf (f, "tac-profile %d", &version) == 1 && version == 1;
+	int line, n;
+	while (ok && fscanf (f, "%d", &line) == 1) {
+	    LineProfile &p = profile [line];
+		ok = fscanf (f, "%ld %ld %d", &p.hits, &p.instructions, &n) == 3 && n >= 0;
+		for (int i = 0; ok && i < n; i++) {
+		    ConditionProfile c;
+			ok = fscanf (f, "%ld %ld", &c.trueCount, &c.falseCount) == 2;
+			p.conditions.push_back (c);
+			p.trueCount += c.trueCount;
+			p.falseCount += c.falseCount;
+		}
+		ok = ok && fscanf (f, "%d", &n) == 1 && n >= 0;
+		for (int i = 0; ok && i < n; i++) {
+		    int value;
+			long count;
+			ok = fscanf (f, "%d %ld", &value, &count) == 2;
+			p.cases [value] = count;
+		}
+		ok = ok && fscanf (f, "%ld", &p.defaultCount) == 1;
+	}
+	ok = ok && feof (f);
+	fclose (f);
+	if (!ok)
+	    profile.clear ();
+	return ok;
+}
+
+static
+double percent (long n, long total)
+{
+    return total > 0 ? 100.0 * n / total : 0.0;
+}
+
+// sort by count (the largest first), then by line
+struct HotLine {
+    int line;
+	long count;
+	bool operator< (const HotLine &other) const
+	{
+	    return count != other.count ? count > other.count : line < other.line;
+	}
+};
+
+void printProfile (FILE *f, const char *sourcePath, const Interpreter &interp)
+{
+    Profile profile;
+	collectProfile (interp, profile);
+	long total = 0;
+	for (size_t i = 0; i < interp.counts.size (); i++)
+	    if (interp.code [i].opcode != IR_LABEL)
+		    total += interp.counts [i];
+
+	fprintf (f, "profile of %s: %ld instructions executed\n\n", sourcePath, total);
+	fprintf (f, "%10s %10s | source\n", "hits", "instrs");
+
+	FILE *source = fopen (sourcePath, "r");
+	if (source != NULL) {
+	    char buf [1024];
+		int line = 1;
+		bool newLine = true;  // buf starts a line
+		while (fgets (buf, sizeof buf, source) != NULL) {
+		    size_t len = strlen (buf);
+			bool endOfLine = len > 0 && buf [len - 1] == '\n';
+			if (endOfLine)
+			    buf [--len] = '\0';
+			if (!newLine)  // the rest of a long line
+			    fprintf (f, "%s", buf);
+			else {
+			    Profile::const_iterator it = profile.find (line);
+				if (it != profile.end () && it->second.instructions > 0)
+				    fprintf (f, "%10ld %10ld | %s", it->second.hits, it->second.instructions, buf);
+				else
+				    fprintf (f, "%10s %10s | %s", "", "", buf);
+			}
+			newLine = endOfLine;
+			if (!endOfLine)
+			    continue;
+			fprintf (f, "\n");
+
+			Profile::const_iterator it = profile.find (line);
+			if (it != profile.end ()) {
+			    const LineProfile &p = it->second;
+				if (p.trueCount + p.falseCount > 0)
+				    fprintf (f, "%21s |     conditions: true %ld (%.1f%%), false %ld (%.1f%%)\n", "",
+					         p.trueCount, percent (p.trueCount, p.trueCount + p.falseCount),
+							 p.falseCount, percent (p.falseCount, p.trueCount + p.falseCount));
+				if (!p.cases.empty () || p.defaultCount > 0) {
+				    fprintf (f, "%21s |     cases:", "");
+					for (std::map<int, long>::const_iterator c = p.cases.begin (); c != p.cases.end (); ++c)
+					    fprintf (f, " %d: %ld,", c->first, c->second);
+					fprintf (f, " default: %ld\n", p.defaultCount);
+				}
+			}
+			line++;
+		}
+		if (!newLine)
+		    fprintf (f, "\n");
+		fclose (source);
+	} else
+	    fprintf (f, "(cannot read %s)\n", sourcePath);
+
+	std::vector<HotLine> lines;
+	for (Profile::const_iterator it = profile.begin (); it != profile.end (); ++it)
+	    if (it->second.instructions > 0) {
+		    HotLine h = { it->first, it->second.instructions };
+			lines.push_back (h);
+		}
+	std::sort (lines.begin (), lines.end ());
+	fprintf (f, "\nhot lines:\n");
+	for (size_t i = 0; i < lines.size () && i < HOT_COUNT; i++)
+	    fprintf (f, "  line %-6d %10ld instructions (%5.1f%%), executed %ld times\n", lines [i].line,
+		         lines [i].count, percent (lines [i].count, total), profile [lines [i].line].hits);
+
+	// the code between a label and the next one (a basic block, more or less) is entered as many
+	// times as the label is executed.  The line of a label is the line of the code after it
+	std::vector<HotLine> labels;  // here 'line' is the index of the label in the code
+	const std::vector<Instr> &code = interp.code;
+	for (size_t i = 0; i < code.size () && i < interp.counts.size (); i++)
+	    if (code [i].opcode == IR_LABEL && interp.counts [i] > 0) {
+		    HotLine h = { (int) i, interp.counts [i] };
+			labels.push_back (h);
+		}
+	std::sort (labels.begin (), labels.end ());
+	fprintf (f, "\nhot labels:\n");
+	for (size_t i = 0; i < labels.size () && i < HOT_COUNT; i++) {
+	    size_t j = labels [i].line;
+		while (j < code.size () && (code [j].opcode == IR_LABEL || code [j].line == 0))
+		    j++;
+	    fprintf (f, "  label%-6d %10ld times", code [labels [i].line].label, labels [i].count);
+		if (j < code.size ())
+		    fprintf (f, " (line %d)", code [j].line);
+		fprintf (f, "\n");
+	}
+}
@@ -0,0 +1,68 @@
+#ifndef __PROFILE_H
+#define __PROFILE_H 1
+
+#include <stdio.h>
+#include <map>
+#include <vector>
+
+class Interpreter;
+
+/*  The profile of a run of a program (-run -profile), by source line (see Instr::line).
+    The instructions of a line are the code generated for it: the code of an expression belongs
+	to the line of its statement, the code of a comparison (and its operands) to the line of its
+	operator, the tests of the cases of a switch to the line of the switch.
+
+	-run -profile writes the profile of a program to <source>.prof and -pgo compiles the program
+	using it (profile guided optimization, see gen.cpp):
+	  - a condition that is usually false jumps with ifFalse where it would jump with if
+	  - an if statement whose condition is usually true has its else part first
+	  - the cases of a switch are tested starting with the most frequent ones
+	  - a hot loop (its body ran HOT_LOOP times, UNROLL times or more each time the loop was
+	    entered) gets UNROLL copies of its condition and body (if they are at most UNROLL_SIZE
+		instructions)
+	The condition of an if or a loop is judged by the counts of its own comparisons (combined
+	through its and, or and not), not by all the conditions of its line.
+	Because the profile is kept by line (not by instruction) it still fits the program after
+	edits that do not move the lines of its loops, conditions and switches.
+
+	The profile file is text: a line "tac-profile 1" and then a line for each source line
+	    <line> <hits> <instructions> <n> <true> <false> ... <m> <value> <count> ... <default>
+	with the counts of the n conditions and the m case values of the line.
+*/
+
+#define HOT_LOOP 1000
+#define UNROLL 4
+#define UNROLL_SIZE 40
+
+struct ConditionProfile {
+    long trueCount, falseCount;
+};
+
+struct LineProfile {
+    LineProfile () { hits = instructions = trueCount = falseCount = defaultCount = 0; }
+
+    long hits;          // times the line was executed (the count of its most executed instruction)
+	long instructions;  // instructions of the line executed
+	long trueCount;     // conditions of the line (if and ifFalse instructions) found true
+	long falseCount;    // ... and found false
+	std::vector<ConditionProfile> conditions;  // each condition of the line, in the order of the code
+	std::map<int, long> cases;  // switch: times each case value was chosen
+	long defaultCount;          // ... and the default
+};
+
+typedef std::map<int, LineProfile> Profile;  // by line
+
+// the profile of the last run of interp (run with profiling on)
+void collectProfile (const Interpreter &interp, Profile &profile);
+
+// write a profile file. Returns false if it could not be written
+bool writeProfile (const char *path, const Profile &profile);
+
+// read a profile file. Returns false (and an empty profile) if it cannot be read
+bool readProfile (const char *path, Profile &profile);
+
+/*  print the profile of the last run of interp: the source (read from sourcePath) with the counts
+    of each line and the branches taken, then the hottest lines and labels */
+void printProfile (FILE *f, const char *sourcePath, const Interpreter &interp);
+
+#endif // not defined __PROFILE_H
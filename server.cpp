@@ -0,0 +1,306 @@
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "server.h"
+#include "context.h"
+#include "pool.h"
+#include "trace.h"
+
+// write all of data. returns false if the connection was closed
+static
+bool writeAll (int fd, const char *data, size_t len)
+{
+    while (len > 0) {
+	    ssize_t n = write (fd, data, len);
+		if (n < 0 && errno == EINTR)
+		    continue;
+		if (n <= 0)
+		    return false;
+		data += n;
+		len -= n;
+	}
+	return true;
+}
+
+/*  buffered reading from a socket */
+class Connection {
+public:
+    Connection (int fd) { _fd = fd; _pos = _len = 0; }
+	
+	// read one line (without the '\n'). returns false at end of input
+	bool readLine (std::string &line)
+	{
+	    line.clear ();
+		for (;;) {
+		    if (_pos == _len && !fill ())
+			    return !line.empty ();
+			char c = _buf [_pos++];
+			if (c == '\n')
+			    return true;
+			line += c;
+		}
+	}
+	
+	// read exactly n bytes
+	bool readBytes (std::string &data, size_t n)
+	{
+	    data.clear ();
+		while (data.size () < n) {
+		    if (_pos == _len && !fill ())
+			    return false;
+			size_t chunk = _len - _pos;
+			if (chunk > n - data.size ())
+			    chunk = n - data.size ();
+			data.append (_buf + _pos, chunk);
+			_pos += chunk;
+		}
+		return true;
+	}
+	
+private:
+    bool fill ()
+	{
+	    ssize_t n;
+	    do 
+		    n = read (_fd, _buf, sizeof _buf);
+		while (n < 0 && errno == EINTR);
+		if (n <= 0)
+		    return false;
+		_pos = 0;
+		_len = n;
+		return true;
+	}
+	
+    int _fd;
+	char _buf [64 * 1024];
+	size_t _pos, _len;
+};
+
+// compile one program with ctx and send the response
+static
+bool compileRequest (int fd, CompilerContext &ctx, FILE *in, CompileCache *cache)
+{
+    char *code = NULL, *messages = NULL;
+	size_t codeLen = 0, messagesLen = 0;
+	
+	ctx.out = open_memstream (&code, &codeLen);
+	ctx.err = open_memstream (&messages, &messagesLen);
+	int errors = compileCached (ctx, in, cache);
+	if (errors > 0)
+	    fprintf (ctx.err, "compilation failed\n");
+	fclose (ctx.out);
+	fclose (ctx.err);
+	ctx.out = stdout;
+	ctx.err = stderr;
+	ctx.reset ();  // free the AST now. The arena keeps its first block for the next request
+	
+	char header [100];
+	snprintf (header, sizeof header, "%d %zu %zu\n", errors, codeLen, messagesLen);
+	bool ok = writeAll (fd, header, strlen (header)) && writeAll (fd, code, codeLen) 
+	          && writeAll (fd, messages, messagesLen);
+	free (code);
+	free (messages);
+	return ok;
+}
+
+static
+void sendError (int fd, const std::string &reason)
+{
+    std::string response = "ERROR " + reason + "\n";
+	writeAll (fd, response.data (), response.size ());
+}
+
+// serve all the requests sent on one connection
+static
+void serveConnection (int fd, CompilerContext &ctx, CompileCache *cache)
+{
+    Connection conn (fd);
+	std::string line, source;
+	CompileOptions options;
+	
+	while (conn.readLine (line)) {
+	    if (line.compare (0, 7, "OPTION ") == 0) {
+		    if (!parseCompileOption (options, line.c_str () + 7)) {
+			    sendError (fd, "unknown option " + line.substr (7));
+				return;
+			}
+			// a client must not make the server start more threads than the machine has
+			if (options.genThreads > ThreadPool::hardwareThreads ())
+			    options.genThreads = ThreadPool::hardwareThreads ();
+			continue;
+		}
+		
+		TraceSpan span ("request", line.c_str ());
+		FILE *in;
+	    if (line.compare (0, 5, "FILE ") == 0) {
+		    std::string path = line.substr (5);
+		    in = fopen (path.c_str (), "r");
+			if (in == NULL) {
+			    sendError (fd, "failed to open " + path);
+				return;
+			}
+		} else if (line.compare (0, 5, "TEXT ") == 0) {
+		    char *end;
+		    unsigned long n = strtoul (line.c_str () + 5, &end, 10);
+			if (*end != '\0' || !conn.readBytes (source, n)) {
+			    sendError (fd, "bad TEXT request");
+				return;
+			}
+			in = fmemopen ((void *) source.data (), source.size (), "r");
+			if (in == NULL) {  // fmemopen() fails for an empty buffer 
+			    in = fopen ("/dev/null", "r");
+			}
+		} else {
+		    sendError (fd, "bad request " + line);
+			return;
+		}
+		
+		ctx.options = options;
+		bool ok = compileRequest (fd, ctx, in, cache);
+		fclose (in);
+		options = CompileOptions ();
+		if (!ok)
+		    return;
+	}
+}
+
+int runServer (const char *socketPath, int threads, CompileCache *cache)
+{
+    signal (SIGPIPE, SIG_IGN);  // a client that goes away must not kill the server
+	
+    struct sockaddr_un addr;
+	if (strlen (socketPath) >= sizeof addr.sun_path) {
+	    fprintf (stderr, "socket path too long: %s\n", socketPath);
+		return 2;
+	}
+	memset (&addr, 0, sizeof addr);
+	addr.sun_family = AF_UNIX;
+	strcpy (addr.sun_path, socketPath);
+	
+    int listener = socket (AF_UNIX, SOCK_STREAM, 0);
+	unlink (socketPath);
+	if (listener < 0 || bind (listener, (struct sockaddr *) &addr, sizeof addr) < 0 || listen (listener, 128) < 0) {
+	    fprintf (stderr, "cannot listen on %s: %s\n", socketPath, strerror (errno));
+		return 2;
+	}
+	
+	if (threads <= 0)
+	    threads = ThreadPool::hardwareThreads ();
+		
+	// accepted connections wait here for a worker
+	std::mutex lock;
+	std::condition_variable ready;
+	std::deque<int> pending;
+	bool stopping = false;  // no more connections: the workers end when pending is empty
+	
+	std::vector<std::thread> workers;
+	for (int i = 0; i < threads; i++)
+	    workers.push_back (std::thread ([&] {
+		    CompilerContext ctx;  // used for all the requests this worker serves
+		    for (;;) {
+			    int fd;
+				{
+				    std::unique_lock<std::mutex> guard (lock);
+					ready.wait (guard, [&] { return !pending.empty () || stopping; });
+					if (pending.empty ())
+					    return;
+					fd = pending.front ();
+					pending.pop_front ();
+				}
+				serveConnection (fd, ctx, cache);
+				close (fd);
+				if (traceEnabled) {
+				    bool idle;
+					{
+					    std::lock_guard<std::mutex> guard (lock);
+						idle = pending.empty ();
+					}
+					if (idle)
+					    traceFlush ();  // (its events are not left in the buffer until the next request)
+				}
+			}
+		}));
+	
+	for (;;) {
+	    int fd = accept (listener, NULL, NULL);
+		if (fd < 0) {
+		    if (errno == EINTR || errno == ECONNABORTED)
+			    continue;
+		    fprintf (stderr, "accept failed: %s\n", strerror (errno));
+			break;
+		}
+		std::lock_guard<std::mutex> guard (lock);
+		pending.push_back (fd);
+		ready.notify_one ();
+	}
+	
+	close (listener);
+	{
+	    std::lock_guard<std::mutex> guard (lock);
+		stopping = true;
+		ready.notify_all ();
+	}
+	// (they use lock, ready and pending: they end before this frame does)
+	for (size_t i = 0; i < workers.size (); i++)
+	    workers [i].join ();
+	return 2;
+}
+
+int runClient (const char *socketPath, const char *file)
+{
+    char *path = realpath (file, NULL);  // the server may run in another directory
+	if (path == NULL) {
+       fprintf (stderr, "failed to open %s\n", file);
+	   return 2;
+	}
+	
+    struct sockaddr_un addr;
+	memset (&addr, 0, sizeof addr);
+	addr.sun_family = AF_UNIX;
+	strncpy (addr.sun_path, socketPath, sizeof addr.sun_path - 1);
+	int fd = socket (AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0 || connect (fd, (struct sockaddr *) &addr, sizeof addr) < 0) {
+	    fprintf (stderr, "cannot connect to %s: %s\n", socketPath, strerror (errno));
+		free (path);
+		return 2;
+	}
+	
+	std::string request = std::string ("FILE ") + path + "\n";
+	free (path);
+	if (!writeAll (fd, request.data (), request.size ())) {
+	    fprintf (stderr, "connection to %s lost\n", socketPath);
+		close (fd);
+		return 2;
+	}
+	
+	Connection conn (fd);
+	std::string header, code, messages;
+	int errors;
+	size_t codeLen, messagesLen;
+	if (!conn.readLine (header) || sscanf (header.c_str (), "%d %zu %zu", &errors, &codeLen, &messagesLen) != 3
+	    || !conn.readBytes (code, codeLen) || !conn.readBytes (messages, messagesLen)) {
+		if (header.compare (0, 6, "ERROR ") == 0)
+		    fprintf (stderr, "%s\n", header.c_str () + 6);
+		else
+		    fprintf (stderr, "bad response from %s\n", socketPath);
+		close (fd);
+		return 2;
+	}
+	close (fd);
+	
+	fwrite (code.data (), 1, code.size (), stdout);
+	fwrite (messages.data (), 1, messages.size (), stderr);
+	return errors > 0 ? 3 : 0;
+}
@@ -0,0 +1,35 @@
+#ifndef __SERVER_H
+#define __SERVER_H 1
+
+#include "cache.h"
+
+/*  Server mode: a long running process that compiles programs sent to it over a Unix domain
+    socket, so a build system that compiles many small programs does not pay for starting a
+    new process for each one.  The worker threads and their CompilerContexts (with their
+    warm AST arenas) are created once and reused by all the requests.
+
+    Protocol. A client may send any number of requests on one connection.  A request is
+    zero or more option lines followed by one of:
+	
+        FILE <path>\n              compile the file <path> (a path on the server's machine)
+        TEXT <n>\n<n bytes>        compile the n bytes following the newline
+		
+        OPTION <option>\n          an option for the next FILE or TEXT request (a command line
+                                   option of a compilation, see parseCompileOption ();
+                                   -gen-threads=N is at most the number of hardware threads)
+									
+    The response is one line  "<errors> <code-bytes> <message-bytes>\n"  followed by the
+    generated code and then by the error messages.  A malformed request gets the response
+    "ERROR <reason>\n" and the connection is closed.
+*/
+
+// listen on 'socketPath' and serve requests until the process is killed. 
+// threads is the number of requests served at the same time (0: one per hardware thread)
+// cache (may be NULL) is the compilation cache used by all the requests
+int runServer (const char *socketPath, int threads, CompileCache *cache);
+
+// send 'file' to the server listening on 'socketPath' to be compiled. The code is printed to
+// stdout, the error messages to stderr.  return value: like main() when compiling locally
+int runClient (const char *socketPath, const char *file);
+
+#endif // not defined __SERVER_H
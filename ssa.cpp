@@ -0,0 +1,803 @@
+#include <stdio.h>
+#include <limits.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ssa.h"
+#include "symtab.h"  // internName ()
+
+static
+const char *typeName (myType t)
+{
+    return t == _INT ? "int" : "float";
+}
+
+static
+bool isJump (Opcode opcode)
+{
+    return opcode == IR_GOTO || opcode == IR_IF || opcode == IR_IFFALSE || opcode == IR_CASE || opcode == IR_HALT;
+}
+
+// a jump that goes on with the next block when it is not taken
+static
+bool conditional (const Instr &jump)
+{
+    return jump.opcode == IR_IF || jump.opcode == IR_IFFALSE || (jump.opcode == IR_CASE && jump.src2 == 0);
+}
+
+// an instruction that is not removed even if its value is not used
+static
+bool hasEffect (const Instr &instr)
+{
+    return instr.opcode == IR_READ || instr.opcode == IR_WRITE
+	    || (instr.opcode == IR_BINARY && instr.type == _INT && (instr.op == DIV || instr.op == MODULO));
+}
+
+/*  the locations (temporaries or variables, see SSAForm) used and assigned by an instruction of the
+    code (not in SSA form).  var: the location of its variable */
+static
+void usesAndDef (const Instr &instr, int var, int uses [2], int &nuses, int &def)
+{
+    nuses = 0;
+	def = 0;
+	switch (instr.opcode) {
+	    case IR_CONST:
+		    def = instr.dest;
+			break;
+		case IR_LOAD:
+		    uses [nuses++] = var;
+			def = instr.dest;
+			break;
+		case IR_CAST:
+		case IR_BINARY:
+		    def = instr.dest;  // (and their operands are uses, as below)
+		    // fall through
+		case IR_IF:
+		case IR_IFFALSE:
+		case IR_CASE:
+		case IR_WRITE:
+		    if (instr.src1 != 0) uses [nuses++] = instr.src1;
+			if (instr.src2 != 0) uses [nuses++] = instr.src2;
+			break;
+		case IR_STORE:
+		case IR_CAST_STORE:
+		    uses [nuses++] = instr.src1;
+			def = var;
+			break;
+		case IR_READ:
+		    def = var;
+			break;
+		default:
+		    break;
+	}
+}
+
+// number the blocks in the order of a walk of the dominator tree (pre and post order).
+// a dominates b when pre [a] <= pre [b] and post [b] <= post [a]
+static
+void dominatorOrder (const std::vector<SSABlock> &blocks, std::vector<int> &pre, std::vector<int> &post)
+{
+    std::vector<std::vector<int> > children (blocks.size ());
+	for (size_t b = 1; b < blocks.size (); b++)
+	    if (blocks [b].reachable && blocks [b].idom >= 0)
+		    children [blocks [b].idom].push_back (b);
+	pre.assign (blocks.size (), -1);
+	post.assign (blocks.size (), -1);
+	if (blocks.empty ())
+	    return;
+	int n = 0, m = 0;
+	std::vector<std::pair<int, size_t> > stack;  // (block, next child)
+	pre [0] = n++;
+	stack.push_back (std::make_pair (0, (size_t) 0));
+	while (!stack.empty ()) {
+	    int b = stack.back ().first;
+		if (stack.back ().second < children [b].size ()) {
+		    int c = children [b] [stack.back ().second++];
+			pre [c] = n++;
+			stack.push_back (std::make_pair (c, (size_t) 0));
+		} else {
+		    post [b] = m++;
+			stack.pop_back ();
+		}
+	}
+}
+
+bool SSAForm::build (const std::vector<Instr> &code, const std::map<std::string, myType> &variables,
+                     std::string &error)
+{
+    blocks.clear ();
+	valueTypes.assign (1, _INT);
+	_names.clear ();
+
+	// the locations: the temporaries and then the variables
+	_temps = 0;
+	std::map<std::string, int> varIndex;
+	for (size_t i = 0; i < code.size (); i++) {
+	    const Instr &instr = code [i];
+		_temps = std::max (_temps, std::max (instr.dest, std::max (instr.src1, instr.src2)));
+		if (instr.name != NULL && varIndex.find (instr.name) == varIndex.end ()) {
+		    varIndex [instr.name] = _names.size ();
+			_names.push_back (instr.name);
+		}
+	}
+	int locations = _temps + _names.size () + 1;
+	std::vector<int> varOf (code.size (), 0);  // the location of the variable of each instruction
+	for (size_t i = 0; i < code.size (); i++)
+	    if (code [i].name != NULL)
+		    varOf [i] = _temps + 1 + varIndex [code [i].name];
+	_locationTypes.assign (locations, _INT);
+	for (size_t v = 0; v < _names.size (); v++) {
+	    std::map<std::string, myType>::const_iterator it = variables.find (_names [v]);
+		if (it != variables.end ())
+		    _locationTypes [_temps + 1 + v] = it->second;
+	}
+	for (size_t i = 0; i < code.size (); i++)
+	    if (code [i].opcode == IR_LOAD)
+		    _locationTypes [code [i].dest] = _locationTypes [varOf [i]];
+		else if (code [i].opcode == IR_CONST || code [i].opcode == IR_CAST || code [i].opcode == IR_BINARY)
+		    _locationTypes [code [i].dest] = code [i].type;
+
+	/*  the blocks.  A block starts at a label (after the labels right before it) and after a jump.
+	    The first block is empty: the values of the locations used before they are assigned go
+		there, and it is not the target of a jump (a program may start with the label of a loop) */
+	std::vector<size_t> begin;  // the first instruction of each block
+	std::map<int, int> labelBlock;
+	SSABlock empty;
+	blocks.push_back (empty);
+	begin.push_back (0);
+	bool open = false;        // the last block may get more instructions
+	bool labelsOnly = false;  // ... and it has nothing but labels so far
+	for (size_t i = 0; i < code.size (); i++) {
+	    const Instr &instr = code [i];
+		if (!open || (instr.opcode == IR_LABEL && !labelsOnly)) {
+		    blocks.push_back (empty);
+			begin.push_back (i);
+			open = labelsOnly = true;
+		}
+		if (instr.opcode == IR_LABEL) {
+		    blocks.back ().labels.push_back (instr.label);
+			labelBlock [instr.label] = blocks.size () - 1;
+		} else
+		    labelsOnly = false;
+		if (isJump (instr.opcode)) {
+		    blocks.back ().jump = instr;
+			open = false;
+		}
+	}
+	begin.push_back (code.size ());
+
+	int n = blocks.size ();
+	for (int b = 0; b < n; b++) {
+	    SSABlock &block = blocks [b];
+		block.next = b + 1 < n ? b + 1 : -1;
+		Opcode opcode = block.jump.opcode;
+		if (opcode == IR_GOTO || opcode == IR_IF || opcode == IR_IFFALSE || opcode == IR_CASE) {
+		    std::map<int, int>::const_iterator it = labelBlock.find (block.jump.label);
+			if (it == labelBlock.end ()) {
+			    char buf [100];
+				snprintf (buf, sizeof buf, "a jump to label%d, which is not in the code", block.jump.label);
+				error = buf;
+				return false;
+			}
+			block.target = it->second;
+			block.succs.push_back (block.target);
+		}
+		if ((opcode == IR_LABEL || conditional (block.jump)) && block.next >= 0 && block.next != block.target)
+		    block.succs.push_back (block.next);
+	}
+
+	// the blocks reachable from the first one, in reverse postorder
+	std::vector<int> order;
+	{
+	    std::vector<std::pair<int, size_t> > stack;  // (block, next successor)
+		blocks [0].reachable = true;
+		stack.push_back (std::make_pair (0, (size_t) 0));
+		while (!stack.empty ()) {
+		    int b = stack.back ().first;
+			if (stack.back ().second < blocks [b].succs.size ()) {
+			    int s = blocks [b].succs [stack.back ().second++];
+				if (!blocks [s].reachable) {
+				    blocks [s].reachable = true;
+					stack.push_back (std::make_pair (s, (size_t) 0));
+				}
+			} else {
+			    order.push_back (b);
+				stack.pop_back ();
+			}
+		}
+		std::reverse (order.begin (), order.end ());
+	}
+	for (int b = 0; b < n; b++)
+	    if (blocks [b].reachable)
+		    for (size_t s = 0; s < blocks [b].succs.size (); s++)
+			    blocks [blocks [b].succs [s]].preds.push_back (b);
+
+	/*  the dominators (Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm"): the
+	    immediate dominator of a block is where the dominator tree paths of its predecessors meet */
+	std::vector<int> rpo (n, -1);
+	for (size_t i = 0; i < order.size (); i++)
+	    rpo [order [i]] = i;
+	blocks [0].idom = 0;
+	for (bool changed = true; changed; ) {
+	    changed = false;
+		for (size_t i = 1; i < order.size (); i++) {
+		    SSABlock &block = blocks [order [i]];
+			int idom = -1;
+			for (size_t p = 0; p < block.preds.size (); p++) {
+			    int a = block.preds [p];
+				if (blocks [a].idom < 0)  // not done yet
+				    continue;
+				for (int c = idom; c >= 0 && a != c; ) {
+				    while (rpo [a] > rpo [c])
+					    a = blocks [a].idom;
+					while (rpo [c] > rpo [a])
+					    c = blocks [c].idom;
+				}
+				idom = a;
+			}
+			if (block.idom != idom) {
+			    block.idom = idom;
+				changed = true;
+			}
+		}
+	}
+	blocks [0].idom = -1;
+
+	// the dominance frontier of each block: the joins where its dominance stops
+	std::vector<std::vector<int> > frontier (n);
+	for (int b = 0; b < n; b++)
+	    if (blocks [b].preds.size () >= 2)
+		    for (size_t p = 0; p < blocks [b].preds.size (); p++)
+			    for (int r = blocks [b].preds [p]; r != blocks [b].idom; r = blocks [r].idom)
+				    if (frontier [r].empty () || frontier [r].back () != b)
+					    frontier [r].push_back (b);
+
+	/*  phis (Cytron et al.) for the locations used in some block before they are assigned there
+	    ("semi-pruned" SSA: a temporary used in its block only gets no phi) */
+	std::vector<bool> global (locations, false);
+	std::vector<std::vector<int> > defBlocks (locations);
+	std::vector<int> assignedIn (locations, -1);  // the block it was last assigned in
+	for (int b = 0; b < n; b++) {
+	    if (!blocks [b].reachable)
+		    continue;
+	    for (size_t i = begin [b]; i < begin [b + 1]; i++) {
+		    int uses [2], nuses, def;
+			usesAndDef (code [i], varOf [i], uses, nuses, def);
+			for (int u = 0; u < nuses; u++)
+			    if (assignedIn [uses [u]] != b)
+				    global [uses [u]] = true;
+			if (def != 0 && assignedIn [def] != b) {
+			    assignedIn [def] = b;
+				defBlocks [def].push_back (b);
+			}
+		}
+	}
+	std::vector<int> hasPhi (n, 0), added (n, 0);  // the last location that got a phi in the block / ...
+	for (int l = 1; l < locations; l++) {
+	    if (!global [l])
+		    continue;
+		std::vector<int> work = defBlocks [l];
+		for (size_t w = 0; w < work.size (); w++)
+		    added [work [w]] = l;
+		while (!work.empty ()) {
+		    int b = work.back ();
+			work.pop_back ();
+			for (size_t f = 0; f < frontier [b].size (); f++) {
+			    int d = frontier [b] [f];
+				if (hasPhi [d] == l)
+				    continue;
+				hasPhi [d] = l;
+				Phi phi;
+				phi.dest = 0;
+				phi.location = l;
+				phi.args.assign (blocks [d].preds.size (), 0);
+				blocks [d].phis.push_back (phi);
+				if (added [d] != l) {
+				    added [d] = l;
+					work.push_back (d);
+				}
+			}
+		}
+	}
+
+	/*  rename: walk the dominator tree with the value of each location on a stack.  A location
+	    used before it is assigned is 0 (a constant in the first block) */
+	std::vector<std::vector<int> > stacks (locations);
+	std::vector<int> pushed;  // the locations pushed, in order (popped when their block is done)
+	std::vector<int> initial (locations, 0);
+	auto newValue = [&] (myType type) {
+	    valueTypes.push_back (type);
+		return (int) valueTypes.size () - 1;
+	};
+	auto top = [&] (int l) {
+	    if (!stacks [l].empty ())
+		    return stacks [l].back ();
+		if (initial [l] == 0)
+		    initial [l] = newValue (_locationTypes [l]);
+		return initial [l];
+	};
+	auto push = [&] (int l, int v) {
+	    stacks [l].push_back (v);
+		pushed.push_back (l);
+	};
+	auto rename = [&] (int b) {
+	    SSABlock &block = blocks [b];
+		for (size_t p = 0; p < block.phis.size (); p++) {
+		    block.phis [p].dest = newValue (_locationTypes [block.phis [p].location]);
+			push (block.phis [p].location, block.phis [p].dest);
+		}
+		for (size_t i = begin [b]; i < begin [b + 1]; i++) {
+		    const Instr &instr = code [i];
+			Instr out = instr;
+			switch (instr.opcode) {
+			    case IR_CONST:
+				case IR_CAST:
+				case IR_BINARY:
+				    if (instr.src1 != 0) out.src1 = top (instr.src1);
+					if (instr.src2 != 0) out.src2 = top (instr.src2);
+					out.dest = newValue (instr.type);
+					block.instrs.push_back (out);
+					push (instr.dest, out.dest);
+					break;
+				case IR_LOAD:
+				    push (instr.dest, top (varOf [i]));
+					break;
+				case IR_STORE:
+				    push (varOf [i], top (instr.src1));
+					break;
+				case IR_CAST_STORE:
+				    out.src1 = top (instr.src1);
+				    if (valueTypes [out.src1] == instr.type) {
+					    push (varOf [i], out.src1);
+						break;
+					}
+					out.opcode = IR_CAST;
+					out.dest = newValue (instr.type);
+					out.name = NULL;
+					block.instrs.push_back (out);
+					push (varOf [i], out.dest);
+					break;
+				case IR_READ:
+				    out.dest = newValue (instr.type);
+					block.instrs.push_back (out);
+					push (varOf [i], out.dest);
+					break;
+				case IR_WRITE:
+				    out.src1 = top (instr.src1);
+					block.instrs.push_back (out);
+					break;
+				default:  // labels and the jump
+				    break;
+			}
+		}
+		if (block.jump.src1 != 0) block.jump.src1 = top (block.jump.src1);
+		if (block.jump.src2 != 0) block.jump.src2 = top (block.jump.src2);
+		for (size_t s = 0; s < block.succs.size (); s++) {
+		    SSABlock &succ = blocks [block.succs [s]];
+			size_t k = std::find (succ.preds.begin (), succ.preds.end (), b) - succ.preds.begin ();
+			for (size_t p = 0; p < succ.phis.size (); p++)
+			    succ.phis [p].args [k] = top (succ.phis [p].location);
+		}
+	};
+	std::vector<std::vector<int> > children (n);
+	for (int b = 1; b < n; b++)
+	    if (blocks [b].reachable)
+		    children [blocks [b].idom].push_back (b);
+	struct Frame {
+	    int block;
+		size_t child;   // the next child to rename
+		size_t pushed;  // the size of 'pushed' before the block
+	};
+	std::vector<Frame> stack;
+	rename (0);
+	Frame first = { 0, 0, 0 };
+	stack.push_back (first);
+	while (!stack.empty ()) {
+	    Frame &frame = stack.back ();
+		if (frame.child < children [frame.block].size ()) {
+		    Frame f = { children [frame.block] [frame.child++], 0, pushed.size () };
+			rename (f.block);
+			stack.push_back (f);
+		} else {
+		    for (; pushed.size () > frame.pushed; pushed.pop_back ())
+			    stacks [pushed.back ()].pop_back ();
+			stack.pop_back ();
+		}
+	}
+
+	std::vector<Instr> zeros;
+	for (int l = 1; l < locations; l++)
+	    if (initial [l] != 0) {
+		    Instr zero (IR_CONST, initial [l]);
+			zero.type = _locationTypes [l];
+			if (zero.type == _FLOAT)
+			    zero.value.fval = 0.0;
+			zeros.push_back (zero);
+		}
+	blocks [0].instrs.insert (blocks [0].instrs.begin (), zeros.begin (), zeros.end ());
+	return true;
+}
+
+bool SSAForm::verify (std::string &error) const
+{
+    char buf [200];
+	error.clear ();
+	std::vector<int> pre, post;
+	dominatorOrder (blocks, pre, post);
+	std::vector<int> defBlock (valueTypes.size (), -1);
+	std::vector<int> defPos (valueTypes.size (), -1);  // -1 for a phi, else the index of its instruction
+
+	auto define = [&] (int v, int b, int pos) {
+	    if (v <= 0 || (size_t) v >= valueTypes.size ())
+		    snprintf (buf, sizeof buf, "block%d defines v%d, which is not a value", b, v);
+		else if (defBlock [v] >= 0)
+		    snprintf (buf, sizeof buf, "v%d is defined twice (in block%d and in block%d)", v, defBlock [v], b);
+		else {
+		    defBlock [v] = b;
+			defPos [v] = pos;
+			return true;
+		}
+		error = buf;
+		return false;
+	};
+	for (size_t b = 0; b < blocks.size (); b++) {
+	    if (!blocks [b].reachable)
+		    continue;
+		for (size_t p = 0; p < blocks [b].phis.size (); p++)
+		    if (!define (blocks [b].phis [p].dest, b, -1))
+			    return false;
+		for (size_t i = 0; i < blocks [b].instrs.size (); i++)
+		    if (blocks [b].instrs [i].dest != 0 && !define (blocks [b].instrs [i].dest, b, i))
+			    return false;
+	}
+
+	auto typeOf = [&] (int v) {
+	    return v > 0 && (size_t) v < valueTypes.size () ? valueTypes [v] : _INT;
+	};
+	// v is used in block b at pos (INT_MAX: at its end) where a value of type 'type' is expected
+	auto use = [&] (int v, int b, int pos, myType type) {
+	    if (v <= 0 || (size_t) v >= valueTypes.size () || defBlock [v] < 0)
+		    snprintf (buf, sizeof buf, "block%d uses v%d, which is not defined", b, v);
+		else if (defBlock [v] == b ? defPos [v] >= pos
+		                           : !(pre [defBlock [v]] <= pre [b] && post [b] <= post [defBlock [v]]))
+		    snprintf (buf, sizeof buf, "block%d uses v%d, which is defined in block%d that does not dominate it",
+			          b, v, defBlock [v]);
+		else if (valueTypes [v] != type)
+		    snprintf (buf, sizeof buf, "block%d uses v%d (%s) as a %s", b, v, typeName (valueTypes [v]), typeName (type));
+		else
+		    return true;
+		error = buf;
+		return false;
+	};
+	for (size_t b = 0; b < blocks.size (); b++) {
+	    const SSABlock &block = blocks [b];
+	    if (!block.reachable)
+		    continue;
+		for (size_t p = 0; p < block.phis.size (); p++) {
+		    const Phi &phi = block.phis [p];
+			if (phi.args.size () != block.preds.size ()) {
+			    snprintf (buf, sizeof buf, "the phi of v%d has %d values for %d predecessors", phi.dest,
+				          (int) phi.args.size (), (int) block.preds.size ());
+				error = buf;
+				return false;
+			}
+			if (valueTypes [phi.dest] != _locationTypes [phi.location]) {
+			    snprintf (buf, sizeof buf, "the phi of v%d has the wrong type", phi.dest);
+				error = buf;
+				return false;
+			}
+			for (size_t k = 0; k < phi.args.size (); k++)
+			    if (!use (phi.args [k], block.preds [k], INT_MAX, valueTypes [phi.dest]))
+				    return false;
+		}
+		for (size_t i = 0; i < block.instrs.size (); i++) {
+		    const Instr &instr = block.instrs [i];
+			bool ok = true;
+			switch (instr.opcode) {
+			    case IR_CONST:
+				case IR_READ:
+				    ok = valueTypes [instr.dest] == instr.type;
+					break;
+				case IR_CAST:
+				    ok = valueTypes [instr.dest] == instr.type && use (instr.src1, b, i, instr.type == _INT ? _FLOAT : _INT);
+					break;
+				case IR_BINARY:
+				    ok = valueTypes [instr.dest] == instr.type && use (instr.src1, b, i, instr.type)
+					     && use (instr.src2, b, i, instr.type);
+					break;
+				case IR_WRITE:
+				    ok = use (instr.src1, b, i, instr.type);
+					break;
+				default:
+				    snprintf (buf, sizeof buf, "block%d has an instruction that has no place in SSA form", (int) b);
+					error = buf;
+					return false;
+			}
+			if (!ok) {
+			    if (error.empty ()) {
+				    snprintf (buf, sizeof buf, "v%d has the wrong type", instr.dest);
+					error = buf;
+				}
+				return false;
+			}
+		}
+		const Instr &jump = block.jump;
+		if (jump.opcode == IR_IF || jump.opcode == IR_IFFALSE) {
+		    // (an int may be compared with a float)
+		    if (!use (jump.src1, b, INT_MAX, typeOf (jump.src1)) || !use (jump.src2, b, INT_MAX, typeOf (jump.src2)))
+				return false;
+		} else if (jump.opcode == IR_CASE) {
+		    if (!use (jump.src1, b, INT_MAX, _INT) || (jump.src2 != 0 && !use (jump.src2, b, INT_MAX, _INT)))
+			    return false;
+		}
+	}
+	return true;
+}
+
+int SSAForm::removeDeadCode ()
+{
+    // the values used (by an instruction that stays), found from the uses that must stay
+    std::vector<const Instr *> defInstr (valueTypes.size (), NULL);
+	std::vector<const Phi *> defPhi (valueTypes.size (), NULL);
+	for (size_t b = 0; b < blocks.size (); b++) {
+	    for (size_t p = 0; p < blocks [b].phis.size (); p++)
+		    defPhi [blocks [b].phis [p].dest] = &blocks [b].phis [p];
+		for (size_t i = 0; i < blocks [b].instrs.size (); i++)
+		    defInstr [blocks [b].instrs [i].dest] = &blocks [b].instrs [i];
+	}
+	std::vector<bool> live (valueTypes.size (), false);
+	std::vector<int> work;
+	auto mark = [&] (int v) {
+	    if (v != 0 && !live [v]) {
+		    live [v] = true;
+			work.push_back (v);
+		}
+	};
+	for (size_t b = 0; b < blocks.size (); b++) {
+	    if (!blocks [b].reachable)
+		    continue;
+		for (size_t i = 0; i < blocks [b].instrs.size (); i++)
+		    if (hasEffect (blocks [b].instrs [i])) {
+			    mark (blocks [b].instrs [i].src1);
+				mark (blocks [b].instrs [i].src2);
+			}
+		mark (blocks [b].jump.src1);
+		mark (blocks [b].jump.src2);
+	}
+	while (!work.empty ()) {
+	    int v = work.back ();
+		work.pop_back ();
+		if (defInstr [v] != NULL) {
+		    mark (defInstr [v]->src1);
+			mark (defInstr [v]->src2);
+		} else if (defPhi [v] != NULL)
+		    for (size_t k = 0; k < defPhi [v]->args.size (); k++)
+			    mark (defPhi [v]->args [k]);
+	}
+
+	int removed = 0;
+	for (size_t b = 0; b < blocks.size (); b++) {
+	    SSABlock &block = blocks [b];
+		size_t kept = 0;
+		for (size_t p = 0; p < block.phis.size (); p++)
+		    if (live [block.phis [p].dest])
+			    block.phis [kept++] = block.phis [p];
+		removed += block.phis.size () - kept;
+		block.phis.erase (block.phis.begin () + kept, block.phis.end ());
+		kept = 0;
+		for (size_t i = 0; i < block.instrs.size (); i++)
+		    if (hasEffect (block.instrs [i]) || live [block.instrs [i].dest])
+			    block.instrs [kept++] = block.instrs [i];
+		removed += block.instrs.size () - kept;
+		block.instrs.erase (block.instrs.begin () + kept, block.instrs.end ());
+	}
+	return removed;
+}
+
+static
+void printInstruction (FILE *f, const Instr &instr)
+{
+    switch (instr.opcode) {
+	    case IR_CONST:
+		    if (instr.type == _INT)
+			    fprintf (f, "    v%d:int = %d\n", instr.dest, instr.value.ival);
+			else {
+			    char text [FLOAT_TEXT_SIZE];
+				formatFloat (text, instr.value.fval);
+			    fprintf (f, "    v%d:float = %s\n", instr.dest, text);
+			}
+			break;
+		case IR_CAST:
+		    fprintf (f, "    v%d:%s = static_cast<%s> v%d\n", instr.dest, typeName (instr.type), typeName (instr.type), instr.src1);
+			break;
+		case IR_BINARY:
+		    fprintf (f, "    v%d:%s = v%d %s v%d\n", instr.dest, typeName (instr.type), instr.src1,
+			         opName (instr.op, instr.type), instr.src2);
+			break;
+		case IR_READ:
+		    fprintf (f, "    v%d:%s = %cread %s\n", instr.dest, typeName (instr.type), instr.type == _INT ? 'i' : 'f', instr.name);
+			break;
+		case IR_WRITE:
+		    fprintf (f, "    %cwrite v%d\n", instr.type == _INT ? 'i' : 'f', instr.src1);
+			break;
+		default:
+		    break;
+	}
+}
+
+void SSAForm::print (FILE *f) const
+{
+    for (size_t b = 0; b < blocks.size (); b++) {
+	    const SSABlock &block = blocks [b];
+		if (!block.reachable)
+		    continue;
+		fprintf (f, "block%d:", (int) b);
+		for (size_t l = 0; l < block.labels.size (); l++)
+		    fprintf (f, " label%d", block.labels [l]);
+		if (!block.preds.empty ()) {
+		    fprintf (f, "   (from");
+			for (size_t p = 0; p < block.preds.size (); p++)
+			    fprintf (f, " block%d", block.preds [p]);
+			fprintf (f, ")");
+		}
+		fprintf (f, "\n");
+		for (size_t p = 0; p < block.phis.size (); p++) {
+		    const Phi &phi = block.phis [p];
+			fprintf (f, "    v%d:%s = phi", phi.dest, typeName (valueTypes [phi.dest]));
+			for (size_t k = 0; k < phi.args.size (); k++)
+			    fprintf (f, "%s v%d", k == 0 ? "" : ",", phi.args [k]);
+			if (locationName (phi.location) != NULL)
+			    fprintf (f, "   (%s)", locationName (phi.location));
+			fprintf (f, "\n");
+		}
+		for (size_t i = 0; i < block.instrs.size (); i++)
+		    printInstruction (f, block.instrs [i]);
+		const Instr &jump = block.jump;
+		switch (jump.opcode) {
+		    case IR_GOTO:
+			    fprintf (f, "    goto block%d\n", block.target);
+				break;
+			case IR_IF:
+			case IR_IFFALSE:
+			    fprintf (f, "    %s v%d %s v%d goto block%d\n", jump.opcode == IR_IF ? "if" : "ifFalse", jump.src1,
+				         relopName (jump.op), jump.src2, block.target);
+				break;
+			case IR_CASE:
+			    if (jump.src2 != 0)
+				    fprintf (f, "    case v%d v%d block%d\n", jump.src1, jump.src2, block.target);
+				else
+				    fprintf (f, "    case v%d %d block%d\n", jump.src1, jump.value.ival, block.target);
+				break;
+			case IR_HALT:
+			    fprintf (f, "    halt\n");
+				break;
+			default:
+			    break;
+		}
+	}
+}
+
+void SSAForm::toCode (std::vector<Instr> &code, int &tempCounter, int &labelCounter,
+                      std::map<std::string, myType> &variables) const
+{
+    code.clear ();
+	std::vector<int> temp (valueTypes.size (), 0);  // the temporary of each value
+	tempCounter = 0;
+	for (size_t b = 0; b < blocks.size (); b++) {
+	    if (!blocks [b].reachable)
+		    continue;
+		for (size_t p = 0; p < blocks [b].phis.size (); p++)
+		    temp [blocks [b].phis [p].dest] = ++tempCounter;
+		for (size_t i = 0; i < blocks [b].instrs.size (); i++)
+		    if (blocks [b].instrs [i].dest != 0)
+			    temp [blocks [b].instrs [i].dest] = ++tempCounter;
+	}
+
+	// the variable of the phis of each location
+	std::vector<const char *> slots (_locationTypes.size (), NULL);
+	auto slot = [&] (int l) {
+	    if (slots [l] == NULL) {
+		    slots [l] = locationName (l);
+			if (slots [l] == NULL) {
+			    // no variable of the program has digits in its name
+			    char buf [30];
+				snprintf (buf, sizeof buf, "phi%d", l);
+				slots [l] = internName (buf);
+				variables [slots [l]] = _locationTypes [l];
+			}
+		}
+		return slots [l];
+	};
+	// the stores of the values of the phis of succ coming from pred
+	auto stores = [&] (int pred, int succ) {
+	    const SSABlock &block = blocks [succ];
+		size_t k = std::find (block.preds.begin (), block.preds.end (), pred) - block.preds.begin ();
+		for (size_t p = 0; p < block.phis.size (); p++) {
+		    Instr store (IR_STORE, 0, temp [block.phis [p].args [k]]);
+			store.name = slot (block.phis [p].location);
+			code.push_back (store);
+		}
+	};
+	auto rename = [&] (Instr instr) {
+	    instr.dest = temp [instr.dest];
+		instr.src1 = temp [instr.src1];
+		instr.src2 = temp [instr.src2];
+		return instr;
+	};
+
+	/*  an edge from a block with two successors to a block with phis gets a block of its own for
+	    the stores (else they would be done on the other edge too).  For the jump it goes at the end
+		of the code, for the fall through right after the jump */
+	struct Edge {
+	    int label;  // the label of the block of the edge
+		int pred, succ;
+		int target; // the label jumped to at its end
+	};
+	std::vector<Edge> edges;
+	for (size_t b = 0; b < blocks.size (); b++) {
+	    const SSABlock &block = blocks [b];
+		if (!block.reachable)
+		    continue;
+		for (size_t l = 0; l < block.labels.size (); l++)
+		    code.push_back (Instr (IR_LABEL, 0, 0, 0, block.labels [l]));
+		for (size_t p = 0; p < block.phis.size (); p++) {
+		    Instr load (IR_LOAD, temp [block.phis [p].dest]);
+			load.name = slot (block.phis [p].location);
+			code.push_back (load);
+		}
+		for (size_t i = 0; i < block.instrs.size (); i++) {
+		    const Instr &instr = block.instrs [i];
+			if (instr.opcode == IR_READ) {
+			    // read the variable, then the value is in it
+			    Instr read = instr;
+				read.dest = 0;
+				code.push_back (read);
+				Instr load (IR_LOAD, temp [instr.dest]);
+				load.name = instr.name;
+				load.line = instr.line;
+				code.push_back (load);
+			} else
+			    code.push_back (rename (instr));
+		}
+		if (block.succs.size () < 2) {
+		    if (block.succs.size () == 1)
+			    stores (b, block.succs [0]);
+			if (block.jump.opcode != IR_LABEL)
+			    code.push_back (rename (block.jump));
+			continue;
+		}
+		Instr jump = rename (block.jump);
+		if (!blocks [block.target].phis.empty ()) {
+		    Edge edge = { ++labelCounter, (int) b, block.target, jump.label };
+			edges.push_back (edge);
+			jump.label = edge.label;
+		}
+		code.push_back (jump);
+		if (!blocks [block.next].phis.empty ()) {
+		    // (a block with phis has another predecessor: one that jumps to its label)
+		    stores (b, block.next);
+			code.push_back (Instr (IR_GOTO, 0, 0, 0, blocks [block.next].labels [0]));
+		}
+	}
+
+	if (!edges.empty ()) {
+	    // the halt stays the last instruction (it is printed with no newline)
+		int halt = 0;
+		if (!code.empty () && code.back ().opcode == IR_HALT) {
+		    halt = ++labelCounter;
+			code.back () = Instr (IR_GOTO, 0, 0, 0, halt);
+		}
+		for (size_t e = 0; e < edges.size (); e++) {
+		    code.push_back (Instr (IR_LABEL, 0, 0, 0, edges [e].label));
+			stores (edges [e].pred, edges [e].succ);
+			code.push_back (Instr (IR_GOTO, 0, 0, 0, edges [e].target));
+		}
+		if (halt != 0) {
+		    code.push_back (Instr (IR_LABEL, 0, 0, 0, halt));
+			code.push_back (Instr (IR_HALT));
+		}
+	}
+}
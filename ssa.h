@@ -0,0 +1,92 @@
+#ifndef __SSA_H
+#define __SSA_H 1
+
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ir.h"
+
+/*  The code of a program in SSA form (static single assignment.  -ssa, -print-ssa).
+
+    The code is cut into basic blocks.  A value (v17) is assigned once, by one instruction, and has
+	a type (int or float).  The variables and temporaries of the code are gone:  "a = _t3" just
+	makes the value of _t3 the value of a from there on, "_t4 = a" makes it the value of _t4 (copies
+	take no instruction).  Where the code of two assignments of a variable meets (after the arms of
+	an if, at the label of a loop) a phi at the start of the block picks its value for the block
+	the code came from.  Each use of a value is dominated by its definition (every path from the
+	start of the program to the use goes through the definition).
+
+	The instructions of a block are Instrs with values instead of temporaries (dest, src1, src2):
+	IR_CONST, IR_CAST, IR_BINARY, IR_READ (dest: the value read, name: the variable read) and
+	IR_WRITE.  The jump at the end of the block (IR_GOTO, IR_IF, IR_IFFALSE, IR_CASE, IR_HALT) has
+	values too.  A variable (or temporary) used before it was assigned is 0 (a constant at the start
+	of the program).
+
+	Out of SSA form (toCode ()) each value is a temporary again.  A phi is a variable (the variable
+	it is the value of, or a new one for a temporary):  the predecessors of the block store the
+	value in it and the block starts with a load of it.
+*/
+
+struct Phi {
+    int dest;      // the value it defines
+	int location;  // the variable or temporary it is the value of (see SSAForm::locationName ())
+	std::vector<int> args;  // its value coming from each predecessor of the block (in the order of preds)
+};
+
+struct SSABlock {
+    SSABlock () : jump (IR_LABEL) { target = next = idom = -1; reachable = false; }
+
+    std::vector<int> labels;   // the labels at its start in the code
+	std::vector<Phi> phis;
+	std::vector<Instr> instrs;
+	Instr jump;                // the jump at its end. IR_LABEL: none (it goes on with the next block)
+	int target;                // the block jumped to (-1: none)
+	int next;                  // the block after it in the code (-1: none)
+	std::vector<int> preds, succs;
+	int idom;                  // its immediate dominator (-1: the first block or an unreachable one)
+	bool reachable;            // from the first block.  The code of the other blocks is dropped
+};
+
+class SSAForm {
+public:
+    SSAForm () { _temps = 0; }
+
+	/*  build the SSA form of code (the code of a whole program).  variables: the variables and their
+	    types (a variable not there is an int).  Returns false with a message in error if code is
+		not well formed (a jump to a label that is not there) */
+	bool build (const std::vector<Instr> &code, const std::map<std::string, myType> &variables,
+	            std::string &error);
+
+	/*  check the form: each value is defined once, dominates its uses and has the type its
+	    uses expect, each phi has a value for each predecessor.  Returns false with a message in
+		error if it does not hold */
+	bool verify (std::string &error) const;
+
+	// remove the instructions and phis whose value is not used (but not a read, nor an int / or %
+	// that may divide by zero).  Returns the number removed
+	int removeDeadCode ();
+
+	// print the form (blocks, phis and instructions)
+	void print (FILE *f) const;
+
+	/*  the code out of SSA form (see above) in code.  The temporaries are numbered from 1 and
+	    tempCounter is set to the last one.  New labels are numbered after labelCounter.  The
+		variables used for phis of temporaries are added to variables */
+	void toCode (std::vector<Instr> &code, int &tempCounter, int &labelCounter,
+	             std::map<std::string, myType> &variables) const;
+
+	// the name of a variable, NULL for a temporary
+	const char *locationName (int location) const { return location > _temps ? _names [location - _temps - 1] : NULL; }
+
+	std::vector<SSABlock> blocks;  // in the order of the code. blocks [0] is the first one
+	std::vector<myType> valueTypes;  // the type of each value (valueTypes [0] is not used)
+
+private:
+	int _temps;  // locations 1 .. _temps are the temporaries, the variables come after them
+	std::vector<const char *> _names;  // the variables
+	std::vector<myType> _locationTypes;
+};
+
+#endif // not defined __SSA_H
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "stats.h"
+
+static const char *phaseNames [PHASE_COUNT] = { "other", "lex", "parse", "semantic", "codegen", "optimize", "output" };
+
+static const char *nodeNames [NODE_KINDS] = {
+    "BinaryOp", "NumNode", "IdNode", "SimpleBoolExp", "Or", "And", "Not", "Fand",
+	"ReadStmt", "WriteStmt", "AssignStmt", "IfStmt", "WhileStmt", "ForStmt", "Block", "BreakStmt",
+	"Case", "SwitchStmt"
+};
+
+// a monotonic clock in nanoseconds. (clock_gettime is cheaper than std::chrono in a build
+// without optimization, and a PhaseTimer reads the clock twice for each token)
+static
+long long now ()
+{
+    struct timespec t;
+	clock_gettime (CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+void CompileStats::clear (bool timing)
+{
+    this->timing = timing;
+	for (int i = 0; i < PHASE_COUNT; i++)
+	    seconds [i] = 0;
+	files = tokens = symbolLookups = emits = instructions = temps = labels = bytes = astBytes = sharedNodes = 0;
+	for (int i = 0; i < NODE_KINDS; i++)
+	    nodes [i] = 0;
+	_phase = PHASE_OTHER;
+}
+
+void CompileStats::start ()
+{
+    files = 1;
+    _phase = PHASE_OTHER;
+	if (timing)
+	    _since = now ();
+}
+
+void CompileStats::stop ()
+{
+    enter (PHASE_OTHER);
+}
+
+Phase CompileStats::switchPhase (Phase phase)
+{
+    long long t = now ();
+	seconds [_phase] += (t - _since) * 1e-9;
+	_since = t;
+	Phase previous = _phase;
+	_phase = phase;
+	return previous;
+}
+
+void CompileStats::add (const CompileStats &other)
+{
+	for (int i = 0; i < PHASE_COUNT; i++)
+	    seconds [i] += other.seconds [i];
+	files += other.files;
+	tokens += other.tokens;
+	for (int i = 0; i < NODE_KINDS; i++)
+	    nodes [i] += other.nodes [i];
+	symbolLookups += other.symbolLookups;
+	emits += other.emits;
+	instructions += other.instructions;
+	temps += other.temps;
+	labels += other.labels;
+	bytes += other.bytes;
+	astBytes += other.astBytes;
+	sharedNodes += other.sharedNodes;
+}
+
+void CompileStats::print (FILE *f, int format) const
+{
+    double total = 0;
+	long allNodes = 0;
+	for (int i = 0; i < PHASE_COUNT; i++)
+	    total += seconds [i];
+	for (int i = 0; i < NODE_KINDS; i++)
+	    allNodes += nodes [i];
+	const char *counterNames [] = { "tokens", "symbol lookups", "emits", "instructions", "temps", "labels", "bytes", "ast bytes", "shared nodes" };
+	long counters [] = { tokens, symbolLookups, emits, instructions, temps, labels, bytes, astBytes, sharedNodes };
+	int ncounters = sizeof counters / sizeof counters [0];
+
+	if (format == TIME_REPORT_JSON) {
+	    fprintf (f, "{\"files\": %ld, \"seconds\": {", files);
+		for (int i = 0; i < PHASE_COUNT; i++)
+		    fprintf (f, "\"%s\": %.6f, ", phaseNames [i], seconds [i]);
+		fprintf (f, "\"total\": %.6f}", total);
+		for (int i = 0; i < ncounters; i++) {
+		    fprintf (f, ", \"");
+			for (const char *c = counterNames [i]; *c != '\0'; c++)
+			    fputc (*c == ' ' ? '_' : *c, f);
+			fprintf (f, "\": %ld", counters [i]);
+		}
+		fprintf (f, ", \"nodes\": {");
+		for (int i = 0; i < NODE_KINDS; i++)
+		    fprintf (f, "%s\"%s\": %ld", i > 0 ? ", " : "", nodeNames [i], nodes [i]);
+		fprintf (f, "}}\n");
+		return;
+	}
+
+	fprintf (f, "compilation report (%ld file%s)\n", files, files == 1 ? "" : "s");
+	if (timing) {
+	    fprintf (f, "  phase            seconds      %%\n");
+		for (int i = 1; i <= PHASE_COUNT; i++) {  // "other" last
+		    int p = i % PHASE_COUNT;
+		    fprintf (f, "  %-14s %9.6f  %5.1f\n", phaseNames [p], seconds [p], total > 0 ? 100 * seconds [p] / total : 0.0);
+		}
+		fprintf (f, "  %-14s %9.6f\n", "total", total);
+	}
+	for (int i = 0; i < ncounters; i++)
+	    fprintf (f, "  %-14s %9ld\n", counterNames [i], counters [i]);
+	fprintf (f, "  %-14s %9ld\n", "AST nodes", allNodes);
+	for (int i = 0; i < NODE_KINDS; i++)
+	    if (nodes [i] > 0)
+		    fprintf (f, "    %-14s %9ld\n", nodeNames [i], nodes [i]);
+}
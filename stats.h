@@ -0,0 +1,79 @@
+#ifndef __STATS_H
+#define __STATS_H 1
+
+#include <stdio.h>
+
+/*  Counters and phase timers of a compilation (-time-report).
+    The counters are always kept: each one is an increment done where the counted thing happens.
+	The timers are read only with -time-report:  otherwise a PhaseTimer costs a test of a bool.
+
+	Phases nest (the parser calls the scanner, the scanner echoes text to the output ...):
+	the time is charged to the innermost phase, so the times add up to the time of the compilation.
+*/
+
+enum Phase { PHASE_OTHER, PHASE_LEX, PHASE_PARSE, PHASE_SEMANTIC, PHASE_CODEGEN, PHASE_OPTIMIZE, PHASE_OUTPUT, PHASE_COUNT };
+
+// the kinds of AST nodes (counted by their constructors, see countNode () in ast.h)
+enum NodeKind {
+    NODE_BINARYOP, NODE_NUM, NODE_ID, NODE_SIMPLEBOOLEXP, NODE_OR, NODE_AND, NODE_NOT, NODE_FAND,
+	NODE_READ, NODE_WRITE, NODE_ASSIGN, NODE_IF, NODE_WHILE, NODE_FOR, NODE_BLOCK, NODE_BREAK,
+	NODE_CASE, NODE_SWITCH, NODE_KINDS
+};
+
+// -time-report: a table.  -time-report=json: a JSON object
+enum { TIME_REPORT_NONE, TIME_REPORT_TABLE, TIME_REPORT_JSON };
+
+struct CompileStats {
+    CompileStats () { clear (); }
+
+	// zero everything. timing tells if the phase timers are used
+	void clear (bool timing = false);
+
+	// start or stop timing the compilation (the time outside any PhaseTimer is PHASE_OTHER)
+	void start ();
+	void stop ();
+
+	// make 'phase' the current phase and return the previous one (see PhaseTimer).
+	// Without timing nothing is done (phases are not followed)
+	Phase enter (Phase phase) { return timing ? switchPhase (phase) : phase; }
+
+	// add the counters and times of other (the stats of another compilation or of a part)
+	void add (const CompileStats &other);
+
+	void print (FILE *f, int format) const;
+
+	bool timing;
+	double seconds [PHASE_COUNT];
+
+	long files;        // compilations added up here (1 for one compilation)
+	long tokens;       // returned by the scanner
+	long nodes [NODE_KINDS];
+	long symbolLookups;  // getSymbol () and putSymbol ()
+	long emits;        // calls of emit ()
+	long instructions; // written to the output
+	long temps;        // temporaries and labels of the generated code
+	long labels;
+	long bytes;        // written to the output (code and echoed text)
+	long astBytes;     // memory of the AST (its nodes in the arena and the flat form, see flatast.h,
+	                   // and the tables of hashcons.h).  With -stream: of the biggest statement
+	long sharedNodes;  // expressions that got the node of an identical one (see hashcons.h)
+
+private:
+    Phase switchPhase (Phase phase);
+
+	Phase _phase;  // the current phase
+	long long _since;  // when it was entered (nanoseconds, see now () in stats.cpp)
+};
+
+// charges the time from its construction to its destruction to 'phase' (with timing on)
+class PhaseTimer {
+public:
+    PhaseTimer (CompileStats &stats, Phase phase) : _stats (stats) { _saved = stats.enter (phase); }
+	~PhaseTimer () { _stats.enter (_saved); }
+
+private:
+    CompileStats &_stats;
+	Phase _saved;  // the phase to go back to
+};
+
+#endif // not defined __STATS_H
@@ -1,15 +1,19 @@
 #include <map>
+#include <set>
 #include <string>
 
 #include "symtab.h"
+#include "context.h"
 
-static 
-std::map<std::string, myType> symbolTable; 
+// the symbol table is the one of the compilation running on this thread (see context.h)
 
 // returns the type of the identifier
 // returns UNKOWN when the identifier is not in the symbol table
 myType getSymbol (const char *name)
 {
+   CompilerContext *ctx = CompilerContext::current ();
+   ctx->stats.symbolLookups++;  // (timed by its caller IdNode::IdNode ())
+   std::map<std::string, myType> &symbolTable = ctx->symbolTable;
    std::string theName = name;
    std::map<std::string, myType>::iterator it;
 
@@ -23,6 +27,10 @@ myType getSymbol (const char *name)
 //            otherwise returns 1 
 int putSymbol (const char *name, myType type)
 {
+   CompilerContext *ctx = CompilerContext::current ();
+   PhaseTimer timer (ctx->stats, PHASE_SEMANTIC);
+   ctx->stats.symbolLookups++;
+   std::map<std::string, myType> &symbolTable = ctx->symbolTable;
    std::string theName = name;
    if (symbolTable.count (name))
        return 0;
@@ -30,3 +38,9 @@ int putSymbol (const char *name, myType type)
    return 1;
 }
 
+
+const char *internName (const char *name)
+{
+   std::set<std::string> &names = CompilerContext::current ()->names;
+   return names.insert (name).first->c_str ();
+}
@@ -14,4 +14,8 @@ extern myType getSymbol (const char *name);
 //            otherwise returns 1 
 extern int putSymbol (const char *name, myType type);
 
+// returns a copy of name that lives until the end of the compilation. The AST may be freed
+// before that (see CompilerContext::streamStatement) but the generated code still refers to the name
+extern const char *internName (const char *name);
+
 #endif  // not defined  __SYMTAB_H
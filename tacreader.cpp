@@ -0,0 +1,473 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tacreader.h"
+#include "irfile.h"
+
+// the words of the text, one after the other.  White space and comments are skipped
+class Words {
+public:
+    Words (const char *text, const char *end) { _p = text; _end = end; _line = 1; }
+
+	// the next word (false at the end of the text or in an unterminated comment)
+	bool next (const char *&word, size_t &len)
+	{
+	    skip ();
+		if (_p >= _end)
+		    return false;
+		word = _p;
+		while (_p < _end && !isSpace (*_p) && !(_p [0] == '/' && _p + 1 < _end && _p [1] == '*'))
+		    _p++;
+		len = _p - word;
+		return true;
+	}
+
+	// true if the next word is 'w' (the word is not taken)
+	bool nextIs (const char *w)
+	{
+	    const char *p = _p;
+		int line = _line;
+		const char *word;
+		size_t len;
+		bool is = next (word, len) && len == strlen (w) && memcmp (word, w, len) == 0;
+		_p = p;
+		_line = line;
+		return is;
+	}
+
+	bool atEnd () { skip (); return _p >= _end; }
+
+	int line () { return _line; }
+
+private:
+    static bool isSpace (char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+    void skip ()
+	{
+	    while (_p < _end) {
+		    if (*_p == '\n') {
+			    _line++;
+				_p++;
+			} else if (isSpace (*_p))
+			    _p++;
+			else if (_p [0] == '/' && _p + 1 < _end && _p [1] == '*') {
+			    const char *close = _p + 2;
+				while (close + 1 < _end && !(close [0] == '*' && close [1] == '/'))
+				    close++;
+				if (close + 1 >= _end) {  // no end: the rest of the text is a comment
+				    _p = _end;
+					return;
+				}
+				for (const char *q = _p; q < close; q++)
+				    if (*q == '\n')
+					    _line++;
+				_p = close + 2;
+			} else if (_p [0] == '/' && _p + 1 < _end && _p [1] == '/') {
+			    while (_p < _end && *_p != '\n')
+				    _p++;
+			} else
+			    return;
+		}
+	}
+
+    const char *_p, *_end;
+	int _line;
+};
+
+static
+bool is (const char *word, size_t len, const char *w)
+{
+    return len == strlen (w) && memcmp (word, w, len) == 0;
+}
+
+// "<prefix><number><suffix>" --> number  (-1 if the word does not look like that)
+static
+int numbered (const char *word, size_t len, const char *prefix, const char *suffix)
+{
+    size_t plen = strlen (prefix), slen = strlen (suffix);
+	if (len <= plen + slen || memcmp (word, prefix, plen) != 0 || memcmp (word + len - slen, suffix, slen) != 0)
+	    return -1;
+	int n = 0;
+	for (size_t i = plen; i < len - slen; i++) {
+	    if (word [i] < '0' || word [i] > '9' || n > 100000000)
+		    return -1;
+		n = n * 10 + word [i] - '0';
+	}
+	return n;
+}
+
+static
+bool isName (const char *word, size_t len)
+{
+    if (len == 0 || !((word [0] >= 'a' && word [0] <= 'z') || (word [0] >= 'A' && word [0] <= 'Z')))
+	    return false;
+	for (size_t i = 1; i < len; i++)
+	    if (!((word [i] >= 'a' && word [i] <= 'z') || (word [i] >= 'A' && word [i] <= 'Z')
+			  || (word [i] >= '0' && word [i] <= '9') || word [i] == '_'))
+		    return false;
+	return true;
+}
+
+// an arithmetic operator as printed by opName ().  Returns false if word is not one
+static
+bool arithmeticOp (const char *word, size_t len, enum op &op, myType &type)
+{
+    static const struct { const char *name; enum op op; } ops [] = {
+	    { "+", PLUS }, { "-", MINUS }, { "*", MUL }, { "/", DIV }, { "power", POW }, { "%", MODULO } };
+	type = _INT;
+	if (len > 1 && word [0] == '@') {
+	    type = _FLOAT;
+		word++;
+		len--;
+	}
+	for (size_t i = 0; i < sizeof ops / sizeof ops [0]; i++)
+	    if (is (word, len, ops [i].name) && !(type == _FLOAT && ops [i].op == MODULO)) {
+		    op = ops [i].op;
+			return true;
+		}
+	return false;
+}
+
+static
+bool relop (const char *word, size_t len, enum op &op)
+{
+    static const enum op relops [] = { LT, GT, LE, GE, EQ, NE };
+	for (size_t i = 0; i < sizeof relops / sizeof relops [0]; i++)
+	    if (is (word, len, relopName (relops [i]))) {
+		    op = relops [i];
+			return true;
+		}
+	return false;
+}
+
+// "17" or "2.5" (or "1.0e+20", see formatFloat ()).  Sets type to the type of the constant
+static
+bool constant (const char *word, size_t len, Instr &instr)
+{
+    char buf [64];
+	if (len == 0 || len >= sizeof buf)
+	    return false;
+	memcpy (buf, word, len);
+	buf [len] = '\0';
+	char *end;
+	if (memchr (buf, '.', len) != NULL) {
+	    instr.type = _FLOAT;
+		instr.value.fval = strtod (buf, &end);
+	} else {
+	    instr.type = _INT;
+		instr.value.ival = (int) strtol (buf, &end, 10);
+	}
+	return end == buf + len;
+}
+
+// "static_cast<int>" or "static_cast<float>"
+static
+bool cast (const char *word, size_t len, myType &type)
+{
+    if (is (word, len, "static_cast<int>"))
+	    type = _INT;
+	else if (is (word, len, "static_cast<float>"))
+	    type = _FLOAT;
+	else
+	    return false;
+	return true;
+}
+
+// the reader: one instruction at a time
+class TACParser {
+public:
+    TACParser (const char *text, size_t len, TACProgram &program)
+	    : _words (text, text + len), _program (program) {}
+
+	bool parse (std::string &error);
+
+private:
+    bool instruction ();
+	bool word ();             // read the next word into _w, _len
+	bool temp (int &t);       // _tN
+	bool label (int &l);      // labelN
+	const char *name ();      // a variable (copied to the arena of the program)
+
+	void noteTemp (int t, myType type);
+	myType tempType (int t);
+	void noteVariable (const char *name, myType type);
+
+	Words _words;
+	TACProgram &_program;
+	const char *_w;
+	size_t _len;
+	std::vector<myType> _tempTypes;  // the type of each temporary seen so far
+	std::map<std::string, const char *> _names;  // a copy of each variable name
+};
+
+bool TACParser::word ()
+{
+    return _words.next (_w, _len);
+}
+
+bool TACParser::temp (int &t)
+{
+    if (!word ())
+	    return false;
+	t = numbered (_w, _len, "_t", "");
+	if (t > _program.tempCount)
+	    _program.tempCount = t;
+	return t > 0;
+}
+
+bool TACParser::label (int &l)
+{
+    if (!word ())
+	    return false;
+	l = numbered (_w, _len, "label", "");
+	if (l > _program.labelCount)
+	    _program.labelCount = l;
+	return l > 0;
+}
+
+const char *TACParser::name ()
+{
+    std::string s (_w, _len);
+	std::map<std::string, const char *>::iterator it = _names.find (s);
+	if (it != _names.end ())
+	    return it->second;
+	char *copy = (char *) _program.names.allocate (_len + 1);
+	memcpy (copy, _w, _len);
+	copy [_len] = '\0';
+	_names [s] = copy;
+	return copy;
+}
+
+void TACParser::noteTemp (int t, myType type)
+{
+    if ((size_t) t >= _tempTypes.size ())
+	    _tempTypes.resize (t + 1, UNKNOWN);
+	_tempTypes [t] = type;
+}
+
+myType TACParser::tempType (int t)
+{
+    return (size_t) t < _tempTypes.size () ? _tempTypes [t] : UNKNOWN;
+}
+
+// the type of a variable is the first type known for it
+void TACParser::noteVariable (const char *name, myType type)
+{
+    std::map<std::string, myType>::iterator it = _program.variables.find (name);
+	if (it == _program.variables.end ())
+	    _program.variables [name] = type;
+	else if (it->second == UNKNOWN)
+	    it->second = type;
+}
+
+bool TACParser::instruction ()
+{
+    if (!word ())
+	    return false;
+
+	int l = numbered (_w, _len, "label", ":");
+	if (l > 0) {
+	    if (l > _program.labelCount)
+		    _program.labelCount = l;
+	    _program.code.push_back (Instr (IR_LABEL, 0, 0, 0, l));
+		return true;
+	}
+
+	// the names of the instructions may also be names of variables:  "goto = _t1" is an assignment
+	if (!_words.nextIs ("=")) {
+	    if (is (_w, _len, "goto")) {
+		    Instr instr (IR_GOTO);
+			if (!label (instr.label))
+			    return false;
+			_program.code.push_back (instr);
+			return true;
+		}
+		if (is (_w, _len, "if") || is (_w, _len, "ifFalse")) {
+		    Instr instr (is (_w, _len, "if") ? IR_IF : IR_IFFALSE);
+			if (!temp (instr.src1) || !word () || !relop (_w, _len, instr.op) || !temp (instr.src2)
+			    || !word () || !is (_w, _len, "goto") || !label (instr.label))
+				return false;
+			_program.code.push_back (instr);
+			return true;
+		}
+		if (is (_w, _len, "case")) {
+		    Instr instr (IR_CASE);
+			if (!temp (instr.src1) || !word ())
+			    return false;
+			int t = numbered (_w, _len, "_t", "");
+			if (t > 0)
+			    instr.src2 = t;
+			else if (!constant (_w, _len, instr) || instr.type != _INT)
+			    return false;
+			instr.type = _INT;
+			if (!label (instr.label))
+			    return false;
+			_program.code.push_back (instr);
+			return true;
+		}
+		if (is (_w, _len, "iread") || is (_w, _len, "fread")) {
+		    Instr instr (IR_READ);
+			instr.type = _w [0] == 'i' ? _INT : _FLOAT;
+			if (!word () || !isName (_w, _len))
+			    return false;
+			instr.name = name ();
+			noteVariable (instr.name, instr.type);
+			_program.code.push_back (instr);
+			return true;
+		}
+		if (is (_w, _len, "iwrite") || is (_w, _len, "fwrite")) {
+		    Instr instr (IR_WRITE);
+			instr.type = _w [0] == 'i' ? _INT : _FLOAT;
+			if (!temp (instr.src1))
+			    return false;
+			_program.code.push_back (instr);
+			return true;
+		}
+		if (is (_w, _len, "halt")) {
+		    _program.code.push_back (Instr (IR_HALT));
+			return true;
+		}
+		return false;
+	}
+
+	// an assignment
+	int dest = numbered (_w, _len, "_t", "");
+	const char *var = NULL;
+	if (dest > 0) {
+	    if (dest > _program.tempCount)
+		    _program.tempCount = dest;
+	} else if (isName (_w, _len))
+	    var = name ();
+	else
+	    return false;
+	word ();  // the "="
+	if (!word ())
+	    return false;
+
+	myType type;
+	if (var != NULL) {  // a = _t1   or  a = static_cast<int> _t1
+	    Instr instr (IR_STORE);
+		instr.name = var;
+		if (cast (_w, _len, type)) {
+		    instr.opcode = IR_CAST_STORE;
+			instr.type = type;
+			if (!temp (instr.src1))
+			    return false;
+		} else {
+		    int t = numbered (_w, _len, "_t", "");
+			if (t <= 0)
+			    return false;
+			if (t > _program.tempCount)
+			    _program.tempCount = t;
+			instr.src1 = t;
+			type = tempType (t);
+		}
+		noteVariable (var, type);
+		_program.code.push_back (instr);
+		return true;
+	}
+
+	if (cast (_w, _len, type)) {  // _t2 = static_cast<float> _t1
+	    Instr instr (IR_CAST, dest);
+		instr.type = type;
+		if (!temp (instr.src1))
+		    return false;
+		noteTemp (dest, type);
+		_program.code.push_back (instr);
+		return true;
+	}
+
+	int t = numbered (_w, _len, "_t", "");
+	if (t > 0) {  // _t3 = _t1 + _t2
+	    if (t > _program.tempCount)
+		    _program.tempCount = t;
+	    Instr instr (IR_BINARY, dest, t);
+		if (!word ())
+		    return false;
+		if (relop (_w, _len, instr.op)) {  // _t5 = _t1 < _t2 ? _t3 : _t4
+		    instr.opcode = IR_SELECT;
+			if (!temp (instr.src2) || !word () || !is (_w, _len, "?") || !temp (instr.src3)
+			    || !word () || !is (_w, _len, ":") || !temp (instr.src4))
+				return false;
+			instr.type = tempType (instr.src3);
+		} else if (!arithmeticOp (_w, _len, instr.op, instr.type) || !temp (instr.src2))
+		    return false;
+		noteTemp (dest, instr.type);
+		_program.code.push_back (instr);
+		return true;
+	}
+
+	if (isName (_w, _len)) {  // _t1 = a
+	    Instr instr (IR_LOAD, dest);
+		instr.name = name ();
+		std::map<std::string, myType>::iterator it = _program.variables.find (instr.name);
+		if (it == _program.variables.end ())
+		    _program.variables [instr.name] = UNKNOWN;
+		noteTemp (dest, it == _program.variables.end () ? UNKNOWN : it->second);
+		_program.code.push_back (instr);
+		return true;
+	}
+
+	Instr instr (IR_CONST, dest);  // _t1 = 17
+	if (!constant (_w, _len, instr))
+	    return false;
+	noteTemp (dest, instr.type);
+	_program.code.push_back (instr);
+	return true;
+}
+
+bool TACParser::parse (std::string &error)
+{
+    while (!_words.atEnd ()) {
+	    int line = _words.line ();
+	    if (!instruction ()) {
+		    char msg [100];
+			snprintf (msg, sizeof msg, "line %d: not valid three address code", line);
+			error = msg;
+			return false;
+		}
+	}
+	return true;
+}
+
+bool readTAC (const char *text, size_t len, TACProgram &program, std::string &error)
+{
+    TACParser parser (text, len, program);
+	return parser.parse (error);
+}
+
+bool readTACFile (const char *path, TACProgram &program, std::string &error)
+{
+    FILE *f = fopen (path, "rb");
+	if (f == NULL) {
+	    error = std::string ("cannot open ") + path;
+		return false;
+	}
+	std::string text;
+	char buf [64 * 1024];
+	size_t n;
+	while ((n = fread (buf, 1, sizeof buf, f)) > 0)
+	    text.append (buf, n);
+	fclose (f);
+	if (!readTAC (text.c_str (), text.size (), program, error)) {
+	    error = std::string (path) + ": " + error;
+		return false;
+	}
+	return true;
+}
+
+int convertTAC (const char *path, bool binary)
+{
+    TACProgram program;
+	std::string error;
+	if (!readTACFile (path, program, error)) {
+	    fprintf (stderr, "%s\n", error.c_str ());
+		return 3;
+	}
+	if (binary)
+	    writeBinaryIR (stdout, program.code, program.variables, program.tempCount, program.labelCount);
+	else
+	    printCode (stdout, program.code);
+	return 0;
+}
@@ -0,0 +1,43 @@
+#ifndef __TACREADER_H
+#define __TACREADER_H 1
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ir.h"
+#include "arena.h"
+
+/*  A reader of three address code written as text (the output of the compiler, like the
+    name_out.txt files in examples).  It builds the same instructions the code generator builds,
+	so printing them gives back the text (up to white space and comments).
+
+	Instructions are separated by white space, not necessarily by newlines (old versions of the
+	compiler printed  "a = static_cast<int> _t2"  with no newline after it).
+	C style comments  (/ * ... * /) may appear anywhere between the words of an instruction.
+*/
+struct TACProgram {
+    TACProgram () { tempCount = labelCount = 0; }
+
+    std::vector<Instr> code;
+
+	// the variables used by the code. Their types are guessed from the code (the value stored
+	// in them, the read instruction used ...). UNKNOWN if there is no way to know
+	std::map<std::string, myType> variables;
+
+	int tempCount;   // the largest temporary used
+	int labelCount;  // the largest label used
+
+	Arena names;     // the names of the variables in 'code' point here
+};
+
+/*  read the code in text[0] ... text[len-1] (text[len] must be '\0') and add it to program.
+    Returns false (and a message like "line 7: ..." in error) if the text is not valid code */
+bool readTAC (const char *text, size_t len, TACProgram &program, std::string &error);
+
+bool readTACFile (const char *path, TACProgram &program, std::string &error);
+
+// read a text file of code and print it again to the standard output: as text or as a binary IR file
+int convertTAC (const char *path, bool binary);
+
+#endif // not defined __TACREADER_H
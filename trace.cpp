@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <time.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include "trace.h"
+
+std::atomic<bool> traceEnabled (false);
+
+static FILE *traceFile = NULL;
+static std::mutex traceLock;  // one event is written at a time
+static double traceStart;
+static double lastFlush;  // (traceNow ())
+
+// the file is flushed this often (in microseconds) and when it is closed, not after each event:
+// a write for each event would make the threads wait for each other on traceLock
+#define TRACE_FLUSH_INTERVAL 1e6
+
+// threads are numbered in the order they end their first event (the thread of traceOpen () is 0)
+static std::atomic<int> threadCount (0);
+static thread_local int threadId = -1;
+
+static
+double now ()
+{
+    struct timespec t;
+	clock_gettime (CLOCK_MONOTONIC, &t);
+	return t.tv_sec * 1e6 + t.tv_nsec * 1e-3;
+}
+
+bool traceOpen (const char *path)
+{
+    traceFile = fopen (path, "w");
+	if (traceFile == NULL) {
+	    fprintf (stderr, "cannot create %s\n", path);
+		return false;
+	}
+	setvbuf (traceFile, NULL, _IOFBF, 1 << 20);
+	traceStart = now ();
+	lastFlush = 0;
+	threadId = threadCount++;
+	fprintf (traceFile, "[\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"main\"}},\n");
+	traceEnabled = true;
+	return true;
+}
+
+void traceClose ()
+{
+    if (traceFile == NULL)
+	    return;
+	std::lock_guard<std::mutex> guard (traceLock);
+	traceEnabled = false;
+	// an event with no comma after it ends the array
+	fprintf (traceFile, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"compiler\"}}\n]\n");
+	fclose (traceFile);
+	traceFile = NULL;
+}
+
+void traceFlush ()
+{
+    std::lock_guard<std::mutex> guard (traceLock);
+	if (traceFile == NULL)
+	    return;
+	fflush (traceFile);
+	lastFlush = traceNow ();
+}
+
+double traceNow ()
+{
+    return now () - traceStart;
+}
+
+// s as a JSON string
+static
+std::string quote (const char *s)
+{
+    std::string q = "\"";
+	for (; *s != '\0'; s++) {
+	    if (*s == '"' || *s == '\\') {
+		    q += '\\';
+			q += *s;
+		} else if ((unsigned char) *s < ' ') {
+		    char buf [8];
+			snprintf (buf, sizeof buf, "\\u%04x", *s);
+			q += buf;
+		} else
+		    q += *s;
+	}
+	return q + "\"";
+}
+
+void TraceSpan::end ()
+{
+    double end = traceNow ();
+	bool first = threadId < 0;
+	if (first)
+	    threadId = threadCount++;
+
+	std::string args;
+	if (_detail != NULL)
+	    args = "\"detail\": " + quote (_detail);
+	for (int i = 0; i < _nargs; i++) {
+	    char buf [100];
+		snprintf (buf, sizeof buf, "%s%s: %ld", args.empty () ? "" : ", ", quote (_keys [i]).c_str (), _values [i]);
+		args += buf;
+	}
+
+	std::lock_guard<std::mutex> guard (traceLock);
+	if (traceFile == NULL)
+	    return;
+	if (first)
+	    fprintf (traceFile, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"thread %d\"}},\n",
+		         threadId, threadId);
+	fprintf (traceFile, "{\"name\": %s, \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %d, \"args\": {%s}},\n",
+	         quote (_name).c_str (), _start, end - _start, threadId, args.c_str ());
+	if (end - lastFlush >= TRACE_FLUSH_INTERVAL) {
+	    fflush (traceFile);  // a server is usually stopped by a signal
+		lastFlush = end;
+	}
+}
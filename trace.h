@@ -0,0 +1,72 @@
+#ifndef __TRACE_H
+#define __TRACE_H 1
+
+#include <atomic>
+
+/*  Trace events in the Chrome trace format (-trace <file>).  Load the file in chrome://tracing
+    or in Perfetto (ui.perfetto.dev) to see what each thread did and when: the files a batch
+	compiled on each worker, the phases of each compilation (cache lookup, parse, codegen, output ...)
+	and the parts generated on the code generation threads.
+
+	A TraceSpan is one event: it starts when it is constructed and ends when it is destroyed.
+	Spans on one thread nest like the scopes that hold them.  Events are written to the file as
+	they end (one line each, under a lock) and the file is flushed once a second and when the server
+	has nothing to do, so the file of a server that is killed can still be loaded: the format
+	allows the final "]" to be missing.
+
+	When tracing is off a TraceSpan only tests traceEnabled.
+*/
+
+extern std::atomic<bool> traceEnabled;  // set by traceOpen (), cleared by traceClose ()
+
+// start writing events to 'path'. Call it before any thread is started
+bool traceOpen (const char *path);
+
+// end the file
+void traceClose ();
+
+// write the events kept in the buffer of the file (a server calls it when it has nothing to do)
+void traceFlush ();
+
+// microseconds since traceOpen ()
+double traceNow ();
+
+class TraceSpan {
+public:
+    // name is the name of the event. detail (may be NULL) is shown with it (a file name ...)
+    TraceSpan (const char *name, const char *detail = 0)
+	{
+	    _nargs = 0;
+		if (traceEnabled) {
+		    _name = name;
+			_detail = detail;
+			_start = traceNow ();
+		}
+	}
+	~TraceSpan () { if (traceEnabled) end (); }
+
+	// add a number to the event (at most MAX_ARGS of them)
+	void arg (const char *key, long value)
+	{
+	    if (traceEnabled && _nargs < MAX_ARGS) {
+		    _keys [_nargs] = key;
+			_values [_nargs++] = value;
+		}
+	}
+
+private:
+    TraceSpan (const TraceSpan &);  // not copyable
+	TraceSpan &operator= (const TraceSpan &);
+
+    void end ();
+
+	enum { MAX_ARGS = 4 };
+	const char *_name;
+	const char *_detail;
+	double _start;
+	int _nargs;
+	const char *_keys [MAX_ARGS];
+	long _values [MAX_ARGS];
+};
+
+#endif // not defined __TRACE_H